@@ -1,9 +1,45 @@
-f, o = open('FAC.csv', 'r'), open('output.txt', 'w')
+# Generates ../src/dfa.cpp from FAC.csv.
+# Characters whose columns are equal in every state are merged into one equivalence class, the
+# tokenizer then looks up CharClass first and indexes the much narrower Transitions table with it.
+# States are stored shifted by one: row 0 is the error state -1, which never leaves itself,
+# and a stored 0 means there is no transition.
+import os
+
+# bytes outside of ASCII behave like '$': allowed inside literals and comments, an error elsewhere
+NON_ASCII_LIKE = ord('$')
+
+here = os.path.dirname(os.path.abspath(__file__))
+f = open(os.path.join(here, 'FAC.csv'), 'r')
 f.readline()
-print("{", file=o)
+table = []
 for l in f:
 	vs = l.strip().split(',')
 	vs.pop(0)
-	print("\t{%s}," % ", ".join(vs), file=o)
-print("}", file=o)
-o.close()
\ No newline at end of file
+	table.append([int(v) for v in vs])
+f.close()
+
+classes, charClass = [], []
+for c in range(128):
+	column = tuple(row[c] for row in table)
+	if column not in classes:
+		classes.append(column)
+	charClass.append(classes.index(column))
+charClass += [charClass[NON_ASCII_LIKE]] * 128
+assert len(table) < 255 and len(classes) < 256
+
+o = open(os.path.join(here, '..', 'src', 'dfa.cpp'), 'w')
+print("// Generated by FiniteAutomata/gen.py from FiniteAutomata/FAC.csv, do not edit.\n", file=o)
+print('#include "dfa.h"\n', file=o)
+print('static_assert(FAStateCount == %d && FACharClassCount == %d, "dfa.h is out of date, update the counts");\n'
+	% (len(table), len(classes)), file=o)
+print("extern constexpr uint8_t CharClass[256] =\n{", file=o)
+for i in range(0, 256, 32):
+	print("\t%s," % ", ".join(str(c) for c in charClass[i:i + 32]), file=o)
+print("};\n", file=o)
+print("extern constexpr uint8_t Transitions[FAStateCount + 1][FACharClassCount] =\n{", file=o)
+print("\t{%s}," % ", ".join("0" for column in classes), file=o)
+for s in range(len(table)):
+	print("\t{%s}," % ", ".join(str(column[s] + 1) for column in classes), file=o)
+print("};", file=o)
+o.close()
+print("%d states, %d character classes" % (len(table), len(classes)))
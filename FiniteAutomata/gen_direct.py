@@ -0,0 +1,70 @@
+# Generates ../src/dfa_direct.cpp from FAC.csv, the direct-coded counterpart of gen.py.
+# Every state becomes a labeled block that switches on the next character and jumps straight
+# to the block of the target state, so scanning a token touches no tables at all.
+# tokenDescriptions.regex only describes identifiers, the complete automaton lives in FAC.csv.
+# The scanner stops in front of any character that would lead to the error state, back to the
+# initial state or into one of the comment states, the tokenizer handles those itself.
+import os
+
+# bytes outside of ASCII behave like '$', see gen.py
+NON_ASCII_LIKE = ord('$')
+STOP_STATES = {0, 56, 57}
+
+here = os.path.dirname(os.path.abspath(__file__))
+f = open(os.path.join(here, 'FAC.csv'), 'r')
+f.readline()
+table = []
+for l in f:
+	vs = l.strip().split(',')
+	vs.pop(0)
+	table.append([int(v) for v in vs])
+f.close()
+
+def stops(state):
+	return state < 0 or state in STOP_STATES
+
+reachable, stack = [0], [0]
+while stack:
+	for target in table[stack.pop()]:
+		if not stops(target) and target not in reachable:
+			reachable.append(target)
+			stack.append(target)
+reachable.sort()
+
+def literal(c):
+	if c == ord("'") or c == ord('\\'):
+		return "'\\%c'" % c
+	if 32 <= c < 127:
+		return "'%c'" % c
+	return str(c)
+
+o = open(os.path.join(here, '..', 'src', 'dfa_direct.cpp'), 'w')
+print("// Generated by FiniteAutomata/gen_direct.py from FiniteAutomata/FAC.csv, do not edit.\n", file=o)
+print('#include "dfa.h"\n', file=o)
+print("int RunFiniteAutomataDirect(int state, const char *&p, const char *end)\n{", file=o)
+print("\tswitch (state)\n\t{", file=o)
+for s in reachable:
+	print("\t\tcase %d: goto s%d;" % (s, s), file=o)
+print("\t\tdefault: return state;\n\t}", file=o)
+for s in reachable:
+	targets = {}
+	for c in range(128):
+		if not stops(table[s][c]):
+			targets.setdefault(table[s][c], []).append(c)
+	print("s%d:" % s, file=o)
+	print("\tif (p == end) return %d;" % s, file=o)
+	if not targets:
+		print("\treturn %d;" % s, file=o)
+		continue
+	print("\tswitch ((uint8_t)*p)\n\t{", file=o)
+	for target, chars in sorted(targets.items()):
+		for i in range(0, len(chars), 8):
+			print("\t\t%s" % " ".join("case %s:" % literal(c) for c in chars[i:i + 8]), file=o)
+		print("\t\t\tp++; goto s%d;" % target, file=o)
+	if not stops(table[s][NON_ASCII_LIKE]):
+		print("\t\tdefault:\n\t\t\tif ((uint8_t)*p < 0x80) break;\n\t\t\tp++; goto s%d;" % table[s][NON_ASCII_LIKE], file=o)
+	print("\t}", file=o)
+	print("\treturn %d;" % s, file=o)
+print("}", file=o)
+o.close()
+print("%d states" % len(reachable))
@@ -0,0 +1,134 @@
+// Tree walk throughput of the pointer AST against its flat layout. Every walk counts the nodes of each kind
+// and sums the integer constants, over the pointer tree through Node::Describe and over the FlatTree
+// both in preorder and as a linear scan. Usage: flat_tree_bench file [runs]
+
+#include "parser.h"
+#include "flat_tree.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct WalkResult
+{
+    uint64_t counts[NodeKindCount];
+    int64_t constants;
+};
+
+static bool operator==(const WalkResult &a, const WalkResult &b)
+{
+    return !memcmp(a.counts, b.counts, sizeof(a.counts)) && a.constants == b.constants;
+}
+
+class PointerWalk: public NodeDescription
+{
+public:
+    WalkResult Run(Node *root)
+    {
+        result = WalkResult();
+        stack.assign(1, root);
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node)
+                node->Describe(this);
+            else
+                result.counts[(size_t)NodeKind::EMPTY]++;
+        }
+        return result;
+    }
+
+    void Kind(NodeKind kind) override
+    {
+        result.counts[(size_t)kind]++;
+    }
+
+    void Child(Node *child) override
+    {
+        stack.push_back(child);
+    }
+
+    void Int(int32_t value) override
+    {
+        result.constants += value;
+    }
+private:
+    WalkResult result;
+    std::vector<Node *> stack;
+};
+
+static WalkResult preorderWalk(const FlatTree &tree)
+{
+    WalkResult result{};
+    std::vector<uint32_t> stack(1, FlatTree::Root);
+    while (!stack.empty())
+    {
+        auto i = stack.back();
+        stack.pop_back();
+        auto &node = tree[i];
+        result.counts[(size_t)node.kind]++;
+        if (node.kind == NodeKind::INT_CONST)
+            result.constants += tree.IntValue(i);
+        for (uint32_t c = node.count; c-- > 0;)
+            stack.push_back(node.first + c);
+    }
+    return result;
+}
+
+static WalkResult linearScan(const FlatTree &tree)
+{
+    WalkResult result{};
+    for (auto &node: tree.Nodes())
+        result.counts[(size_t)node.kind]++;
+    for (auto value: tree.Ints())
+        result.constants += value;
+    return result;
+}
+
+template<typename F>
+static double measure(int runs, WalkResult &result, F walk)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++)
+        result = walk();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runs;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: flat_tree_bench file [runs]\n");
+        return 1;
+    }
+    int runs = argc > 2 ? atoi(argv[2]) : 20;
+    Tokenizer tokenizer;
+    tokenizer.Tokenize(argv[1]);
+    Parser parser(&tokenizer);
+    parser.Parse();
+
+    FlatTree tree;
+    FlatTreeBuilder builder;
+    WalkResult pointer, preorder, scan;
+    PointerWalk walk;
+    double build = measure(runs, pointer, [&]() { tree = builder.Build(parser.GetRoot()); return WalkResult(); });
+    double pointerTime = measure(runs, pointer, [&]() { return walk.Run(parser.GetRoot()); });
+    double preorderTime = measure(runs, preorder, [&]() { return preorderWalk(tree); });
+    double scanTime = measure(runs, scan, [&]() { return linearScan(tree); });
+
+    double nodes = tree.Size();
+    printf("nodes: %u, opaque: %llu\n", tree.Size(), (unsigned long long)scan.counts[(size_t)NodeKind::OPAQUE]);
+    printf("build flat tree:\t%.3f ms\t%.2f ns/node\n", build * 1e3, build * 1e9 / nodes);
+    printf("pointer walk:\t%.3f ms\t%.2f ns/node\n", pointerTime * 1e3, pointerTime * 1e9 / nodes);
+    printf("flat preorder:\t%.3f ms\t%.2f ns/node\n", preorderTime * 1e3, preorderTime * 1e9 / nodes);
+    printf("flat scan:\t%.3f ms\t%.2f ns/node\n", scanTime * 1e3, scanTime * 1e9 / nodes);
+    if (!(pointer == preorder) || !(pointer == scan))
+    {
+        printf("walks disagree\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Keyword classification: constexpr perfect hash against the unordered_set/unordered_map pair
+// the tokenizer used before. Usage: keyword_bench [identifier count]
+
+#include "token.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_set>
+
+static std::unordered_set<std::string> Keywords =
+{
+    "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
+    "extern", "float", "for", "goto", "if", "int", "long", "register", "return", "short",
+    "signed", "sizeof", "static", "struct", "typedef", "union", "unsigned", "void", "volatile", "while",
+    "printf"
+};
+
+static std::unordered_map<std::string, Keyword> StringToKeyword;
+
+static std::vector<std::string> makeInput(size_t count)
+{
+    std::mt19937 rng(42);
+    std::vector<std::string> res;
+    res.reserve(count);
+    const char letters[] = "abcdefghijklmnopqrstuvwxyz_0123456789";
+    for (size_t i = 0; i < count; i++)
+    {
+        // about a third of identifiers in real code are keywords
+        if (rng() % 3 == 0)
+        {
+            res.emplace_back(KeywordList[rng() % (sizeof(KeywordList) / sizeof(KeywordList[0]))].text);
+            continue;
+        }
+        std::string id(1, letters[rng() % 27]);
+        auto length = rng() % 10;
+        for (size_t j = 0; j < length; j++)
+            id.push_back(letters[rng() % (sizeof(letters) - 1)]);
+        res.push_back(id);
+    }
+    return res;
+}
+
+template<typename F>
+static double measure(const std::vector<std::string> &input, uint64_t &checksum, F classify)
+{
+    const int runs = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++)
+        for (auto &id: input)
+            checksum += classify(id);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runs / input.size();
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    for (auto &entry: KeywordList)
+        StringToKeyword[std::string(entry.text)] = entry.keyword;
+    auto input = makeInput(count);
+    uint64_t mapsChecksum = 0, hashChecksum = 0;
+    double maps = measure(input, mapsChecksum, [](const std::string &id)
+    {
+        if (Keywords.find(id) == Keywords.end()) return 0;
+        return (int)StringToKeyword[id] + 1;
+    });
+    double hash = measure(input, hashChecksum, [](const std::string &id)
+    {
+        Keyword keyword;
+        return LookupKeyword(id, keyword) ? (int)keyword + 1 : 0;
+    });
+    printf("identifiers: %zu\n", count);
+    printf("unordered maps:\t%.2f ns/identifier\n", maps);
+    printf("perfect hash:\t%.2f ns/identifier\n", hash);
+    if (mapsChecksum != hashChecksum)
+    {
+        printf("results differ\n");
+        return 1;
+    }
+    return 0;
+}
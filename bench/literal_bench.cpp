@@ -0,0 +1,140 @@
+// Numeric literal decoding: the literal decoders against std::stoull/std::stold with exceptions
+// for errors, which is what the tokenizer did before. Usage: literal_bench [literal count]
+
+#include "literals.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Literal
+{
+    std::string text;
+    bool isFloat;
+};
+
+static std::vector<Literal> makeInput(size_t count)
+{
+    std::mt19937 rng(42);
+    std::vector<Literal> res;
+    res.reserve(count);
+    auto digits = [&rng](int n, const char *alphabet, int size)
+    {
+        std::string s;
+        for (int i = 0; i < n; i++)
+            s.push_back(alphabet[rng() % size]);
+        return s;
+    };
+    for (size_t i = 0; i < count; i++)
+    {
+        switch (rng() % 8)
+        {
+            case 0: case 1: case 2:
+                res.push_back({std::to_string(rng() % 100000), false});
+                break;
+            case 3:
+                res.push_back({"0x" + digits(1 + rng() % 8, "0123456789abcdefABCDEF", 22), false});
+                break;
+            case 4:
+                res.push_back({"0" + digits(1 + rng() % 6, "01234567", 8), false});
+                break;
+            case 5:
+                res.push_back({std::to_string(rng() % 1000) + "." + digits(1 + rng() % 4, "0123456789", 10), true});
+                break;
+            case 6:
+                res.push_back({digits(1 + rng() % 3, "123456789", 9) + "." + digits(rng() % 3, "0123456789", 10) +
+                               "e" + (rng() % 2 ? "-" : "+") + std::to_string(rng() % 40), true});
+                break;
+            default:
+                // a sprinkle of literals that do not fit or need a correctly rounded long conversion
+                if (rng() % 16 == 0)
+                    res.push_back({"99999999999999999999999", false});
+                else if (rng() % 16 == 0)
+                    res.push_back({"3.14159265358979323846264338327950288", true});
+                else
+                    res.push_back({"0." + digits(1 + rng() % 6, "0123456789", 10), true});
+        }
+    }
+    return res;
+}
+
+struct Result
+{
+    uint64_t intValue;
+    long double floatValue;
+    bool error;
+};
+
+static Result exceptions(const Literal &literal)
+{
+    Result r{0, 0, false};
+    const auto &buffer = literal.text;
+    try
+    {
+        if (literal.isFloat)
+            r.floatValue = std::stold(buffer);
+        else if (buffer.length() >= 2 && (buffer[1] == 'x' || buffer[1] == 'X'))
+            r.intValue = std::stoull(buffer, nullptr, 16);
+        else if (buffer[0] == '0')
+            r.intValue = std::stoull(buffer, nullptr, 8);
+        else
+            r.intValue = std::stoull(buffer, nullptr, 10);
+    }
+    catch (std::out_of_range &e)
+    {
+        r.error = true;
+    }
+    catch (std::invalid_argument &e)
+    {
+        r.error = true;
+    }
+    return r;
+}
+
+static Result decoders(const Literal &literal)
+{
+    Result r{0, 0, false};
+    auto status = literal.isFloat ? DecodeFloatLiteral(literal.text, r.floatValue)
+                                  : DecodeIntLiteral(literal.text, r.intValue);
+    r.error = status != LiteralStatus::OK;
+    return r;
+}
+
+template<typename F>
+static double measure(const std::vector<Literal> &input, std::vector<Result> &results, F decode)
+{
+    const int runs = 10;
+    results.assign(input.size(), Result());
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++)
+        for (size_t i = 0; i < input.size(); i++)
+            results[i] = decode(input[i]);
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / runs / input.size();
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    auto input = makeInput(count);
+    std::vector<Result> expected, actual;
+    double old = measure(input, expected, exceptions);
+    double decoded = measure(input, actual, decoders);
+    printf("literals: %zu\n", count);
+    printf("stoull/stold:\t%.2f ns/literal\n", old);
+    printf("decoders:\t%.2f ns/literal\n", decoded);
+    for (size_t i = 0; i < input.size(); i++)
+        if (expected[i].error != actual[i].error || (!expected[i].error &&
+            (expected[i].intValue != actual[i].intValue ||
+             memcmp(&expected[i].floatValue, &actual[i].floatValue, 10) != 0)))
+        {
+            printf("results differ on %s\n", input[i].text.c_str());
+            return 1;
+        }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Deeply nested sources of the kind code generators produce: how long parsing and code generation take
+// as the nesting grows, and how deep every shape gets on the given stack before the compiler gives up
+// with a NestingTooDeepError. Usage: nesting_bench [stack MB] [max depth]
+
+#include "parser.h"
+#include "stack_guard.h"
+#include "errors/tcc_exceptions.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+struct Shape
+{
+    const char *name;
+    const char *open, *inner, *close;
+};
+
+static const Shape Shapes[] =
+{
+    {"parentheses", "(", "1", ")"},
+    {"unary minus", "- ", "1", ""},
+    {"casts", "(int)", "1", ""},
+    {"a+b+c chain", "1+", "1", ""},
+    {"comma chain", "1,", "1", ""},
+    {"assignments", "a=", "1", ""},
+    {"blocks", "{", "a=1;", "}"},
+    {"if chain", "if (a) ", "a=1;", ""},
+};
+
+static bool isStatement(const Shape &shape)
+{
+    return shape.inner[strlen(shape.inner) - 1] == ';';
+}
+
+static std::string makeSource(const Shape &shape, size_t depth)
+{
+    std::string body;
+    for (size_t i = 0; i < depth; i++)
+        body += shape.open;
+    body += shape.inner;
+    for (size_t i = 0; i < depth; i++)
+        body += shape.close;
+    if (isStatement(shape))
+        return "int main(){int a; " + body + " return a;}\n";
+    return "int main(){int a; a = " + body + "; return a;}\n";
+}
+
+// seconds it took, negative when the nesting was too deep
+static double compile(const std::string &source)
+{
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        Tokenizer tokenizer;
+        tokenizer.TokenizeText(source);
+        Parser parser(&tokenizer);
+        Asm::Assembly assembly;
+        parser.Parse();
+        parser.Generate(&assembly);
+    }
+    catch (NestingTooDeepError &e)
+    {
+        CompilationArena.Reset();
+        return -1;
+    }
+    CompilationArena.Reset();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char **argv)
+{
+    size_t stackMB = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    size_t maxDepth = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1 << 18;
+    printf("stack: %zu MB\n", stackMB);
+    RunWithStack(stackMB << 20, [maxDepth]()
+    {
+        for (auto &shape: Shapes)
+        {
+            printf("%s:", shape.name);
+            size_t depth = 1000;
+            for (; depth <= maxDepth; depth *= 4)
+            {
+                double seconds = compile(makeSource(shape, depth));
+                if (seconds < 0)
+                    break;
+                printf("\t%zu in %.3f s", depth, seconds);
+            }
+            if (depth <= maxDepth)
+            {
+                // the deepest that still compiles lies between the last two tries
+                size_t lo = depth / 4, hi = depth;
+                while (hi - lo > lo / 100 + 1)
+                {
+                    auto mid = lo + (hi - lo) / 2;
+                    (compile(makeSource(shape, mid)) < 0 ? hi : lo) = mid;
+                }
+                printf("\ttoo deep at %zu", hi);
+            }
+            printf("\n");
+        }
+    });
+    return 0;
+}
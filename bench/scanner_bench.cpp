@@ -0,0 +1,85 @@
+// Token scanning throughput of the table-driven automaton against the direct-coded one.
+// Usage: scanner_bench [file], without a file a synthetic source of about 32 MB is scanned.
+
+#include "dfa.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static std::string makeInput()
+{
+    const char *chunk =
+            "int fibonacci(int n)\n"
+            "{\n"
+            "    /* iterative version */\n"
+            "    int a = 0, b = 1;\n"
+            "    for (int i = 0; i < n; i++)\n"
+            "    {\n"
+            "        int t = a + b; // next one\n"
+            "        a = b;\n"
+            "        b = t;\n"
+            "    }\n"
+            "    printf(\"%d %f\\n\", a, 3.25e-2);\n"
+            "    return a >= 0x7fffffff ? -1 : a << 2;\n"
+            "}\n";
+    std::string res;
+    while (res.size() < (32u << 20))
+        res += chunk;
+    return res;
+}
+
+template<typename F>
+static double measure(const std::string &input, uint64_t &checksum, F run)
+{
+    const int runs = 5;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++)
+    {
+        const char *p = input.data(), *end = p + input.size();
+        while (p != end)
+        {
+            if (!FiniteAutomata(0, *p))
+            {
+                p++;
+                continue;
+            }
+            int state = run(0, p, end);
+            if (!state)
+                p++;
+            else if (p != end && FiniteAutomata(state, *p) == (int)SpecialFAStates::Comment)
+                while (p != end && *p != '\n') p++;
+            else if (p != end && FiniteAutomata(state, *p) == (int)SpecialFAStates::MultilineComment)
+                while (p + 1 < end && !(p[0] == '*' && p[1] == '/')) p++;
+            checksum += state;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return input.size() * runs / elapsed.count() / (1 << 20);
+}
+
+int main(int argc, char **argv)
+{
+    std::string input;
+    if (argc > 1)
+    {
+        std::ifstream file(argv[1], std::ios::binary);
+        input.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    else
+        input = makeInput();
+    uint64_t tableChecksum = 0, directChecksum = 0;
+    double table = measure(input, tableChecksum, RunFiniteAutomataTable);
+    double direct = measure(input, directChecksum, RunFiniteAutomataDirect);
+    printf("input: %zu bytes\n", input.size());
+    printf("table driven:\t%.1f MB/s\n", table);
+    printf("direct coded:\t%.1f MB/s\n", direct);
+    if (tableChecksum != directChecksum)
+    {
+        printf("results differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#ifndef TINY_C_COMPILER_ARENA_H
+#define TINY_C_COMPILER_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ArenaObject;
+
+// Bump pointer allocator for everything that lives as long as a compilation: AST nodes, symbols and scopes.
+// Objects in it are never destroyed one by one, Reset destroys all of them at once, newest first, and keeps
+// the blocks for the next file, Release gives the blocks back too. Members that allocate on their own
+// (strings, containers) still use the heap and are freed by those destructors. Nothing global keeps objects
+// of the arena (canonical types have an arena of their own), so a batch can compile file after file
+// with a Reset in between.
+class Arena
+{
+public:
+    static constexpr size_t BlockSize = 1 << 20;
+
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena();
+
+    // the arena that new of an ArenaObject allocates from on this thread
+    static Arena *Active() { return active; }
+    void Activate() { active = this; }
+
+    void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        allocations++;
+        bytesAllocated += size;
+        auto p = (char *)(((uintptr_t)next + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        if (next && p + size <= end)
+        {
+            next = p + size;
+            return p;
+        }
+        return allocateSlow(size, alignment);
+    }
+    // object is destroyed on Reset and Release
+    void Track(ArenaObject *object) { objects.push_back(object); }
+    // object is gone already, its constructor threw
+    void Forget(void *object);
+    void Reset();
+    void Release();
+
+    uint64_t Allocations() const { return allocations; }
+    uint64_t BytesAllocated() const { return bytesAllocated; }
+    uint64_t BytesReserved() const;
+    size_t Blocks() const { return blocks.size(); }
+private:
+    struct Block
+    {
+        char *data;
+        size_t size;
+    };
+
+    static thread_local Arena *active;
+    std::vector<Block> blocks;
+    std::vector<ArenaObject *> objects;
+    size_t current = 0;
+    char *next = nullptr;
+    char *end = nullptr;
+    uint64_t allocations = 0;
+    uint64_t bytesAllocated = 0;
+    void *allocateSlow(size_t size, size_t alignment);
+};
+
+// The arena every compilation uses unless a thread activates another one
+extern Arena CompilationArena;
+
+// Base of the classes that are allocated in the active arena by plain new. It is the first base
+// of every such class, so the memory new returns is the ArenaObject that the arena destroys later.
+class ArenaObject
+{
+public:
+    virtual ~ArenaObject() = default;
+    static void *operator new(size_t size)
+    {
+        auto arena = Arena::Active();
+        auto p = arena->Allocate(size);
+        arena->Track((ArenaObject *)p);
+        return p;
+    }
+    // only called when a constructor throws, the arena keeps the memory
+    static void operator delete(void *p) { Arena::Active()->Forget(p); }
+};
+
+#endif //TINY_C_COMPILER_ARENA_H
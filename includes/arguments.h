@@ -22,7 +22,7 @@ namespace Asm
 
     enum class Register
     {
-        EAX, EBX, ECX, EDX, EBP, ESP, ST0, BL, CL, ESI, EDI
+        EAX, EBX, ECX, EDX, EBP, ESP, ST0, BL, CL, ESI, EDI, AL, AX
     };
 
     static std::unordered_map<Register, std::string> RegisterToString =
@@ -32,7 +32,8 @@ namespace Asm
             {Register::EBP, "ebp"}, {Register::ESP, "esp"},
             {Register::ST0, "st(0)"}, {Register::BL, "bl"},
             {Register::CL, "cl"}, {Register::EDI, "edi"},
-            {Register::ESI, "esi"},
+            {Register::ESI, "esi"}, {Register::AL, "al"},
+            {Register::AX, "ax"},
     };
 
     class ArgumentRegister: public Argument
@@ -57,6 +58,8 @@ namespace Asm
             {Register::CL, new ArgumentRegister(Register::CL)},
             {Register::EDI, new ArgumentRegister(Register::EDI)},
             {Register::ESI, new ArgumentRegister(Register::ESI)},
+            {Register::AL, new ArgumentRegister(Register::AL)},
+            {Register::AX, new ArgumentRegister(Register::AX)},
     };
 
     class ArgumentAddress: public Argument
@@ -6,6 +6,7 @@
 #define TINY_C_COMPILER_ASM_DIRECTIVE_H
 
 #include <unordered_map>
+#include <string_view>
 #include "asm_element.h"
 
 namespace Asm
@@ -20,10 +21,12 @@ namespace Asm
     class AsmStringDirective: public AsmDirective
     {
     public:
-        AsmStringDirective(std::string str);
+        // str is the literal as spelled in the source, quotes and escapes included.
+        // It is not copied and has to outlive the directive.
+        AsmStringDirective(std::string_view str);
         void Print(std::ostream &os) override;
     private:
-        std::string str;
+        std::string_view str;
     };
 }
 
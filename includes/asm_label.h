@@ -6,6 +6,7 @@
 #define TINY_C_COMPILER_ASM_LABEL_H
 
 #include "asm_element.h"
+#include "interner.h"
 
 namespace Asm
 {
@@ -29,11 +30,11 @@ namespace Asm
     class AsmFunction: public AsmLabel
     {
     public:
-        AsmFunction(std::string name);
+        AsmFunction(NameId name);
         std::string GetName() override;
         void Print(std::ostream &os) override;
     private:
-        std::string name;
+        NameId name;
     };
 }
 
@@ -20,7 +20,7 @@ namespace Asm
         Section &DataSection();
         Section &BssSection();
         AsmSimpleLabel *NextLabel();
-        AsmFunction *MakeFunctionLabel(std::string name);
+        AsmFunction *MakeFunctionLabel(NameId name);
         friend std::ostream &operator<<(std::ostream &os, Assembly &parser);
     private:
         Section textSection;
@@ -0,0 +1,117 @@
+#ifndef TINY_C_COMPILER_AST_VISITOR_H
+#define TINY_C_COMPILER_AST_VISITOR_H
+
+#include "nodes.h"
+
+// Dispatches on Node::GetNodeKind() with a switch instead of a virtual call per pass, so that a new pass is
+// a class of its own and no node has to know about it. Derived overrides only the VisitXxx it cares about,
+// the rest fall back to VisitExpr, VisitStatement, VisitInitializer or VisitDesignator and then to VisitNode.
+template<typename Derived, typename Result = void>
+class AstVisitor
+{
+public:
+    Result Visit(Node *node)
+    {
+        auto self = static_cast<Derived *>(this);
+        switch (node->GetNodeKind())
+        {
+#define VISIT(KIND, METHOD, CLASS) case NodeKind::KIND: return self->METHOD(static_cast<CLASS *>(node));
+            VISIT(INT_CONST, VisitIntConst, IntConstNode)
+            VISIT(FLOAT_CONST, VisitFloatConst, FloatConstNode)
+            VISIT(STRING_LITERAL, VisitStringLiteral, StringLiteralNode)
+            VISIT(ID, VisitId, IdNode)
+            VISIT(POSTFIX_INCREMENT, VisitPostfixIncrement, PostfixIncrementNode)
+            VISIT(POSTFIX_DECREMENT, VisitPostfixDecrement, PostfixDecrementNode)
+            VISIT(PREFIX_INCREMENT, VisitPrefixIncrement, PrefixIncrementNode)
+            VISIT(PREFIX_DECREMENT, VisitPrefixDecrement, PrefixDecrementNode)
+            VISIT(MEMBER_ACCESS, VisitMemberAccess, StructureOrUnionMemberAccessNode)
+            VISIT(MEMBER_ACCESS_BY_POINTER, VisitMemberAccessByPointer, StructureOrUnionMemberAccessByPointerNode)
+            VISIT(ARRAY_ACCESS, VisitArrayAccess, ArrayAccessNode)
+            VISIT(FUNCTION_CALL, VisitFunctionCall, FunctionCallNode)
+            VISIT(PRINTF, VisitPrintf, PrintfNode)
+            VISIT(SIZEOF_EXPR, VisitSizeofExpr, SizeofExprNode)
+            VISIT(SIZEOF_TYPE, VisitSizeofTypeName, SizeofTypeNameNode)
+            VISIT(UNARY_OP, VisitUnaryOp, UnaryOpNode)
+            VISIT(BIN_OP, VisitBinOp, BinOpNode)
+            VISIT(TERNARY, VisitTernary, TernaryOperatorNode)
+            VISIT(ASSIGNMENT, VisitAssignment, AssignmentNode)
+            VISIT(COMMA, VisitComma, CommaSeparatedExprs)
+            VISIT(TYPE_CAST, VisitTypeCast, TypeCastNode)
+            VISIT(ENUMERATOR, VisitEnumerator, EnumeratorNode)
+            VISIT(EXPR_STATEMENT, VisitExprStatement, ExprStatmentNode)
+            VISIT(IF, VisitIf, IfStatementNode)
+            VISIT(IF_ELSE, VisitIfElse, IfElseStatementNode)
+            VISIT(GOTO, VisitGoto, GotoStatementNode)
+            VISIT(CONTINUE, VisitContinue, ContinueStatementNode)
+            VISIT(BREAK, VisitBreak, BreakStatementNode)
+            VISIT(RETURN, VisitReturn, ReturnStatementNode)
+            VISIT(WHILE, VisitWhile, WhileStatementNode)
+            VISIT(DO_WHILE, VisitDoWhile, DoWhileStatementNode)
+            VISIT(FOR, VisitFor, ForStatementNode)
+            VISIT(LABEL, VisitLabel, LabelStatementNode)
+            VISIT(COMPOUND, VisitCompound, CompoundStatement)
+            VISIT(FUNCTION_DEFINITION, VisitFunctionDefinition, FunctionDefinitionNode)
+            VISIT(TRANSLATION_UNIT, VisitTranslationUnit, TranslationUnitNode)
+            VISIT(SIMPLE_INITIALIZER, VisitSimpleInitializer, SimpleInitializer)
+            VISIT(INITIALIZER_LIST, VisitInitializerList, InitializerListNode)
+            VISIT(DESIGNATED_INITIALIZER, VisitDesignatedInitializer, DesignatedInitializerNode)
+            VISIT(ARRAY_DESIGNATOR, VisitArrayDesignator, ArrayDesignator)
+            VISIT(STRUCT_MEMBER_DESIGNATOR, VisitStructMemberDesignator, StructMemberDesignator)
+#undef VISIT
+            default:
+                return self->VisitNode(node);
+        }
+    }
+
+    Result VisitNode(Node *) { return Result(); }
+    Result VisitExpr(ExprNode *node) { return static_cast<Derived *>(this)->VisitNode(node); }
+    Result VisitStatement(StatementNode *node) { return static_cast<Derived *>(this)->VisitNode(node); }
+    Result VisitInitializer(InitializerNode *node) { return static_cast<Derived *>(this)->VisitNode(node); }
+    Result VisitDesignator(DesignatorNode *node) { return static_cast<Derived *>(this)->VisitNode(node); }
+
+#define FALLBACK(METHOD, CLASS, BASE) Result METHOD(CLASS *node) { return static_cast<Derived *>(this)->BASE(node); }
+    FALLBACK(VisitIntConst, IntConstNode, VisitExpr)
+    FALLBACK(VisitFloatConst, FloatConstNode, VisitExpr)
+    FALLBACK(VisitStringLiteral, StringLiteralNode, VisitExpr)
+    FALLBACK(VisitId, IdNode, VisitExpr)
+    FALLBACK(VisitPostfixIncrement, PostfixIncrementNode, VisitExpr)
+    FALLBACK(VisitPostfixDecrement, PostfixDecrementNode, VisitExpr)
+    FALLBACK(VisitPrefixIncrement, PrefixIncrementNode, VisitExpr)
+    FALLBACK(VisitPrefixDecrement, PrefixDecrementNode, VisitExpr)
+    FALLBACK(VisitMemberAccess, StructureOrUnionMemberAccessNode, VisitExpr)
+    FALLBACK(VisitMemberAccessByPointer, StructureOrUnionMemberAccessByPointerNode, VisitExpr)
+    FALLBACK(VisitArrayAccess, ArrayAccessNode, VisitExpr)
+    FALLBACK(VisitFunctionCall, FunctionCallNode, VisitExpr)
+    FALLBACK(VisitPrintf, PrintfNode, VisitExpr)
+    FALLBACK(VisitSizeofExpr, SizeofExprNode, VisitExpr)
+    FALLBACK(VisitSizeofTypeName, SizeofTypeNameNode, VisitExpr)
+    FALLBACK(VisitUnaryOp, UnaryOpNode, VisitExpr)
+    FALLBACK(VisitBinOp, BinOpNode, VisitExpr)
+    FALLBACK(VisitTernary, TernaryOperatorNode, VisitExpr)
+    FALLBACK(VisitAssignment, AssignmentNode, VisitExpr)
+    FALLBACK(VisitComma, CommaSeparatedExprs, VisitExpr)
+    FALLBACK(VisitTypeCast, TypeCastNode, VisitExpr)
+    FALLBACK(VisitEnumerator, EnumeratorNode, VisitExpr)
+    FALLBACK(VisitExprStatement, ExprStatmentNode, VisitStatement)
+    FALLBACK(VisitIf, IfStatementNode, VisitStatement)
+    FALLBACK(VisitIfElse, IfElseStatementNode, VisitStatement)
+    FALLBACK(VisitGoto, GotoStatementNode, VisitStatement)
+    FALLBACK(VisitContinue, ContinueStatementNode, VisitStatement)
+    FALLBACK(VisitBreak, BreakStatementNode, VisitStatement)
+    FALLBACK(VisitReturn, ReturnStatementNode, VisitStatement)
+    FALLBACK(VisitWhile, WhileStatementNode, VisitStatement)
+    FALLBACK(VisitDoWhile, DoWhileStatementNode, VisitStatement)
+    FALLBACK(VisitFor, ForStatementNode, VisitStatement)
+    FALLBACK(VisitLabel, LabelStatementNode, VisitStatement)
+    FALLBACK(VisitCompound, CompoundStatement, VisitStatement)
+    FALLBACK(VisitFunctionDefinition, FunctionDefinitionNode, VisitNode)
+    FALLBACK(VisitTranslationUnit, TranslationUnitNode, VisitNode)
+    FALLBACK(VisitSimpleInitializer, SimpleInitializer, VisitInitializer)
+    FALLBACK(VisitInitializerList, InitializerListNode, VisitInitializer)
+    FALLBACK(VisitDesignatedInitializer, DesignatedInitializerNode, VisitInitializer)
+    FALLBACK(VisitArrayDesignator, ArrayDesignator, VisitDesignator)
+    FALLBACK(VisitStructMemberDesignator, StructMemberDesignator, VisitDesignator)
+#undef FALLBACK
+};
+
+#endif //TINY_C_COMPILER_AST_VISITOR_H
@@ -19,7 +19,7 @@ namespace Asm
         PUSH, POP, MOV, ADD, SUB, FLD, FILD, FST, FSTP, FADDP, CALL, LEAVE, RET, FSUBP,
         MUL, DIV, FMULP, FDIVP, CMP, JMP, JE, JNE, JG, JGE, JL, JLE, JZ, JNZ, FCOMIP,
         JA, JAE, JB, JBE, FLDZ, SAL, SAR, AND, OR, XOR, NOT, NEG, FCHS, SETE, MOVZX, LEA, INC, DEC, FLD1,
-        SETG, SETGE, SETL, SETLE, SETNE, IMUL, IDIV, SETB, SETBE, SETA, SETAE
+        SETG, SETGE, SETL, SETLE, SETNE, IMUL, IDIV, SETB, SETBE, SETA, SETAE, MOVSBL, MOVZBL, MOVSWL, MOVZWL
     };
 
     static std::unordered_map<CommandName, std::string> CommandNameToString =
@@ -52,7 +52,9 @@ namespace Asm
             {CommandName::SETLE, "setle"}, {CommandName::SETNE, "setne"},
             {CommandName::IDIV, "idiv"}, {CommandName::IMUL, "imul"},
             {CommandName::SETB, "setb"}, {CommandName::SETA, "seta"},
-            {CommandName::SETBE, "setbe"}, {CommandName::SETAE, "setae"}
+            {CommandName::SETBE, "setbe"}, {CommandName::SETAE, "setae"},
+            {CommandName::MOVSBL, "movsbl"}, {CommandName::MOVZBL, "movzbl"},
+            {CommandName::MOVSWL, "movswl"}, {CommandName::MOVZWL, "movzwl"}
     };
 
     enum class CommandSuffix
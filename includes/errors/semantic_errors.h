@@ -24,42 +24,42 @@ public:
 class UndeclaredIdentifierError: public SemanticError
 {
 public:
-    explicit UndeclaredIdentifierError(std::shared_ptr<Token> token);
+    explicit UndeclaredIdentifierError(Token token);
     const char *what() const throw() override;
 };
 
 class TooLongError: public SemanticError
 {
 public:
-    explicit TooLongError(std::shared_ptr<Token> token, int longtimes);
+    explicit TooLongError(Token token, int longtimes);
     const char *what() const throw() override;
 };
 
 class UnsupportedTypeError: public SemanticError
 {
 public:
-    explicit UnsupportedTypeError(std::shared_ptr<Token> token);
+    explicit UnsupportedTypeError(Token token);
     const char *what() const throw() override;
 };
 
 class DuplicateError: public SemanticError
 {
 public:
-    explicit DuplicateError(std::shared_ptr<Token> token);
+    explicit DuplicateError(Token token);
     const char *what() const throw() override;
 };
 
 class ManyDataTypesError: public SemanticError
 {
 public:
-    explicit ManyDataTypesError(std::shared_ptr<Token> token);
+    explicit ManyDataTypesError(Token token);
     const char *what() const throw() override;
 };
 
 class IncompatibleDeclarationSpecifiersError: public SemanticError
 {
 public:
-    explicit IncompatibleDeclarationSpecifiersError(std::shared_ptr<Token> token, std::string spec);
+    explicit IncompatibleDeclarationSpecifiersError(Token token, std::string spec);
     const char *what() const throw() override;
 };
 
@@ -74,8 +74,8 @@ public:
 class InvalidOperandError: public SemanticError
 {
 public:
-    explicit InvalidOperandError(std::shared_ptr<Token> op, SymType *ltype, SymType *rtype);
-    explicit InvalidOperandError(std::shared_ptr<Token> op, SymType *type);
+    explicit InvalidOperandError(Token op, SymType *ltype, SymType *rtype);
+    explicit InvalidOperandError(Token op, SymType *type);
 
     const char *what() const throw() override;
 };
@@ -110,14 +110,14 @@ public:
 class InvalidUseOfIncompleteType: public SemanticError
 {
 public:
-    explicit InvalidUseOfIncompleteType(std::shared_ptr<Token> token, SymType *type);
+    explicit InvalidUseOfIncompleteType(Token token, SymType *type);
     const char *what() const throw() override;
 };
 
 class RequiredScalarTypeError: public SemanticError
 {
 public:
-    explicit RequiredScalarTypeError(std::shared_ptr<Token> token, SymType *got);
+    explicit RequiredScalarTypeError(Token token, SymType *got);
     explicit RequiredScalarTypeError(ExprNode *expr, SymType *got);
     const char *what() const throw() override;
 };
@@ -164,14 +164,14 @@ public:
 class BadJumpStatementError: public SemanticError
 {
 public:
-    explicit BadJumpStatementError(std::shared_ptr<Token> statement);
+    explicit BadJumpStatementError(Token statement);
     const char *what() const throw() override;
 };
 
 class VoidFunctionBadReturnError: public SemanticError
 {
 public:
-    explicit VoidFunctionBadReturnError(std::shared_ptr<Token> statement);
+    explicit VoidFunctionBadReturnError(Token statement);
     const char *what() const throw() override;
 };
 
@@ -10,20 +10,20 @@
 class SyntaxError: public CompilationError
 {
 public:
-    SyntaxError(std::shared_ptr<Token> token): token(token) {}
+    SyntaxError(Token token): token(token) {}
     const char * what() const throw() override = 0;
 protected:
-    std::shared_ptr<Token> token;
+    Token token;
 };
 
 class UnexpectedTokenError: public SyntaxError
 {
 public:
-    UnexpectedTokenError(std::shared_ptr<Token> token, TokenType expectation): SyntaxError(token), expectation(expectation)
+    UnexpectedTokenError(Token token, TokenType expectation): SyntaxError(token), expectation(expectation)
     {
-        auto pos = token->position;
+        auto pos = token.GetPosition();
         msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-              ") SyntaxError: expected " + TokenTypeToString[expectation] + ", got " + token->text + ".";
+              ") SyntaxError: expected " + std::string(TokenTypeName(expectation)) + ", got " + std::string(token.GetText()) + ".";
     }
 
     const char * what() const throw() override
@@ -37,11 +37,11 @@ private:
 class UnexpectedKeywordError: public SyntaxError
 {
 public:
-    UnexpectedKeywordError(std::shared_ptr<Token> token, Keyword expectation): SyntaxError(token)
+    UnexpectedKeywordError(Token token, Keyword expectation): SyntaxError(token)
     {
-        auto pos = token->position;
+        auto pos = token.GetPosition();
         msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-              ") SyntaxError: expected " + std::to_string((int)expectation) + ", got " + token->text + ".";
+              ") SyntaxError: expected " + std::to_string((int)expectation) + ", got " + std::string(token.GetText()) + ".";
     }
 
     const char * what() const throw() override
@@ -53,9 +53,9 @@ public:
 class NoDeclarationSpecifiers: public SyntaxError
 {
 public:
-    NoDeclarationSpecifiers(std::shared_ptr<Token> token): SyntaxError(token)
+    NoDeclarationSpecifiers(Token token): SyntaxError(token)
     {
-        auto pos = token->position;
+        auto pos = token.GetPosition();
         msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
               ") SyntaxError: missing declaration specifiers";
     }
@@ -69,9 +69,9 @@ public:
 class EmptyEnumeratorListError: public SyntaxError
 {
 public:
-    EmptyEnumeratorListError(std::shared_ptr<Token> token): SyntaxError(token)
+    EmptyEnumeratorListError(Token token): SyntaxError(token)
     {
-            auto pos = token->position;
+            auto pos = token.GetPosition();
             msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
                   ") SyntaxError: empty enumerator list";
     }
@@ -85,9 +85,9 @@ public:
 class InvalidExpression: public SyntaxError
 {
 public:
-    InvalidExpression(std::shared_ptr<Token> token): SyntaxError(token)
+    InvalidExpression(Token token): SyntaxError(token)
     {
-        auto pos = token->position;
+        auto pos = token.GetPosition();
         msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
                   ") SyntaxError: invalid expression";
     }
@@ -98,4 +98,20 @@ public:
     }
 };
 
+class NestingTooDeepError: public SyntaxError
+{
+public:
+    // the walks over the tree have no token at hand, only positions
+    NestingTooDeepError(Position pos): SyntaxError(Token())
+    {
+        msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
+              ") SyntaxError: nesting is too deep, try a bigger --stack-size";
+    }
+
+    const char * what() const throw() override
+    {
+        return msg.c_str();
+    }
+};
+
 #endif //TINY_C_COMPILER_SYNTAX_ERRORS_H
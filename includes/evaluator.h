@@ -5,28 +5,43 @@
 #ifndef TINY_C_COMPILER_EVALUATOR_H
 #define TINY_C_COMPILER_EVALUATOR_H
 
-#include "nodes/expressions.h"
-#include "nodes.h"
+#include "ast_visitor.h"
 
-class Evaluator
+// Folds constant expressions, gives nullptr for the ones it can not. Integers are promoted to int and wrap to
+// the width and signedness of their type like the generated code does, what C leaves undefined (division by zero, INT_MIN / -1,
+// shifts by the width or more, float to integer out of range) is left to the run time.
+class Evaluator: public AstVisitor<Evaluator, ExprNode *>
 {
 public:
     Evaluator() = default;
+    // folds the whole tree of node
     ExprNode *Eval(ExprNode *node);
-    ExprNode *Eval(PostfixDecrementNode *node);
-    ExprNode *Eval(PrefixDecrementNode *node);
-    ExprNode *Eval(PostfixIncrementNode *node);
-    ExprNode *Eval(PrefixIncrementNode *node);
-    ExprNode *Eval(ArrayAccessNode *node);
-    ExprNode *Eval(BinOpNode *node);
-    ExprNode *Eval(UnaryOpNode *node);
-    ExprNode *Eval(SizeofExprNode *node);
-    ExprNode *Eval(SizeofTypeNameNode *node);
-    ExprNode *Eval(AssignmentNode *node);
-    ExprNode *Eval(IntConstNode *node);
-    ExprNode *Eval(FloatConstNode *node);
-    ExprNode *Eval(TypeCastNode *node);
-    ExprNode *Eval(EnumeratorNode *node);
+    // folds node alone, its operands count as constant only if they are constant nodes already
+    ExprNode *Fold(ExprNode *node);
+    ExprNode *VisitBinOp(BinOpNode *node);
+    ExprNode *VisitUnaryOp(UnaryOpNode *node);
+    ExprNode *VisitTernary(TernaryOperatorNode *node);
+    ExprNode *VisitComma(CommaSeparatedExprs *node);
+    ExprNode *VisitTypeCast(TypeCastNode *node);
+    ExprNode *VisitSizeofExpr(SizeofExprNode *node);
+    ExprNode *VisitSizeofTypeName(SizeofTypeNameNode *node);
+    ExprNode *VisitIntConst(IntConstNode *node);
+    ExprNode *VisitFloatConst(FloatConstNode *node);
+    ExprNode *VisitEnumerator(EnumeratorNode *node);
+private:
+    struct Value
+    {
+        BuiltInTypeKind kind;
+        // integers are kept extended to 64 bits by their signedness
+        int64_t integer;
+        double real;
+    };
+    ExprNode *operand(ExprNode *node);
+    bool read(ExprNode *node, Value &value);
+    bool convert(Value &value, BuiltInTypeKind kind);
+    ExprNode *make(const Value &value, ExprNode *origin);
+    ExprNode *sizeOf(SymType *type, ExprNode *origin);
+    bool deep = true;
 };
 
 #endif //TINY_C_COMPILER_EVALUATOR_H
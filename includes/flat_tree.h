@@ -0,0 +1,87 @@
+#ifndef TINY_C_COMPILER_FLAT_TREE_H
+#define TINY_C_COMPILER_FLAT_TREE_H
+
+#include <cstdint>
+#include <vector>
+#include "token.h"
+#include "nodes/node_kind.h"
+
+class Node;
+class SymType;
+
+// What Node::Describe tells about a node: its kind, its children in order and at most one payload.
+// FlatTreeBuilder lays that out in arrays, other descriptions can walk the pointer tree with the same calls.
+class NodeDescription
+{
+public:
+    virtual void Kind(NodeKind kind) = 0;
+    // nullptr stands for a missing child and becomes an EMPTY node
+    virtual void Child(Node *child) = 0;
+    virtual void Int(int32_t) {}
+    virtual void Float(float) {}
+    // the operator of UNARY_OP, BIN_OP and ASSIGNMENT, the name of ID and the text of STRING_LITERAL
+    virtual void Lexeme(Token) {}
+    virtual void Source(Node *) {}
+    virtual void Type(SymType *) {}
+};
+
+struct FlatNode
+{
+    // children of a node are the count nodes from first on
+    uint32_t first;
+    uint32_t count;
+    // index into the payload array of the kind
+    uint32_t payload;
+    NodeKind kind;
+};
+
+// The syntax tree laid out breadth first in one array, so that the children of every node are next to each other
+// and passes that do not care about the order of nodes are a linear scan. Payloads are kept in arrays
+// of their own, types of expressions in an array parallel to the nodes. The root is node 0.
+class FlatTree
+{
+public:
+    static constexpr uint32_t Root = 0;
+
+    uint32_t Size() const { return (uint32_t)nodes.size(); }
+    const FlatNode &operator[](uint32_t i) const { return nodes[i]; }
+    NodeKind Kind(uint32_t i) const { return nodes[i].kind; }
+    uint32_t ChildCount(uint32_t i) const { return nodes[i].count; }
+    uint32_t Child(uint32_t i, uint32_t n) const { return nodes[i].first + n; }
+    int32_t IntValue(uint32_t i) const { return ints[nodes[i].payload]; }
+    float FloatValue(uint32_t i) const { return floats[nodes[i].payload]; }
+    Token GetLexeme(uint32_t i) const { return lexemes[nodes[i].payload]; }
+    Node *GetSource(uint32_t i) const { return sources[nodes[i].payload]; }
+    SymType *GetType(uint32_t i) const { return types[i]; }
+    const std::vector<FlatNode> &Nodes() const { return nodes; }
+    const std::vector<int32_t> &Ints() const { return ints; }
+private:
+    friend class FlatTreeBuilder;
+    std::vector<FlatNode> nodes;
+    std::vector<SymType *> types;
+    std::vector<int32_t> ints;
+    std::vector<float> floats;
+    std::vector<Token> lexemes;
+    std::vector<Node *> sources;
+};
+
+// Converts a pointer tree, the nodes of a FlatTree still point back to it through types, lexemes and sources.
+class FlatTreeBuilder: public NodeDescription
+{
+public:
+    FlatTree Build(Node *root);
+    void Kind(NodeKind kind) override;
+    void Child(Node *child) override;
+    void Int(int32_t value) override;
+    void Float(float value) override;
+    void Lexeme(Token token) override;
+    void Source(Node *node) override;
+    void Type(SymType *type) override;
+private:
+    FlatTree tree;
+    // the pointer node every flat node came from, in the order they wait to be described
+    std::vector<Node *> pending;
+    uint32_t current = 0;
+};
+
+#endif //TINY_C_COMPILER_FLAT_TREE_H
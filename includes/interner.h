@@ -0,0 +1,39 @@
+#ifndef TINY_C_COMPILER_INTERNER_H
+#define TINY_C_COMPILER_INTERNER_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <deque>
+#include <cstdint>
+#include <mutex>
+
+typedef uint32_t NameId;
+
+// Maps every distinct identifier to a dense id, so that scopes and labels can key on an integer.
+// Id 0 is always the empty name. Lexing interns on one thread, SetShared(true) makes every call take a lock
+// for as long as parser threads share the interner.
+class Interner
+{
+public:
+    Interner();
+    NameId Intern(std::string_view name);
+    const std::string &Spelling(NameId id) const
+    {
+        if (!shared)
+            return spellings[id];
+        std::lock_guard<std::mutex> lock(mutex);
+        return spellings[id];
+    }
+    size_t Size() const { return spellings.size(); }
+    void SetShared(bool shared) { this->shared = shared; }
+private:
+    std::deque<std::string> spellings;
+    std::unordered_map<std::string_view, NameId> ids;
+    bool shared = false;
+    mutable std::mutex mutex;
+};
+
+extern Interner Identifiers;
+
+#endif //TINY_C_COMPILER_INTERNER_H
@@ -0,0 +1,23 @@
+#ifndef TINY_C_COMPILER_LITERALS_H
+#define TINY_C_COMPILER_LITERALS_H
+
+#include <string_view>
+#include <cstdint>
+
+// Decoders for the literal spellings the automaton accepts. They work on the source bytes,
+// never allocate and never throw, the tokenizer turns a bad status into a lexical error.
+
+enum class LiteralStatus
+{
+    OK, OUT_OF_RANGE, MALFORMED
+};
+
+// 0x prefix for hex, a leading 0 for octal. Like strtoull, an octal literal ends at the first digit
+// that is not octal.
+LiteralStatus DecodeIntLiteral(std::string_view text, uint64_t &value);
+// digits '.' digits [eE [+-] digits], either side of the point may be empty
+LiteralStatus DecodeFloatLiteral(std::string_view text, long double &value);
+// the character following a backslash
+LiteralStatus DecodeEscape(char c, char &value);
+
+#endif //TINY_C_COMPILER_LITERALS_H
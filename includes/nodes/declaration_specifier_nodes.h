@@ -30,19 +30,19 @@ protected:
 class SimpleSpecifier: public DeclarationSpecifierNode
 {
 public:
-    explicit SimpleSpecifier(std::shared_ptr<Token> specifier);
+    explicit SimpleSpecifier(Token specifier);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    std::shared_ptr<Token> Value();
+    Token Value();
     void Generate(Asm::Assembly *assembly) override;
 protected:
-    std::shared_ptr<Token> value;
+    Token value;
 };
 
 class TypeSpecifierQualifierNode: public SimpleSpecifier
 {
 public:
     TypeSpecifierQualifierNode() = default;
-    explicit TypeSpecifierQualifierNode(std::shared_ptr<Token> value);
+    explicit TypeSpecifierQualifierNode(Token value);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
 };
@@ -50,7 +50,7 @@ public:
 class TypeSpecifierNode: public TypeSpecifierQualifierNode
 {
 public:
-    explicit TypeSpecifierNode(std::shared_ptr<Token> specifier);
+    explicit TypeSpecifierNode(Token specifier);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
 };
@@ -58,7 +58,7 @@ public:
 class TypeQualifierNode: public TypeSpecifierQualifierNode
 {
 public:
-    explicit TypeQualifierNode(std::shared_ptr<Token> qualifier);
+    explicit TypeQualifierNode(Token qualifier);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
 };
@@ -66,7 +66,7 @@ public:
 class StorageClassSpecifierNode: public SimpleSpecifier
 {
 public:
-    explicit StorageClassSpecifierNode(std::shared_ptr<Token> specifier);
+    explicit StorageClassSpecifierNode(Token specifier);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
 };
@@ -74,7 +74,7 @@ public:
 class FunctionSpecifierNode: public SimpleSpecifier
 {
 public:
-    explicit FunctionSpecifierNode(std::shared_ptr<Token> specifier);
+    explicit FunctionSpecifierNode(Token specifier);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
 };
@@ -101,12 +101,12 @@ public:
     TypedefIdentifierNode() = default;
     TypedefIdentifierNode(SymAlias *alias);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
-    std::shared_ptr<Token> GetToken();
+    Token GetToken();
     SymAlias *GetAlias() const;
     void Generate(Asm::Assembly *assembly) override;
 private:
     SymAlias *alias{nullptr};
-    std::shared_ptr<Token> id;
+    Token id;
 };
 
 #endif //TINY_C_COMPILER_DECLARATION_SPECIFIERS_NODES_H
@@ -17,7 +17,6 @@ public:
     ExprNode *GetValue() const;
     void SetValue(ExprNode *);
     IdNode *GetId();
-    ExprNode * Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
 private:
     IdNode *enumerationConstant;
@@ -12,8 +12,6 @@
 
 class SymType;
 
-class Evaluator;
-
 class ExprNode: public Node
 {
 public:
@@ -22,13 +20,20 @@ public:
     void SetType(SymType *type);
     ValueCategory  GetValueCategory() const;
     void SetValueCategory(ValueCategory category);
-    virtual ExprNode * Eval(Evaluator *evaluator) = 0;
     Position GetPosition() const;
     void SetPosition(Position position);
     void SetPosition(int row, int col);
-    void SetPosition(std::shared_ptr<Token> token);
+    void SetPosition(Token token);
     void Generate(Asm::Assembly *assembly) override = 0;
+    // copies the image of a structure of size bytes from the top of the stack to offset(base)
+    static void CopyImage(Asm::Section &section, int32_t size, Asm::Register base, int32_t offset);
 protected:
+    // Kind and Type, which every expression tells
+    void describe(NodeDescription *description, NodeKind kind);
+    // a scalar of type between memory and a register, integers narrower than 4 bytes are extended on load
+    static void load(Asm::Section &section, SymType *type, Asm::ArgumentAddress *address, Asm::Register target);
+    static void store(Asm::Section &section, SymType *type, Asm::ArgumentAddress *address);
+    static int32_t scale(Asm::Section &section, SymType *type, Asm::Register index);
     SymType *type{nullptr};
     ValueCategory  category{ValueCategory::RVALUE};
     Position position{-1, -1};
@@ -39,8 +44,8 @@ class PostfixIncrementNode: public ExprNode
 public:
     explicit PostfixIncrementNode(ExprNode *node);
     virtual void Print(std::ostream &os, std::string ident, bool isTail);
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
 };
@@ -50,8 +55,8 @@ class PostfixDecrementNode: public ExprNode
 public:
     explicit PostfixDecrementNode(ExprNode *node);
     virtual void Print(std::ostream &os, std::string ident, bool isTail);
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
 };
@@ -63,8 +68,8 @@ class StructureOrUnionMemberAccessNode: public ExprNode
 public:
     StructureOrUnionMemberAccessNode(ExprNode *structureOrUnion, IdNode *member);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *structureOrUnion;
     IdNode *member;
@@ -75,8 +80,8 @@ class StructureOrUnionMemberAccessByPointerNode: public ExprNode
 public:
     StructureOrUnionMemberAccessByPointerNode(ExprNode *structureOrUnion, IdNode *member);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *structureOrUnion;
     IdNode *member;
@@ -87,8 +92,8 @@ class ArrayAccessNode: public ExprNode
 public:
     ArrayAccessNode(ExprNode *left, ExprNode *inBrackets);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *array, *index;
 };
@@ -111,8 +116,8 @@ class FunctionCallNode: public ExprNode
 public:
     FunctionCallNode(ExprNode *function, ArgumentExprListNode *arguments);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *function;
     ArgumentExprListNode *arguments;
@@ -125,8 +130,8 @@ class PrintfNode: public ExprNode
 public:
     PrintfNode(StringLiteralNode *format, ArgumentExprListNode *arguments);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     StringLiteralNode *format;
     ArgumentExprListNode *arguments;
@@ -137,8 +142,9 @@ class SizeofExprNode: public  ExprNode
 public:
     explicit SizeofExprNode(ExprNode *expr);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    ExprNode *Operand() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
 };
@@ -150,8 +156,9 @@ class SizeofTypeNameNode: public ExprNode
 public:
     explicit SizeofTypeNameNode(SymType *typeName);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    SymType *GetTypeName() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     SymType *typeName;
 };
@@ -159,15 +166,17 @@ private:
 class UnaryOpNode: public ExprNode
 {
 public:
-    explicit UnaryOpNode(std::shared_ptr<Token> unaryOp, ExprNode *expr);
+    explicit UnaryOpNode(Token unaryOp, ExprNode *expr);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    ExprNode *Operand() const;
+    Token GetOperation() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     void int32Generate(Asm::Assembly *assembly);
     void floatGenerate(Asm::Assembly *assembly);
     void pointerGenerate(Asm::Assembly *assembly);
-    std::shared_ptr<Token> unaryOp;
+    Token unaryOp;
     ExprNode *expr;
 };
 
@@ -176,8 +185,8 @@ class PrefixIncrementNode: public ExprNode
 public:
     explicit PrefixIncrementNode(ExprNode *node);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
 };
@@ -187,8 +196,8 @@ class PrefixDecrementNode: public ExprNode
 public:
     explicit PrefixDecrementNode(ExprNode *node);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
 };
@@ -196,14 +205,14 @@ private:
 class BinOpNode: public ExprNode
 {
 public:
-    BinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> op);
-    BinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> op, SymType *resultType);
+    BinOpNode(ExprNode *left, ExprNode *right, Token op);
+    BinOpNode(ExprNode *left, ExprNode *right, Token op, SymType *resultType);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     ExprNode *Left() const;
     ExprNode *Right() const;
-    std::shared_ptr<Token> GetOperation() const;
+    Token GetOperation() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     void int32Generate(Asm::Assembly *assembly);
     void floatGenerate(Asm::Assembly *assembly);
@@ -211,7 +220,7 @@ private:
     void pointerGenerate(Asm::Assembly *assembly);
     bool isRelop(TokenType tokenType);
     ExprNode *left, *right;
-    std::shared_ptr<Token> op;
+    Token op;
 };
 
 class TernaryOperatorNode: public ExprNode
@@ -219,36 +228,34 @@ class TernaryOperatorNode: public ExprNode
 public:
     TernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    ExprNode *Condition() const;
+    ExprNode *IfTrue() const;
+    ExprNode *IfFalse() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *condition, *iftrue, *iffalse;
 };
 
-class SymArray;
-class SymRecord;
-
 class AssignmentNode: public ExprNode
 {
 public:
-    AssignmentNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> assignmentOp);
+    AssignmentNode(ExprNode *left, ExprNode *right, Token assignmentOp);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
-    void assignArray(Asm::Assembly *assembly, int32_t offset, SymArray *array);
-    void assignStructure(Asm::Assembly *assembly, int32_t offset, SymRecord *record);
     ExprNode *left, *right;
-    std::shared_ptr<Token> assignmentOp;
+    Token assignmentOp;
 };
 
 class CommaSeparatedExprs: public ExprNode
 {
 public:
-    CommaSeparatedExprs() = default;
+    CommaSeparatedExprs() { nodeKind = NodeKind::COMMA; }
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
     void Add(ExprNode *expr);
     uint64_t Size();
     std::list<ExprNode *> &List();
@@ -261,19 +268,18 @@ class SymVariable;
 class IdNode: public ExprNode
 {
 public:
-    explicit IdNode(std::shared_ptr<Token> token);
-    explicit IdNode(std::shared_ptr<Token> token, SymType *type);
+    explicit IdNode(Token token);
+    explicit IdNode(Token token, SymType *type);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    std::string GetName() const;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    const std::string &GetName() const;
+    NameId GetNameId() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
     void SetVariable(SymVariable *variable);
     SymVariable *GetVariable() const;
 private:
-    void arrayGenerate(Asm::Assembly *assembly, int32_t offset, SymArray *array);
-    void structureGenerate(Asm::Assembly *assembly, int32_t offset, SymRecord *record);
     SymVariable *variable;
-    std::shared_ptr<Token> token;
+    Token token;
 };
 
 class IntConstNode;
@@ -283,7 +289,6 @@ class ConstNode: public ExprNode
 {
 public:
     void Print(std::ostream &os, std::string ident, bool isTail) override = 0;
-    ExprNode *Eval(Evaluator *evaluator) override = 0;
     void Generate(Asm::Assembly *assembly) override = 0;
     static IntConstNode *IntZero();
     static IntConstNode *IntOne();
@@ -295,12 +300,12 @@ protected:
 class IntConstNode: public ConstNode
 {
 public:
-    explicit IntConstNode(std::shared_ptr<Token> token);
+    explicit IntConstNode(Token token);
     IntConstNode(int32_t value);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     int32_t GetValue() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     int32_t value;
 };
@@ -308,12 +313,12 @@ private:
 class FloatConstNode: public ConstNode
 {
 public:
-    explicit FloatConstNode(std::shared_ptr<Token> token);
+    explicit FloatConstNode(Token token);
     FloatConstNode(float value);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     float GetValue() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     float value;
 };
@@ -321,13 +326,13 @@ private:
 class StringLiteralNode: public ExprNode
 {
 public:
-    explicit StringLiteralNode(std::shared_ptr<Token> token);
+    explicit StringLiteralNode(Token token);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
     Asm::AsmLabel *GetAddress() const;
 private:
-    std::shared_ptr<Token> token;
+    Token token;
     Asm::AsmLabel *address;
 };
 
@@ -20,6 +20,7 @@ public:
     void SetBody(CompoundStatement *body);
     SymType *GetType() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     DeclaratorNode *declarator;
     CompoundStatement *body;
@@ -112,6 +112,7 @@ private:
 class InitializerListNode: public InitializerNode
 {
 public:
+    InitializerListNode() { nodeKind = NodeKind::INITIALIZER_LIST; }
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Add(InitializerNode *initializer);
     uint64_t Size();
@@ -8,13 +8,21 @@
 #include <ostream>
 #include <memory>
 #include <assembly.h>
+#include <arena.h>
+#include <flat_tree.h>
 
 // Abstract Class
-class Node
+class Node: public ArenaObject
 {
 public:
     virtual void Print(std::ostream &os, std::string ident, bool isTail) = 0;
     virtual void Generate(Asm::Assembly *assembly) = 0;
+    // tells the kind, the children and the payload of the node, nodes that do not are OPAQUE
+    virtual void Describe(NodeDescription *description);
+    NodeKind GetNodeKind() const { return nodeKind; }
+protected:
+    // set by the constructors of the concrete classes, AstVisitor dispatches on it
+    NodeKind nodeKind = NodeKind::OPAQUE;
 };
 
 #endif //TINY_C_COMPILER_NODE_H
@@ -0,0 +1,26 @@
+#ifndef TINY_C_COMPILER_NODE_KIND_H
+#define TINY_C_COMPILER_NODE_KIND_H
+
+#include <cstddef>
+#include <cstdint>
+
+enum class NodeKind: uint8_t
+{
+    // a missing optional child, like the condition of for (;;)
+    EMPTY,
+    // nodes without a kind of their own (declarations, specifiers), they are never visited one by one
+    OPAQUE,
+    INT_CONST, FLOAT_CONST, STRING_LITERAL, ID,
+    POSTFIX_INCREMENT, POSTFIX_DECREMENT, PREFIX_INCREMENT, PREFIX_DECREMENT,
+    MEMBER_ACCESS, MEMBER_ACCESS_BY_POINTER, ARRAY_ACCESS, FUNCTION_CALL, PRINTF,
+    SIZEOF_EXPR, SIZEOF_TYPE, UNARY_OP, BIN_OP, TERNARY, ASSIGNMENT, COMMA, TYPE_CAST, ENUMERATOR,
+    EXPR_STATEMENT, IF, IF_ELSE, GOTO, CONTINUE, BREAK, RETURN, WHILE, DO_WHILE, FOR, LABEL, COMPOUND,
+    FUNCTION_DEFINITION, TRANSLATION_UNIT,
+    SIMPLE_INITIALIZER, INITIALIZER_LIST, DESIGNATED_INITIALIZER, ARRAY_DESIGNATOR, STRUCT_MEMBER_DESIGNATOR
+};
+
+constexpr size_t NodeKindCount = (size_t)NodeKind::STRUCT_MEMBER_DESIGNATOR + 1;
+
+const char *NodeKindName(NodeKind kind);
+
+#endif //TINY_C_COMPILER_NODE_KIND_H
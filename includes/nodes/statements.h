@@ -16,12 +16,13 @@ public:
     void GenerateConditionCheck(Asm::Assembly *assembly, ExprNode *condition);
 };
 
-class ExprStatmentNode: StatementNode
+class ExprStatmentNode: public StatementNode
 {
 public:
     explicit ExprStatmentNode(ExprNode *expr);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
     static void CleanStackAfterExpression(ExprNode *expr, Asm::Assembly *assembly);
 private:
     ExprNode *expr;
@@ -40,6 +41,7 @@ public:
     IfStatementNode(ExprNode *expr, StatementNode *then);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 protected:
     ExprNode *condition;
     StatementNode *body;
@@ -51,6 +53,7 @@ public:
     IfElseStatementNode(ExprNode *expr, StatementNode *then, StatementNode *_else);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     StatementNode *elseBody;
 };
@@ -68,6 +71,7 @@ public:
     explicit GotoStatementNode(IdNode *id);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     IdNode *id;
 };
@@ -75,17 +79,19 @@ private:
 class ContinueStatementNode: public JumpStatementNode
 {
 public:
-    ContinueStatementNode() = default;
+    ContinueStatementNode() { nodeKind = NodeKind::CONTINUE; }
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 };
 
 class BreakStatementNode: public JumpStatementNode
 {
 public:
-    BreakStatementNode() = default;
+    BreakStatementNode() { nodeKind = NodeKind::BREAK; }
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 };
 
 class SymFunction;
@@ -96,6 +102,7 @@ public:
     explicit ReturnStatementNode(ExprNode *expr, SymFunction *function);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *expr;
     SymFunction *function;
@@ -144,6 +151,7 @@ public:
     WhileStatementNode(ExprNode *condition, StatementNode *body);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 };
 
 class DoWhileStatementNode: public IterationStatementNode
@@ -153,6 +161,7 @@ public:
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void SetCondition(ExprNode *condition);
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     Asm::AsmLabel *begining;
 };
@@ -164,6 +173,7 @@ public:
                      ExprNode *iteration, StatementNode *body);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     ExprNode *iteration{}, *init;
 };
@@ -180,6 +190,7 @@ public:
     LabelStatementNode(IdNode *labelName, StatementNode *statement);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     IdNode *labelName{};
     StatementNode *statement;
@@ -193,6 +204,7 @@ public:
     explicit CompoundStatement(BlockItemListNode *blockItemList);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     BlockItemListNode *blockItemList;
 };
@@ -202,6 +214,7 @@ class BlockItemNode: public Node
 public:
     explicit BlockItemNode(Node *declOrStatement);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
+    Node *GetDeclOrStatement() const;
     void Generate(Asm::Assembly *assembly) override;
 private:
     Node *declOrStatement;
@@ -213,6 +226,7 @@ public:
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Add(BlockItemNode *blockItem);
     uint64_t Size();
+    std::list<BlockItemNode *> &List();
     void Generate(Asm::Assembly *assembly) override;
 private:
     std::list<BlockItemNode *> list;
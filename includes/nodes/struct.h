@@ -57,17 +57,17 @@ protected:
 class StructSpecifierNode: public DeclarationSpecifierNode
 {
 public:
-    explicit StructSpecifierNode(SymRecord *type, std::shared_ptr<Token> structToken);
+    explicit StructSpecifierNode(SymRecord *type, Token structToken);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void SetId(IdNode *id);
     IdNode *GetId() const;
     SymRecord *GetRecordType() const;
     void SetRecordType(SymRecord *type);
-    std::shared_ptr<Token> GetToken() const;
+    Token GetToken() const;
     void Generate(Asm::Assembly *assembly) override;
 private:
     SymRecord *type{nullptr};
-    std::shared_ptr<Token> token;
+    Token token;
 };
 
 #endif //TINY_C_COMPILER_STRUCT_H
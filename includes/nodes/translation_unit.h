@@ -18,10 +18,13 @@ public:
 class TranslationUnitNode: public Node
 {
 public:
+    TranslationUnitNode() { nodeKind = NodeKind::TRANSLATION_UNIT; }
     void Print(std::ostream &os, std::string ident, bool isTail) override;
     void Add(ExternalDeclarationNode *initDeclarator);
     uint64_t Size();
+    std::list<ExternalDeclarationNode *> &List();
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 protected:
     std::list<ExternalDeclarationNode *> list;
 };
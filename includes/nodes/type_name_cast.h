@@ -9,6 +9,8 @@
 #include "declaration_specifier_nodes.h"
 #include "decls.h"
 
+#include <functional>
+
 struct BuiltInTypePairHash
 {
     size_t operator()(const std::pair<BuiltInTypeKind, BuiltInTypeKind> &p) const
@@ -17,10 +19,29 @@ struct BuiltInTypePairHash
     }
 };
 
+// integers narrower than 4 bytes lie on the stack extended to 4 bytes, converting to them extends the low part again
+static std::function<void(Asm::Assembly *)> ExtendOnStack(Asm::CommandName extend)
+{
+    return [extend](Asm::Assembly *assembly)
+    {
+        assembly->TextSection().AddCommand(extend, Asm::MakeAddress(Asm::Register::ESP), Asm::Register::EAX);
+        assembly->TextSection().AddCommand(Asm::CommandName::MOV, Asm::Register::EAX,
+                                           Asm::MakeAddress(Asm::Register::ESP), Asm::CommandSuffix::L);
+    };
+}
+
 static std::unordered_map<std::pair<BuiltInTypeKind, BuiltInTypeKind>, std::function<void(Asm::Assembly *)>, BuiltInTypePairHash>
         BuiltInTypeConversions =
 {
         {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::INT32), [](Asm::Assembly *assembly) {}},
+        {std::make_pair(BuiltInTypeKind::INT8, BuiltInTypeKind::INT32), [](Asm::Assembly *assembly) {}},
+        {std::make_pair(BuiltInTypeKind::UINT8, BuiltInTypeKind::INT32), [](Asm::Assembly *assembly) {}},
+        {std::make_pair(BuiltInTypeKind::INT16, BuiltInTypeKind::INT32), [](Asm::Assembly *assembly) {}},
+        {std::make_pair(BuiltInTypeKind::UINT16, BuiltInTypeKind::INT32), [](Asm::Assembly *assembly) {}},
+        {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::INT8), ExtendOnStack(Asm::CommandName::MOVSBL)},
+        {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::UINT8), ExtendOnStack(Asm::CommandName::MOVZBL)},
+        {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::INT16), ExtendOnStack(Asm::CommandName::MOVSWL)},
+        {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::UINT16), ExtendOnStack(Asm::CommandName::MOVZWL)},
         {std::make_pair(BuiltInTypeKind::INT32, BuiltInTypeKind::FLOAT),
                 [](Asm::Assembly *assembly)
                 {
@@ -48,8 +69,9 @@ class TypeCastNode: public ExprNode
 public:
     TypeCastNode(SymType *typeName, ExprNode *castExpr);
     void Print(std::ostream &os, std::string ident, bool isTail) override;
-    ExprNode *Eval(Evaluator *evaluator) override;
+    ExprNode *Operand() const;
     void Generate(Asm::Assembly *assembly) override;
+    void Describe(NodeDescription *description) override;
 private:
     SymType *castType;
     ExprNode *castExpr;
@@ -11,6 +11,7 @@
 #include "symbols.h"
 #include "type_builder.h"
 #include "scope_tree.h"
+#include "stack_guard.h"
 #include <functional>
 #include <stack>
 #include <map>
@@ -62,21 +63,36 @@ public:
     void Parse();
     friend std::ostream &operator<<(std::ostream &os, Parser &parser);
     void Generate(Asm::Assembly *assembly);
+    Node *GetRoot() const;
+    // Makes Parse skip the bodies of function definitions by brace matching, for consumers that only need
+    // the declarations. Generate parses every body right before its code. Needs a batched tokenizer.
+    void DeferBodies(bool defer);
+    // Parses the body of a function definition that Parse skipped, false when there is nothing to parse
+    bool ParseBody(FunctionDefinitionNode *function);
+    // With more than one thread Parse skips the bodies of function definitions like DeferBodies, then parses
+    // them on that many threads once the file scope is complete. The tree and the errors are the same
+    // as with one thread. Needs a batched tokenizer.
+    void SetBodyThreads(unsigned threads);
+    // Makes Parse replace constant expressions with their values, see SemanticAnalyzer::FoldConstants
+    void FoldConstants(bool fold);
+    // Prints the layout of every structure defined in the parsed code in the order of the source,
+    // the bodies Parse skipped count once they are parsed
+    void PrintLayouts(std::ostream &os);
 private:
+    // where a skipped body starts and the state it has to be analysed in
+    struct DeferredBody
+    {
+        Token open;
+        SymFunction *function;
+        // file scope names declared before the body
+        uint32_t visibleGlobals;
+    };
+
     ExprNode            *parsePrimaryExpr();
     ExprNode            *parsePostfixExpr();
     ExprNode            *parseUnaryExpr();
     ExprNode            *parseCastExpr();
-    ExprNode            *parseMultiplicativeExpr();
-    ExprNode            *parseAddictiveExpr();
-    ExprNode            *parseShiftExpr();
-    ExprNode            *parseRelationalExpr();
-    ExprNode            *parseEqualityExpr();
-    ExprNode            *parseAndExpr();
-    ExprNode            *parseExclusiveOrExpr();
-    ExprNode            *parseInclusiveOrExpr();
-    ExprNode            *parseLogicalAndExpr();
-    ExprNode            *parseLogicalOrExpr();
+    ExprNode            *parseBinaryExpr();
     ExprNode            *parseConditionalExpr();
     ExprNode            *parseAssignmentExpr();
     ExprNode            *parseExpr();
@@ -117,7 +133,7 @@ private:
     BlockItemNode              *parseBlockItem();
     EnumSpecifierNode          *parseEnumSpecifier();
     EnumeratorList             *parseEnumeratorList();
-    EnumeratorNode             *parseEnumerator();
+    EnumeratorNode             *parseEnumerator(EnumeratorNode *previous);
     StructSpecifierNode        *parseStructSpecifier();
     StructDeclarationListNode  *parseStructDeclarationList();
     StructDeclarationNode      *parseStructDeclaration();
@@ -131,18 +147,16 @@ private:
     InitializerNode            *parseDesignatedInitializer();
     TranslationUnitNode        *parseTranslationUnit();
     ExternalDeclarationNode    *parseExternalDeclaration();
-    ExprNode *parseBinoOps(Parser *self, ExprNode *(Parser::*f)(),
-                           std::unordered_set<TokenType> types);
-    bool isTypeSpecifier(std::shared_ptr<Token> token);
-    bool isUnaryOp(std::shared_ptr<Token> token);
-    bool isAssignmentOp(std::shared_ptr<Token> token);
-    bool isTypeQualifier(std::shared_ptr<Token> token);
-    bool isStorageClassSpecifier(std::shared_ptr<Token> token);
-    bool isFunctionSpecifier(std::shared_ptr<Token> token);
-    bool isDeclarationSpecifier(std::shared_ptr<Token> token);
-    bool isSimpleSpecifier(std::shared_ptr<Token> token);
+    bool isTypeSpecifier(Token token);
+    bool isUnaryOp(Token token);
+    bool isAssignmentOp(Token token);
+    bool isTypeQualifier(Token token);
+    bool isStorageClassSpecifier(Token token);
+    bool isFunctionSpecifier(Token token);
+    bool isDeclarationSpecifier(Token token);
+    bool isSimpleSpecifier(Token token);
 
-    bool isTypedefIdentifier(const std::shared_ptr<Token> &token);
+    bool isTypedefIdentifier(Token token);
     void require(TokenType typeExpectation);
     void requireKeyword(Keyword expectedKeyword);
     void requireNext(TokenType typeExpectation);
@@ -151,10 +165,26 @@ private:
     bool maybeNext(TokenType typeExpectation);
     bool maybeKeyword(Keyword keyword);
     bool maybeKeywordNext(Keyword keyword);
+    void checkNesting();
+    void skipBody(FunctionDefinitionNode *function);
+    void parseDeferredBody(FunctionDefinitionNode *function, const DeferredBody &body);
+    void parseBodiesOnThreads();
+    Parser(Tokenizer *tokenizer, SymbolTable *fileScope);
 
     Tokenizer *scanner;
     SyntaxTree tree;
     SemanticAnalyzer sematicAnalyzer;
+    // operands and operators of the binary and comma expressions being parsed
+    std::vector<ExprNode *> operandStack;
+    std::vector<Token> operatorStack;
+    bool deferBodies = false;
+    std::unordered_map<FunctionDefinitionNode *, DeferredBody> deferredBodies;
+    // the definitions of deferredBodies in source order
+    std::vector<FunctionDefinitionNode *> deferredOrder;
+    unsigned bodyThreads = 1;
+    bool foldConstants = false;
+    // what the threads allocated the bodies from, they live as long as the parser
+    std::vector<std::unique_ptr<Arena>> bodyArenas;
 };
 
 #endif //TINY_C_COMPILER_PARSER_H
@@ -7,17 +7,45 @@
 
 #include "symbol_table.h"
 
+// Names of the file scope live in a SymbolTable, names of the scopes nested in it in one hash from a name
+// to its innermost binding. A binding that shadows another one is logged and the shadowed one is put back
+// when its scope ends, so finding a name is one or two probes however deep the scopes are.
 class ScopeTree
 {
 public:
     ScopeTree();
-    SymbolTable *GetActiveScope() const;
-    void SetActiveScope(SymbolTable *table);
-    SymbolTable *StartScope();
+    // scopes of a function body over the file scope of another tree, which is then only read
+    explicit ScopeTree(SymbolTable *fileScope);
+    SymbolTable *GetFileScope() const { return root; }
+    // Find sees only the first count names of the file scope, see SymbolTable::Declared
+    void SetVisibleGlobals(uint32_t count) { visibleGlobals = count; }
+    void StartScope();
+    // a scope that starts with the names of the table, the parameters of a function
+    void StartScope(SymbolTable *table);
     void EndScope();
-    Symbol *Find(const std::string &name);
+    bool InFileScope() const { return scopeStarts.empty(); }
+    void Insert(NameId name, Symbol *symbol, SymbolNamespace ns = SymbolNamespace::ORDINARY);
+    Symbol *Find(NameId name, SymbolNamespace ns = SymbolNamespace::ORDINARY) const;
+    // only the names declared in the innermost scope
+    Symbol *FindInActiveScope(NameId name, SymbolNamespace ns = SymbolNamespace::ORDINARY) const;
 private:
-    SymbolTable *root, *activeScope;
+    struct Binding
+    {
+        // nullptr once the scope of the binding ended, the entry stays for the next one
+        Symbol *symbol;
+        uint32_t depth;
+    };
+    struct Shadowed
+    {
+        uint64_t key;
+        Binding binding;
+    };
+    SymbolTable *root;
+    std::unordered_map<uint64_t, Binding> bindings;
+    std::vector<Shadowed> undoLog;
+    // size of the undo log when each of the nested scopes started
+    std::vector<size_t> scopeStarts;
+    uint32_t visibleGlobals = SymbolTable::AllVisible;
 };
 
 #endif //TINY_C_COMPILER_SCOPE_TREE_H
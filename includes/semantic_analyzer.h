@@ -17,49 +17,61 @@
 class SemanticAnalyzer
 {
 public:
-    IdNode *BuildIdNode(std::shared_ptr<Token> token);
+    SemanticAnalyzer() = default;
+    // for function bodies analysed over the file scope of another analyzer, see ScopeTree(SymbolTable *)
+    explicit SemanticAnalyzer(SymbolTable *fileScope): scopeTree(fileScope) {}
+    // Replaces the constant expressions it builds with their values, off so that the tree can be printed
+    // as it was written
+    void FoldConstants(bool fold);
+    IdNode *BuildIdNode(Token token);
     StructSpecifierNode *BuildStructSpecifierNode(IdNode *tag,
                                                   StructDeclarationListNode *structDeclarationList,
-                                                  std::shared_ptr<Token> structToken);
+                                                  Token structToken);
     ScopeTree *GetScopeTree();
-    PostfixDecrementNode *BuildPostfixDecrementNode(ExprNode *expr, const std::shared_ptr<Token> &op);
-    PostfixIncrementNode *BuildPostfixIncrementNode(ExprNode *expr, const std::shared_ptr<Token> &op);
+    // every structure defined so far with the position of its struct keyword, in the order of definition
+    std::vector<std::pair<Position, SymRecord *>> &DefinedRecords();
+    PostfixDecrementNode *BuildPostfixDecrementNode(ExprNode *expr, Token op);
+    PostfixIncrementNode *BuildPostfixIncrementNode(ExprNode *expr, Token op);
     InitDeclaratorNode *BuildInitDeclaratorNode(DeclaratorNode *declarator,
                                                 InitializerNode *initializer,
                                                 bool isTypedef);
     StructureOrUnionMemberAccessNode *BuildStructureOrUnionMemberAccessNode(ExprNode *structure,
                                                                             IdNode *field,
-                                                                            std::shared_ptr<Token> dot);
+                                                                            Token dot);
     StructureOrUnionMemberAccessByPointerNode *BuildStructureOrUnionMemberAccessByPointerNode(ExprNode *ptr,
                                                                                               IdNode *field,
-                                                                                              std::shared_ptr<Token> arrow);
+                                                                                              Token arrow);
     ArrayAccessNode *BuildArrayAccessNode(ExprNode *array, ExprNode *index);
     FunctionCallNode *BuildFunctionCallNode(ExprNode *func, ArgumentExprListNode *args);
-    PrefixIncrementNode *BuildPrefixIncrementNode(ExprNode *expr, const std::shared_ptr<Token> &op);
-    PrefixDecrementNode *BuildPrefixDecrementNode(ExprNode *expr, const std::shared_ptr<Token> &op);
-    UnaryOpNode *BuildUnaryOpNode(std::shared_ptr<Token> unaryOp, ExprNode *expr);
-    BinOpNode *BuildBinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> binOp);
-    TernaryOperatorNode *BuildTernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse,
-                                                  const std::shared_ptr<Token> &question,
-                                                  const std::shared_ptr<Token> &colon);
-    AssignmentNode *BuildAssignmentNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> assignmentOp);
+    PrefixIncrementNode *BuildPrefixIncrementNode(ExprNode *expr, Token op);
+    PrefixDecrementNode *BuildPrefixDecrementNode(ExprNode *expr, Token op);
+    ExprNode *BuildUnaryOpNode(Token unaryOp, ExprNode *expr);
+    ExprNode *BuildBinOpNode(ExprNode *left, ExprNode *right, Token binOp);
+    ExprNode *BuildTernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse,
+                                       Token question,
+                                       Token colon);
+    ExprNode *BuildCommaSeparatedExprs(ExprNode *left, ExprNode *right);
+    ExprNode *BuildSizeofExprNode(ExprNode *expr, Token sizeofToken);
+    ExprNode *BuildSizeofTypeNameNode(SymType *typeName, Token sizeofToken);
+    AssignmentNode *BuildAssignmentNode(ExprNode *left, ExprNode *right, Token assignmentOp);
     FunctionDefinitionNode *BuildFunctionDefinitionNode(DeclaratorNode *declarator, CompoundStatement *body);
-    TypeCastNode *BuildTypeCastNode(SymType *typeName, ExprNode *castExpr);
-    EnumeratorNode *BuildEnumeratorNode(IdNode *enumerator, ExprNode *expr);
+    ExprNode *BuildTypeCastNode(SymType *typeName, ExprNode *castExpr);
+    EnumeratorNode *BuildEnumeratorNode(IdNode *enumerator, ExprNode *expr, EnumeratorNode *previous);
     EnumSpecifierNode *BuildEnumSpecifierNode(IdNode *tag, EnumeratorList *list);
-    ReturnStatementNode *BuildReturnStatementNode(std::shared_ptr<Token> statement, ExprNode *expr);
-    BreakStatementNode *BuildBreakStatementNode(std::shared_ptr<Token> statement);
-    ContinueStatementNode *BuildContinueStatementNode(std::shared_ptr<Token> statement);
-    TypedefIdentifierNode *BuildTypedefIdentifierNode(const std::shared_ptr<Token> &id);
+    ReturnStatementNode *BuildReturnStatementNode(Token statement, ExprNode *expr);
+    BreakStatementNode *BuildBreakStatementNode(Token statement);
+    ContinueStatementNode *BuildContinueStatementNode(Token statement);
+    TypedefIdentifierNode *BuildTypedefIdentifierNode(Token id);
     PrintfNode *BuildPrintfNode(StringLiteralNode *format, ArgumentExprListNode *arguments);
     void CheckSelectionOrIterationStatementCondition(ExprNode *condition);
     ExprNode *EvaluateArraySizer(ExprNode *expr);
     void ProcessFunction(SymFunction *funcType);
+    SymFunction *GetProcessingFunction() const;
     void FinishLastFunctionProcessing();
     void ProcessLoop(IterationStatementNode *loop);
     void FinishLastLoopProcessing();
 private:
-    void CheckIncDecRules(ExprNode *expr, std::shared_ptr<Token> op);
+    void CheckIncDecRules(ExprNode *expr, Token op);
     bool isArithmeticType(SymType *type);
     bool isPointerType(SymType *type);
     bool isVoidPointer(SymType *type);
@@ -72,16 +84,19 @@ private:
     bool isConstQualified(ExprNode *expr);
     bool isStructType(SymType *type);
     bool isVoidType(SymType *type);
-    std::shared_ptr<Token> extractArithmeticOperationFromAssignmentBy(const std::shared_ptr<Token> &assignemtBy);
+    Token extractArithmeticOperationFromAssignmentBy(Token assignemtBy);
     void ImplicitlyConvert(ExprNode **left, ExprNode **right);
     void Convert(ExprNode **expr, SymType *type);
     bool equalQualifiers(SymType *one, SymType *other);
     void analyseInitializerList(SymType *current, InitializerNode *initializer, DesignatorNode *designator = nullptr);
     SymType *unqualify(SymType *type);
+    ExprNode *fold(ExprNode *expr);
     ScopeTree scopeTree;
     std::stack<SymFunction *> processingFunctions;
     std::stack<IterationStatementNode *> processingLoops;
     Evaluator evaluator;
+    bool foldConstants = false;
+    std::vector<std::pair<Position, SymRecord *>> definedRecords;
 };
 
 #endif //TINY_C_COMPILER_SEMANTIC_ANALYZER_H
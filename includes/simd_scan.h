@@ -0,0 +1,38 @@
+#ifndef TINY_C_COMPILER_SIMD_SCAN_H
+#define TINY_C_COMPILER_SIMD_SCAN_H
+
+#include <cstdint>
+
+// Kernels the buffer mode tokenizer uses to skip long runs of characters that would otherwise
+// take one automaton transition each. They look at 16 or 32 bytes at a time when the CPU allows it,
+// the implementation is picked once at startup and can be overridden with SelectSimdLevel.
+// Every kernel returns the first position in [p, end) that does not belong to the run.
+
+enum class SimdLevel
+{
+    SCALAR, SSE2, AVX2
+};
+
+// Line feeds met by a kernel, lineStart points right past the last one
+struct LineFeeds
+{
+    uint32_t count = 0;
+    const char *lineStart = nullptr;
+};
+
+SimdLevel DetectSimdLevel();
+SimdLevel ActiveSimdLevel();
+void SelectSimdLevel(SimdLevel level);
+const char *SimdLevelName(SimdLevel level);
+
+// bytes up to and including ' ', which is what the automaton treats as whitespace
+const char *SkipWhitespace(const char *p, const char *end, LineFeeds &lines);
+// [A-Za-z0-9_]
+const char *SkipIdentifier(const char *p, const char *end);
+// [0-9]
+const char *SkipDigits(const char *p, const char *end);
+const char *FindLineFeed(const char *p, const char *end);
+// next '*' or '/', the only characters that can open or close a comment
+const char *FindCommentMark(const char *p, const char *end, LineFeeds &lines);
+
+#endif //TINY_C_COMPILER_SIMD_SCAN_H
@@ -0,0 +1,31 @@
+#ifndef TINY_C_COMPILER_SOURCE_BUFFER_H
+#define TINY_C_COMPILER_SOURCE_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Whole source file in one contiguous block. The file is memory mapped when possible,
+// otherwise it is read in one shot. Pointers into the buffer stay valid until Close.
+class SourceBuffer
+{
+public:
+    SourceBuffer() = default;
+    SourceBuffer(const SourceBuffer &) = delete;
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+    ~SourceBuffer();
+
+    bool Open(const std::string &fileName);
+    void Close();
+    const char *Begin() const { return data; }
+    const char *End() const { return data + size; }
+    size_t Size() const { return size; }
+    bool IsMapped() const { return mapped; }
+private:
+    const char *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<char> storage;
+};
+
+#endif //TINY_C_COMPILER_SOURCE_BUFFER_H
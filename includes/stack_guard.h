@@ -0,0 +1,44 @@
+#ifndef TINY_C_COMPILER_STACK_GUARD_H
+#define TINY_C_COMPILER_STACK_GUARD_H
+
+#include <cstddef>
+#include <functional>
+
+// The parser and the tree walks recurse once per nesting level of the source. RunWithStack runs them
+// on a thread whose stack is as big as asked for, pages of it are only taken once touched,
+// and StackLeft lets them give up with an error instead of overflowing it. The parser stops at half
+// of the stack, which leaves the walks over what it built the other half.
+
+// what the tree walks keep free of the stack, enough for any one level of them to finish
+constexpr size_t StackReserve = 256 * 1024;
+
+// runs f on a thread with a stack of the given size and rethrows whatever it throws
+void RunWithStack(size_t bytes, const std::function<void()> &f);
+// runs f(0) to f(threads - 1) on as many threads with stacks of the given size, waits for all of them
+// and rethrows what the first of them threw
+void RunOnThreads(size_t bytes, unsigned threads, const std::function<void(unsigned)> &f);
+
+namespace StackGuard
+{
+    extern thread_local const char *low;
+    extern thread_local size_t size;
+    void find();
+}
+
+// bytes of the stack of this thread that are still free
+inline size_t StackLeft()
+{
+    if (!StackGuard::low)
+        StackGuard::find();
+    auto frame = (const char *)__builtin_frame_address(0);
+    return frame > StackGuard::low ? frame - StackGuard::low : 0;
+}
+
+inline size_t StackSize()
+{
+    if (!StackGuard::low)
+        StackGuard::find();
+    return StackGuard::size;
+}
+
+#endif //TINY_C_COMPILER_STACK_GUARD_H
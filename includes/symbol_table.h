@@ -5,22 +5,43 @@
 #ifndef TINY_C_COMPILER_SYMBOL_TABLE_H
 #define TINY_C_COMPILER_SYMBOL_TABLE_H
 
+#include <cstdint>
 #include <vector>
 #include <set>
 #include "symbols.h"
+#include "interner.h"
+#include "arena.h"
 
-class SymbolTable
+// Struct and enum tags live apart from ordinary identifiers
+enum class SymbolNamespace
+{
+    ORDINARY, STRUCT, ENUM
+};
+
+class SymbolTable: public ArenaObject
 {
 public:
-    Symbol *Find(std::string name) const;
-    void Insert(std::string name, Symbol *symbol);
-    SymbolTable *GetParent() const;
-    void SetParent(SymbolTable *parent);
-    void AddChild(SymbolTable *child);
+    // only the first visible names declared in the table are found
+    Symbol *Find(NameId name, SymbolNamespace ns = SymbolNamespace::ORDINARY, uint32_t visible = AllVisible) const;
+    void Insert(NameId name, Symbol *symbol, SymbolNamespace ns = SymbolNamespace::ORDINARY);
+    static constexpr uint32_t AllVisible = UINT32_MAX;
+    // how many names were declared so far, a function body that is parsed late must not see
+    // what the file declared after it
+    uint32_t Declared() const { return declared; }
+    // an order among the names for something that is not a new name, a structure defined after
+    // its declaration
+    uint32_t TakeOrder() { return declared++; }
 private:
-    std::unordered_map<std::string, Symbol *> table;
-    SymbolTable *parent = nullptr;
-    std::list<SymbolTable *> children;
+    friend class ScopeTree;
+    struct Entry
+    {
+        Symbol *symbol;
+        // when the name was declared first, a later definition keeps it
+        uint32_t order;
+    };
+    static uint64_t key(NameId name, SymbolNamespace ns) { return (uint64_t)ns << 32 | name; }
+    std::unordered_map<uint64_t, Entry> table;
+    uint32_t declared = 0;
 };
 
 #endif //TINY_C_COMPILER_SYMBOL_TABLE_H
@@ -48,17 +48,25 @@ public:
     virtual bool Equal(SymType *other) = 0;
     virtual bool IsComplete() = 0;
     bool IsQualified() const;
+    // made by TypeContext, refers to nothing that a compilation arena holds
+    bool IsCanonical() const;
     virtual SymType *GetUnqualified() = 0;
+    // Size and alignment follow the i386 System V ABI
     virtual int32_t Size() = 0;
+    virtual int32_t Align() = 0;
+    // bytes a value takes on the stack, which the ABI keeps aligned to 4
+    int32_t StackSize();
 protected:
+    friend class TypeContext;
     TypeKind kind;
     bool isQualified{false};
+    bool canonical{false};
 };
 
+// Made by TypeContext only, see type_context.h
 class SymQualifiedType: public SymType
 {
 public:
-    SymQualifiedType(SymType *type, uint32_t qualifiers);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
     bool Equal(SymType *other) override;
     bool IsComplete() override;
@@ -68,16 +76,18 @@ public:
     void SetQualifiers(uint32_t qualifiers);
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
+    friend class TypeContext;
+    SymQualifiedType(SymType *type, uint32_t qualifiers);
     SymType *type;
     uint32_t qualfiers{0};
 };
 
+// Made by TypeContext only, there is one object for every kind
 class SymBuiltInType: public SymType
 {
 public:
-    explicit SymBuiltInType (BuiltInTypeKind builtInTypeKind);
-    SymBuiltInType (BuiltInTypeKind builtInTypeKind, uint32_t typeQualifiers);
     BuiltInTypeKind GetBuiltInTypeKind() const;
     void SetBuiltIntTypeKind(BuiltInTypeKind typeKind);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
@@ -85,7 +95,10 @@ public:
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
+    friend class TypeContext;
+    explicit SymBuiltInType (BuiltInTypeKind builtInTypeKind);
     BuiltInTypeKind builtInTypeKind;
 };
 
@@ -100,6 +113,7 @@ public:
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
     SymType *target;
 };
@@ -118,10 +132,13 @@ public:
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
     int32_t NumberOfElements();
 private:
     SymType *valueType;
     ExprNode *size;
+    // the value of size, -1 without one
+    int32_t count{-1};
 };
 
 class SymbolTable;
@@ -147,9 +164,11 @@ public:
     void SetLabel(Asm::AsmFunction *label);
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
     int32_t AllocateVariable(int32_t varSize);
     int32_t GetLocalVariablesStorageSize() const;
     int32_t GetArgumentsStorageSize() const;
+    int32_t GetReturnObjectOffset() const;
     Asm::AsmLabel *GetReturnLabel() const;
     void SetReturnLabel(Asm::AsmLabel *label);
 private:
@@ -167,13 +186,14 @@ private:
 class SymAlias: public SymType
 {
 public:
-    SymAlias(std::string name, SymType *type);
+    SymAlias(NameId name, SymType *type);
     SymType *GetType();
     void Print(std::ostream &os, std::string indent, bool isTail) override;
     bool Equal(SymType *other) override;
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
     SymType *type;
 };
@@ -194,13 +214,26 @@ public:
     IdNode *GetTag() const;
     void SetTag(IdNode *tag);
     bool IsComplete() override;
+    // a structure declared before it is defined is completed when its file scope took the order
+    void SetCompletionOrder(uint32_t order);
+    // IsComplete on this thread sees only the structures completed before the first count names of
+    // the file scope, a function body that is parsed late must not see what the file completed after it
+    static void SetVisibleCompletions(uint32_t count);
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
+    // the offset, size and alignment of every field, padding included
+    void PrintLayout(std::ostream &os);
 private:
     void calculateFieldsOffset();
+    static thread_local uint32_t visibleCompletions;
     IdNode *tag{nullptr};
+    uint32_t completionOrder{0};
     SymbolTable *fields{nullptr};
     std::vector<SymVariable *> orderedFields;
+    // laid out once the fields are known, they are complete by then
+    int32_t size{0};
+    int32_t align{1};
 };
 
 class SymEnum: public SymType
@@ -214,6 +247,7 @@ public:
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
     IdNode *tag{nullptr};
     bool defined{false};
@@ -222,7 +256,7 @@ private:
 class SymEnumerator: public SymType
 {
 public:
-    SymEnumerator(std::string name, ExprNode *value);
+    SymEnumerator(NameId name, ExprNode *value);
     ExprNode *GetValue() const;
     void SetValue(ExprNode *value);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
@@ -230,8 +264,28 @@ public:
     bool IsComplete() override;
     SymType *GetUnqualified() override;
     int32_t Size() override;
+    int32_t Align() override;
 private:
     ExprNode *value{nullptr};
 };
 
+// Symbols that are not variables are types and the kind of a type tells its class, so these need no RTTI.
+// A qualified type copies the kind of the type it qualifies, hence the extra check for aliases.
+inline SymType *AsType(Symbol *symbol)
+{
+    return symbol && symbol->GetSymbolClass() != SymbolClass::VARIABLE ? static_cast<SymType *>(symbol) : nullptr;
+}
+
+inline SymAlias *AsAlias(Symbol *symbol)
+{
+    auto type = AsType(symbol);
+    return type && type->GetTypeKind() == TypeKind::TYPEDEF && !type->IsQualified() ?
+           static_cast<SymAlias *>(type) : nullptr;
+}
+
+inline SymBuiltInType *AsBuiltIn(SymType *type)
+{
+    return type->GetTypeKind() == TypeKind::BUILTIN && !type->IsQualified() ? static_cast<SymBuiltInType *>(type) : nullptr;
+}
+
 #endif //TINY_C_COMPILER_TYPE_H
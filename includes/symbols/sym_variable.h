@@ -14,7 +14,7 @@ class IdNode;
 class SymVariable: public Symbol
 {
 public:
-    SymVariable(std::string name, SymType *type, IdNode *id);
+    SymVariable(NameId name, SymType *type, IdNode *id);
     void Print(std::ostream &os, std::string indent, bool isTail) override;
     SymType *GetType() const;
     void SetType(SymType *type);
@@ -7,22 +7,26 @@
 
 #include <string>
 #include <ostream>
+#include "interner.h"
+#include "arena.h"
 
 enum class SymbolClass
 {
     TYPE, VARIABLE, UNDEFINED
 };
 
-class Symbol
+class Symbol: public ArenaObject
 {
 public:
-    void SetName(std::string name);
-    std::string GetName() const;
+    void SetName(NameId name);
+    void SetName(const std::string &name);
+    const std::string &GetName() const;
+    NameId GetNameId() const;
 //    void SetSymbolClass(SymbolClass class);
     SymbolClass GetSymbolClass() const;
     virtual void Print(std::ostream &os, std::string indent, bool isTail) = 0;
 protected:
-    std::string name;
+    NameId name{0};
     SymbolClass symbolClass{SymbolClass::UNDEFINED};
 };
 
@@ -0,0 +1,61 @@
+#ifndef TINY_C_COMPILER_TYPE_CONTEXT_H
+#define TINY_C_COMPILER_TYPE_CONTEXT_H
+
+#include <mutex>
+#include <unordered_map>
+#include "sym_type.h"
+#include "arena.h"
+
+// Hands out one canonical object for every built-in type and for every pointer and qualified type built
+// from them, so that the same type is the same pointer wherever it is used. Canonical types are never changed
+// after they are made and live in an arena of their own, which outlives every compilation. A pointer or
+// a qualified type over anything else (records, arrays, functions, typedef names, declarators that are still
+// being put together) lives in a compilation arena, so it is allocated there each time and never interned.
+// SetShared(true) makes every call take a lock, like Interner.
+class TypeContext
+{
+public:
+    TypeContext();
+    SymBuiltInType *BuiltIn(BuiltInTypeKind kind) const { return builtIns[(size_t)kind]; }
+    SymPointer *Pointer(SymType *target);
+    SymQualifiedType *Qualified(SymType *type, uint32_t qualifiers);
+    size_t Size() const { return BuiltInCount + pointers.size() + qualified.size(); }
+    uint64_t BytesAllocated() const { return arena.BytesAllocated(); }
+    void SetShared(bool shared) { this->shared = shared; }
+private:
+    static constexpr size_t BuiltInCount = (size_t)BuiltInTypeKind::NONE;
+    struct QualifiedKey
+    {
+        SymType *type;
+        uint32_t qualifiers;
+        bool operator==(const QualifiedKey &other) const
+        {
+            return type == other.type && qualifiers == other.qualifiers;
+        }
+    };
+    struct QualifiedKeyHash
+    {
+        size_t operator()(const QualifiedKey &key) const
+        {
+            return std::hash<SymType *>()(key.type) * 31 + key.qualifiers;
+        }
+    };
+    template<typename T, typename... Args>
+    T *make(Args... args)
+    {
+        auto type = ::new (arena.Allocate(sizeof(T), alignof(T))) T(args...);
+        type->canonical = true;
+        arena.Track(type);
+        return type;
+    }
+    Arena arena;
+    SymBuiltInType *builtIns[BuiltInCount];
+    std::unordered_map<SymType *, SymPointer *> pointers;
+    std::unordered_map<QualifiedKey, SymQualifiedType *, QualifiedKeyHash> qualified;
+    bool shared = false;
+    std::mutex mutex;
+};
+
+extern TypeContext Types;
+
+#endif //TINY_C_COMPILER_TYPE_CONTEXT_H
@@ -6,10 +6,18 @@
 #define TINY_C_COMPILER_TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include "interner.h"
+#include "source_buffer.h"
 
-enum class TokenType
+// One byte, so that TokenArena keeps the types, and a token cache entry stores them, in a byte per token
+enum class TokenType : uint8_t
 {
     ID, NUM_INT, NUM_FLOAT,
     LBRACKET, RBRACKET, LCURLY_BRACKET, RCURLY_BRACKET, LSQUARE_BRACKET, RSQUARE_BRACKET,
@@ -31,98 +39,86 @@ enum class Keyword
     PRINTF
 };
 
-static std::unordered_map<TokenType, std::string> TokenTypeToString(
+// Indexed by TokenType. LOBIC_OR is a misspelling, but it is what -t has always printed.
+constexpr std::string_view TokenTypeNames[] =
 {
-    {TokenType::ASSIGNMENT_BY_BITWISE_RSHIFT, "ASSIGNMENT_BY_BITWISE_RSHIFT"},
-    {TokenType::ASSIGNMENT_BY_BITWISE_LSHIFT, "ASSIGNMENT_BY_BITWISE_LSHIFT"},
-    {TokenType::ASSIGNMENT_BY_BITWISE_XOR, "ASSIGNMENT_BY_BITWISE_XOR"},
-    {TokenType::ASSIGNMENT_BY_BITWISE_AND, "ASSIGNMENT_BY_BITWISE_AND"},
-    {TokenType::ASSIGNMENT_BY_DIFFERENCE, "ASSIGNMENT_BY_DIFFERENCE"},
-    {TokenType::ASSIGNMENT_BY_BITWISE_OR, "ASSIGNMENT_BY_BITWISE_OR"},
-    {TokenType::ASSIGNMENT_BY_QUOTIENT, "ASSIGNMENT_BY_QUOTIENT"},
-    {TokenType::ASSIGNMENT_BY_REMINDER, "ASSIGNMENT_BY_REMINDER"},
-    {TokenType::ASSIGNMENT_BY_PRODUCT, "ASSIGNMENT_BY_PRODUCT"},
-    {TokenType::ASSIGNMENT_BY_SUM, "ASSIGNMENT_BY_SUM"},
-    {TokenType::LSQUARE_BRACKET, "LSQUARE_BRACKET"},
-    {TokenType::RSQUARE_BRACKET, "RSQUARE_BRACKET"},
-    {TokenType::LCURLY_BRACKET, "LCURLY_BRACKET"},
-    {TokenType::RCURLY_BRACKET, "RCURLY_BRACKET"},
-    {TokenType::BITWISE_LSHIFT, "BITWISE_LSHIFT"},
-    {TokenType::BITWISE_RSHIFT, "BITWISE_RSHIFT"},
-    {TokenType::QUESTION_MARK, "QUESTION_MARK"},
-    {TokenType::FORWARD_SLASH, "FORWARD_SLASH"},
-    {TokenType::DOUBLE_MINUS, "DOUBLE_MINUS"},
-    {TokenType::BITWISE_NOT, "BITWISE_NOT"},
-    {TokenType::DOUBLE_PLUS, "DOUBLE_PLUS"},
-    {TokenType::BITWISE_AND, "BITWISE_AND"},
-    {TokenType::BITWISE_XOR, "BITWISE_XOR"},
-    {TokenType::ASSIGNMENT, "ASSIGNMENT"},
-    {TokenType::BITWISE_OR, "BITWISE_OR"},
-    {TokenType::BACK_SLASH, "BACK_SLASH"},
-    {TokenType::NUM_FLOAT, "NUM_FLOAT"},
-    {TokenType::SEMICOLON, "SEMICOLON"},
-    {TokenType::LOGIC_AND, "LOGIC_AND"},
-    {TokenType::CHARACTER, "CHARACTER"},
-    {TokenType::LOGIC_OR, "LOBIC_OR"},
-    {TokenType::LBRACKET, "LBRACKET"},
-    {TokenType::RBRACKET, "RBRACKET"},
-    {TokenType::RELOP_EQ, "RELOP_EQ"},
-    {TokenType::RELOP_GT, "RELOP_GT"},
-    {TokenType::RELOP_LT, "RELOP_LT"},
-    {TokenType::RELOP_GE, "RELOP_GE"},
-    {TokenType::RELOP_LE, "RELOP_LE"},
-    {TokenType::RELOP_NE, "RELOP_NE"},
-    {TokenType::LOGIC_NO, "LOGIC_NO"},
-    {TokenType::REMINDER, "REMINDER"},
-    {TokenType::NUM_INT, "NUM_INT"},
-    {TokenType::ASTERIX, "ASTERIX"},
-    {TokenType::KEYWORD, "KEYWORD"},
-    {TokenType::STRING, "STRING"},
-    {TokenType::COMMA, "COMMA"},
-    {TokenType::MINUS, "MINUS"},
-    {TokenType::COLON, "COLON"},
-    {TokenType::ARROW, "ARROW"},
-    {TokenType::PLUS, "PLUS"},
-    {TokenType::DOT, "DOT"},
-    {TokenType::ID, "ID"}
-});
-
-static std::unordered_map<std::string, Keyword> StringToKeyword
+    "ID", "NUM_INT", "NUM_FLOAT", "LBRACKET", "RBRACKET", "LCURLY_BRACKET", "RCURLY_BRACKET", "LSQUARE_BRACKET",
+    "RSQUARE_BRACKET", "SEMICOLON", "COLON", "DOT", "QUESTION_MARK", "COMMA", "RELOP_EQ", "RELOP_GT",
+    "RELOP_LT", "RELOP_GE", "RELOP_LE", "RELOP_NE", "ASSIGNMENT", "BITWISE_NOT", "REMINDER", "BITWISE_LSHIFT",
+    "BITWISE_RSHIFT", "BITWISE_OR", "BITWISE_XOR", "BITWISE_AND", "LOGIC_NO", "LOBIC_OR", "LOGIC_AND", "MINUS",
+    "PLUS", "ASTERIX", "DOUBLE_PLUS", "DOUBLE_MINUS", "ASSIGNMENT_BY_SUM", "ASSIGNMENT_BY_DIFFERENCE",
+    "ASSIGNMENT_BY_PRODUCT", "ASSIGNMENT_BY_QUOTIENT", "ASSIGNMENT_BY_REMINDER", "ASSIGNMENT_BY_BITWISE_OR",
+    "ASSIGNMENT_BY_BITWISE_XOR", "ASSIGNMENT_BY_BITWISE_AND", "ASSIGNMENT_BY_BITWISE_LSHIFT",
+    "ASSIGNMENT_BY_BITWISE_RSHIFT", "BACK_SLASH", "FORWARD_SLASH", "ARROW", "KEYWORD", "CHARACTER", "STRING",
+    ""
+};
+
+static_assert(sizeof(TokenTypeNames) / sizeof(TokenTypeNames[0]) == (size_t)TokenType::END_OF_FILE + 1,
+              "TokenTypeNames is out of sync with TokenType");
+
+constexpr std::string_view TokenTypeName(TokenType type)
 {
-    {"register", Keyword::REGISTER},
-    {"volatile", Keyword::VOLATILE},
-    {"continue", Keyword::CONTINUE},
-    {"unsigned", Keyword::UNSIGNED},
-    {"default", Keyword::DEFAULT},
-    {"typedef", Keyword::TYPEDEF},
-    {"printf", Keyword::PRINTF},
-    {"return", Keyword::RETURN},
-    {"signed", Keyword::SIGNED},
-    {"sizeof", Keyword::SIZEOF},
-    {"static", Keyword::STATIC},
-    {"struct", Keyword::STRUCT},
-    {"double", Keyword::DOUBLE},
-    {"extern", Keyword::EXTERN},
-    {"const", Keyword::CONST},
-    {"while", Keyword::WHILE},
-    {"break", Keyword::BREAK},
-    {"float", Keyword::FLOAT},
-    {"short", Keyword::SHORT},
-    {"union", Keyword::UNION},
-    {"case", Keyword::CASE},
-    {"char", Keyword::CHAR},
-    {"else", Keyword::ELSE},
-    {"enum", Keyword::ENUM},
-    {"goto", Keyword::GOTO},
-    {"long", Keyword::LONG},
-    {"void", Keyword::VOID},
-    {"for", Keyword::FOR},
-    {"int", Keyword::INT},
-    {"if", Keyword::IF},
-    {"do", Keyword::DO},
+    return TokenTypeNames[(size_t)type];
+}
 
+struct KeywordEntry
+{
+    std::string_view text;
+    Keyword keyword;
 };
 
+constexpr KeywordEntry KeywordList[] =
+{
+    {"break", Keyword::BREAK}, {"case", Keyword::CASE}, {"char", Keyword::CHAR}, {"const", Keyword::CONST},
+    {"continue", Keyword::CONTINUE}, {"default", Keyword::DEFAULT}, {"do", Keyword::DO},
+    {"double", Keyword::DOUBLE}, {"else", Keyword::ELSE}, {"enum", Keyword::ENUM}, {"extern", Keyword::EXTERN},
+    {"float", Keyword::FLOAT}, {"for", Keyword::FOR}, {"goto", Keyword::GOTO}, {"if", Keyword::IF},
+    {"int", Keyword::INT}, {"long", Keyword::LONG}, {"register", Keyword::REGISTER}, {"return", Keyword::RETURN},
+    {"short", Keyword::SHORT}, {"signed", Keyword::SIGNED}, {"sizeof", Keyword::SIZEOF},
+    {"static", Keyword::STATIC}, {"struct", Keyword::STRUCT}, {"typedef", Keyword::TYPEDEF},
+    {"union", Keyword::UNION}, {"unsigned", Keyword::UNSIGNED}, {"void", Keyword::VOID},
+    {"volatile", Keyword::VOLATILE}, {"while", Keyword::WHILE}, {"printf", Keyword::PRINTF}
+};
+
+constexpr size_t MinKeywordLength = 2, MaxKeywordLength = 8;
+
+// Perfect hash over KeywordList, the coefficients were found by brute force
+constexpr uint32_t KeywordHash(std::string_view s)
+{
+    return ((uint8_t)s[0] * 10u + (uint8_t)s[1] * 6u + (uint8_t)s.back() + (uint32_t)s.length() * 12u) & 63u;
+}
+
+struct KeywordHashTable
+{
+    KeywordEntry slots[64];
+    bool perfect;
+};
+
+constexpr KeywordHashTable buildKeywordHashTable()
+{
+    KeywordHashTable table{};
+    table.perfect = true;
+    for (auto &entry: KeywordList)
+    {
+        auto &slot = table.slots[KeywordHash(entry.text)];
+        if (!slot.text.empty()) table.perfect = false;
+        slot = entry;
+    }
+    return table;
+}
+
+constexpr KeywordHashTable KeywordTable = buildKeywordHashTable();
+static_assert(KeywordTable.perfect, "KeywordHash has collisions, pick new coefficients");
+
+inline bool LookupKeyword(std::string_view text, Keyword &keyword)
+{
+    if (text.length() < MinKeywordLength || text.length() > MaxKeywordLength) return false;
+    auto &slot = KeywordTable.slots[KeywordHash(text)];
+    if (slot.text != text) return false;
+    keyword = slot.keyword;
+    return true;
+}
+
 struct Position
 {
     Position(int row, int col): row(row), col(col) {}
@@ -132,23 +128,124 @@ struct Position
     int row, col;
 };
 
-struct Token
+union TokenValue
+{
+    int64_t intValue;
+    long double floatValue;
+    Keyword keyword;
+    NameId nameId;
+};
+
+// Storage for every token of a translation unit, kept as parallel arrays and addressed by index.
+// Text of lexed tokens is a view into the source buffer, tokens that have no source text
+// (read from a stream or made up by the semantic analyzer) keep their own copy.
+// The active arena is per thread, so that chunks of a file can be lexed concurrently.
+// Threads that parse parts of a file together share its arena and make up their tokens in shards of it.
+// An arena filled from a token cache entry reads the types and offsets from the mapped entry, and copies them
+// only if tokens are added to it or changed, tokens made up afterwards go to a shard.
+class TokenArena
 {
-    TokenType type;
-    Position position;
-    std::string text;
-    union
+public:
+    static TokenArena *Active() { return active; }
+    void Activate() { active = this; }
+    void Reset(const char *source = nullptr);
+    // for when the source moved, the offsets of the tokens stay the same
+    void SetSource(const char *source) { this->source = source; }
+    void Reserve(size_t count);
+    uint32_t Add(TokenType type, Position position, uint32_t offset, uint32_t length);
+    uint32_t Add(TokenType type, Position position, std::string text);
+    // a token that is not in the source, in the shard of this thread if it uses one
+    uint32_t Make(TokenType type, Position position, std::string text);
+    // adds count shards and gives the first of them, they go on Reset
+    unsigned AddShards(unsigned count);
+    // the thread makes its tokens in the given shard from now on, -1 for the arena itself
+    static void UseShard(int shard) { threadShard = shard; }
+    // appends count tokens of another arena starting from first, moving them rowShift rows down.
+    // offsetShift moves them in the source, for when the other arena was lexed from an earlier version of it
+    void Append(const TokenArena &other, uint32_t first, uint32_t count, int rowShift, int64_t offsetShift = 0);
+    // drops every token from count on
+    void Truncate(uint32_t count);
+    uint32_t Size() const { return (uint32_t)positions.size(); }
+
+    TokenType Type(uint32_t i) const { return i & InShard ? shardOf(i).Type(i & ShardIndex) : typeView[i]; }
+    void SetType(uint32_t i, TokenType type)
+    {
+        if (i & InShard)
+            shardOf(i).SetType(i & ShardIndex, type);
+        else
+        {
+            own();
+            types[i] = type;
+        }
+    }
+    Position GetPosition(uint32_t i) const
+    {
+        return i & InShard ? shardOf(i).GetPosition(i & ShardIndex) : positions[i];
+    }
+    TokenValue &Value(uint32_t i) { return i & InShard ? shardOf(i).Value(i & ShardIndex) : values[i]; }
+    std::string_view Text(uint32_t i) const
     {
-        char *stringValue;
-        int64_t intValue;
-        long double floatValue;
-        Keyword keyword;
-    };
-    Token(TokenType type, int row, int col, std::string text): type(type), text(std::move(text))
+        if (i & InShard)
+            return shardOf(i).Text(i & ShardIndex);
+        return offsetView[i] & OwnedText ? std::string_view(ownedTexts[offsetView[i] & ~OwnedText])
+                                         : std::string_view(source + offsetView[i], lengths[i]);
+    }
+private:
+    friend class TokenCache;
+    static const uint32_t OwnedText = 1u << 31;
+    // index of a token made in a shard: the flag, 7 bits of the shard and 24 of the token in it
+    static const uint32_t InShard = 1u << 31;
+    static const uint32_t ShardShift = 24;
+    static const uint32_t ShardIndex = (1u << ShardShift) - 1;
+    static const unsigned MaxShards = 1u << 7;
+    static thread_local TokenArena *active;
+    static thread_local int threadShard;
+    TokenArena &shardOf(uint32_t i) const { return *shards[(i & ~InShard) >> ShardShift]; }
+    // reads the arrays from entry, which is kept until Reset
+    void borrow(std::unique_ptr<SourceBuffer> entry, const TokenType *types, const uint32_t *offsets);
+    // copies borrowed arrays into the vectors, before they change
+    void own() { if (borrowed) copyBorrowed(); }
+    void copyBorrowed();
+    // points the views at the vectors
+    void view();
+    const char *source = nullptr;
+    // what the accessors read, the vectors below or the arrays of a borrowed entry
+    const TokenType *typeView = nullptr;
+    const uint32_t *offsetView = nullptr;
+    std::unique_ptr<SourceBuffer> borrowed;
+    // the shard of the tokens made up over borrowed arrays, -1 when there is none
+    int madeShard = -1;
+    std::vector<TokenType> types;
+    std::vector<Position> positions;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<TokenValue> values;
+    std::deque<std::string> ownedTexts;
+    std::vector<std::unique_ptr<TokenArena>> shards;
+};
+
+// 32-bit handle of a token in the active TokenArena
+class Token
+{
+public:
+    Token() = default;
+    explicit Token(uint32_t index): index(index) {}
+    static Token Create(TokenType type, int row, int col, std::string text)
     {
-        position.row = row;
-        position.col = col;
+        return Token(TokenArena::Active()->Make(type, Position(row, col), std::move(text)));
     }
+
+    uint32_t Index() const { return index; }
+    TokenType GetType() const { return TokenArena::Active()->Type(index); }
+    Position GetPosition() const { return TokenArena::Active()->GetPosition(index); }
+    std::string_view GetText() const { return TokenArena::Active()->Text(index); }
+    int64_t GetIntValue() const { return TokenArena::Active()->Value(index).intValue; }
+    long double GetFloatValue() const { return TokenArena::Active()->Value(index).floatValue; }
+    Keyword GetKeyword() const { return TokenArena::Active()->Value(index).keyword; }
+    NameId GetNameId() const { return TokenArena::Active()->Value(index).nameId; }
+    void SetIntValue(int64_t value) { TokenArena::Active()->Value(index).intValue = value; }
+private:
+    uint32_t index = 0;
 };
 
 #endif //TINY_C_COMPILER_TOKEN_H
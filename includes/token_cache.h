@@ -0,0 +1,49 @@
+#ifndef TINY_C_COMPILER_TOKEN_CACHE_H
+#define TINY_C_COMPILER_TOKEN_CACHE_H
+
+#include "token.h"
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+struct TokenCacheStats
+{
+    uint64_t hits = 0;
+    // misses counts rejected entries as well
+    uint64_t misses = 0;
+    uint64_t rejected = 0;
+    uint64_t stores = 0;
+    uint64_t evictions = 0;
+};
+
+// Directory of lexed token streams, one file per source keyed by a hash of its contents and of the lexer.
+// A file holds the length and a 128 bit hash of the source, which must match for the entry to be used,
+// the offsets and types as they are in a TokenArena, which reads them from the mapped file, a byte of length
+// per token, and side tables, in token order, of what takes more room: the values of the tokens that have one
+// (identifiers as the index of their first occurrence in the source, interned again on load, keywords,
+// integers and floats), longer lengths, and the positions that the offsets do not give.
+// The format is that of the machine that wrote it.
+// When the files take more than maxBytes, the least recently used ones are removed.
+class TokenCache
+{
+public:
+    static const uint32_t Version = 3;
+
+    TokenCache(std::string directory, uint64_t maxBytes);
+
+    // Fills tokens, which are over source, from the cache, returns false when the source is not there
+    bool Load(std::string_view source, TokenArena &tokens);
+    void Store(std::string_view source, const TokenArena &tokens);
+    const TokenCacheStats &Stats() const { return stats; }
+private:
+    std::string directory;
+    uint64_t maxBytes;
+    TokenCacheStats stats;
+    std::string entryPath(uint64_t hash) const;
+    // removes an entry that does not hold for the source and empties tokens, returns false
+    bool reject(const std::string &path, TokenArena &tokens, std::string_view source);
+    void evict();
+};
+
+#endif //TINY_C_COMPILER_TOKEN_CACHE_H
@@ -0,0 +1,52 @@
+#ifndef TINY_C_COMPILER_TOKEN_WRITER_H
+#define TINY_C_COMPILER_TOKEN_WRITER_H
+
+#include "token.h"
+
+#include <cstdio>
+#include <string_view>
+
+enum class TokenDumpFormat
+{
+    TEXT, BINARY
+};
+
+// Writes the -t token dump through one large buffer instead of a printf per token.
+// The binary format is for tools: the magic "TCCT", a little endian uint32 version, then one record per
+// token: uint8 type, uint32 row, uint32 col, uint32 text length, the text, and for NUM_INT and CHARACTER
+// an int64 value, for NUM_FLOAT a double, for KEYWORD an uint8 keyword. The last record is END_OF_FILE.
+// When lexing fails the records stop before END_OF_FILE, tcc prints the error to stderr and exits with 1.
+class TokenWriter
+{
+public:
+    static const uint32_t BinaryVersion = 1;
+
+    TokenWriter(FILE *out, TokenDumpFormat format);
+    TokenWriter(const TokenWriter &) = delete;
+    TokenWriter &operator=(const TokenWriter &) = delete;
+    ~TokenWriter();
+
+    void WriteHeader();
+    void Write(Token token);
+    void Flush();
+private:
+    static const size_t BufferSize = 1 << 20;
+    // longest record that is not made of source text: a float value or position numbers
+    static const size_t MaxFixedPart = 256;
+
+    void writeText(Token token);
+    void writeBinary(Token token);
+    void reserve(size_t size);
+    void put(std::string_view s);
+    void put(char c) { *end++ = c; }
+    void putDecimal(uint64_t value);
+    void putSigned(int64_t value);
+    template<typename T> void putRaw(T value);
+
+    FILE *out;
+    TokenDumpFormat format;
+    char *buffer;
+    char *end;
+};
+
+#endif //TINY_C_COMPILER_TOKEN_WRITER_H
@@ -8,6 +8,10 @@
 #include "errors/tcc_exceptions.h"
 #include "dfa.h"
 #include "token.h"
+#include "source_buffer.h"
+#include "simd_scan.h"
+#include "literals.h"
+#include "token_cache.h"
 
 #include <fstream>
 #include <vector>
@@ -17,44 +21,113 @@
 #include <iostream>
 #include <utility>
 #include <memory>
+#include <exception>
 
-static std::unordered_set<std::string> Keywords =
+enum class InputMode
 {
-    "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum",
-    "extern", "float", "for", "goto", "if", "int", "long", "register", "return", "short",
-    "signed", "sizeof", "static", "struct", "typedef", "union", "unsigned", "void", "volatile", "while",
-    "printf"
+    STREAM, BUFFER
+};
+
+// Where lexing of a source line starts: tokens never span lines, so the automaton is either
+// in its initial state or inside a multiline comment nesting levels deep
+struct LineState
+{
+    uint32_t offset;
+    uint32_t firstToken;
+    int state;
+    int nesting;
+};
+
+// Tokens [first, oldEnd) of the previous token stream were replaced with [first, newEnd),
+// the tokens after them are the old ones moved by newEnd - oldEnd
+struct TokenEdit
+{
+    uint32_t first, oldEnd, newEnd;
 };
 
 class Tokenizer
 {
 public:
     Tokenizer() {}
-    Tokenizer(std::string fileName);
+    Tokenizer(std::string fileName, InputMode mode = InputMode::STREAM);
 
-    std::vector<Token *> Tokenize(std::string fileName);
-    std::shared_ptr<Token> Next();
-    std::shared_ptr<Token> Current();
-    std::shared_ptr<Token> Peek();
-    void OpenFile(std::string fileName);
+    // Lexes the whole file into the token arena in one pass. Next, Peek and LookAhead then walk that array,
+    // a lexical error is raised only when Next reaches the token that failed, as it would be without batching.
+    // In buffer mode big files are split into chunks that are lexed on up to threads threads.
+    const TokenArena &Tokenize(std::string fileName, InputMode mode = InputMode::BUFFER, unsigned threads = 1);
+    // Tokenize for text that is kept in memory, like an editor buffer. The state at every line start is
+    // recorded, so that Relex can lex an edit of the text without going over all of it again.
+    const TokenArena &TokenizeText(std::string_view text);
+    // Replaces removed characters from offset on with inserted and updates the tokens of the last TokenizeText.
+    // Lexing starts at the last line before the edit and stops at the first line after it
+    // where the state matches the one recorded before, the rest of the tokens are reused.
+    // Only after TokenizeText, otherwise it throws std::logic_error.
+    TokenEdit Relex(size_t offset, size_t removed, std::string_view inserted);
+    Token Next();
+    Token Current();
+    Token Peek();
+    // LookAhead(0) is Current and LookAhead(1) is Peek, farther tokens are only available after Tokenize,
+    // in stream mode asking for them throws std::logic_error
+    Token LookAhead(uint32_t distance);
+    // Makes a token that was already passed Current again, so that a part of the file can be parsed later.
+    // Only after Tokenize or TokenizeText, when all the tokens are kept.
+    void Seek(Token token);
+    bool Batched() const { return batched; }
+    // Walks the tokens of another tokenizer that went through Tokenize, so that parts of its file can be parsed
+    // on the calling thread. The other one has to stay as it is for as long as this one is used.
+    void Follow(Tokenizer &other);
+    void OpenFile(std::string fileName, InputMode mode = InputMode::STREAM);
+    // Tokenize in buffer mode takes tokens from the cache when it has the file and stores them otherwise
+    void SetTokenCache(TokenCache *cache) { tokenCache = cache; }
 private:
     int currentState = 0;
     char currentCharacter = 0;
     int prevRowCol = 0;
     Position currentPos{1, 1};
     Position currentlyProcessingTokenPos;
-    std::shared_ptr<Token> currentToken;
-    std::shared_ptr<Token> nextToken;
+    Token currentToken;
+    Token nextToken;
+    InputMode inputMode = InputMode::STREAM;
     std::ifstream currentFile;
+    SourceBuffer source;
+    TokenCache *tokenCache = nullptr;
+    TokenArena tokens;
+    const char *sourceBegin = nullptr;
+    const char *cursor = nullptr;
+    const char *sourceEnd = nullptr;
     std::string buffer;
-    std::shared_ptr<Token> getToken();
+    std::vector<char> sourceText;
+    bool trackLines = false;
+    std::vector<LineState> lineStates;
+    // kept between calls to Relex to reuse their memory
+    std::vector<char> editBuffer;
+    TokenArena relexTokens;
+    std::vector<LineState> relexLines;
+    bool internIdentifiers = true;
+    bool unterminatedComment = false;
+    bool batched = false;
+    uint32_t batchSize = 0;
+    std::exception_ptr deferredError;
+    void reset();
+    void openSource(std::string fileName, InputMode mode);
+    void lexToEnd();
+    void lexChunk(const char *fileBegin, const char *begin, const char *end);
+    void tokenizeParallel(unsigned threads);
+    Token lex();
+    Token batchToken(uint32_t i);
+    Token getToken();
+    Token scanBuffer();
+    void setTokenValue(uint32_t i, TokenType type, std::string_view text);
     bool processNewState(int state);
     void parseMultilineComment();
     void parseComment();
+    void advancePos(const char *from, const LineFeeds &lines);
+    void recordLines(const char *from, int nesting);
+    void startBatch();
+    void skipMultilineComment(int nesting = 1);
+    void skipComment();
     void error(int state);
-    char toChar();
-    char *toString();
-    char toEscape(char c);
+    char toChar(std::string_view text);
 };
 
 #endif //TINY_C_COMPILER_TOKENIZER_H
@@ -1,59 +1,167 @@
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <sys/resource.h>
 #include <tokenizer.h>
 #include <parser.h>
+#include <token_writer.h>
+#include <stack_guard.h>
+#include <symbols/type_context.h>
 #include "includes/args.hxx"
 
 args::ArgumentParser argParser("This is tcc - Tiny C Compiler", "");
 args::HelpFlag help(argParser, "help", "Display this menu", {'h', "help"});
 args::Flag parseOnly(argParser, "parse-only", "Parse only", {'p', "parse-only"});
 args::Flag tokenizeOnly(argParser, "tokenize-only", "Tokenize only", {'t', "tokenize-only"});
+args::Flag binaryTokens(argParser, "binary-tokens", "Dump tokens in the binary format, see token_writer.h",
+                        {"binary-tokens"});
+args::Flag mappedInput(argParser, "mmap", "Map the whole source file into memory before lexing", {'m', "mmap"});
+args::ValueFlag<unsigned> lexThreads(argParser, "threads", "Lex big files on this many threads, implies --mmap",
+                                     {'j', "lex-threads"});
+args::ValueFlag<std::string> tokenCacheDir(argParser, "dir", "Reuse tokens of unchanged sources kept in this directory, "
+                                           "implies --mmap", {"token-cache"});
+args::ValueFlag<unsigned> tokenCacheSize(argParser, "MB", "Size limit of the token cache, 256 MB by default",
+                                         {"token-cache-size"});
+args::Flag tokenCacheStats(argParser, "token-cache-stats", "Print token cache hits and misses to stderr",
+                           {"token-cache-stats"});
+args::Flag memStats(argParser, "mem-stats", "Print compilation arena usage and peak memory to stderr", {"mem-stats"});
+args::ValueFlag<unsigned> stackSize(argParser, "MB", "Stack of the compiling thread, bounds how deep the source "
+                                    "may nest, 256 MB by default", {"stack-size"});
+args::Flag lazyBodies(argParser, "lazy-bodies", "Skip function bodies while parsing: -p prints the declarations only, "
+                      "compiling parses every body right before its code is generated", {"lazy-bodies"});
+args::ValueFlag<unsigned> parseThreads(argParser, "threads", "Parse function bodies on this many threads once "
+                                       "the declarations of the file are known", {"parse-threads"});
+args::Flag dumpLayout(argParser, "dump-layout", "Print the size, alignment and field offsets of every structure "
+                      "to stderr", {"dump-layout"});
+args::Flag lexBench(argParser, "lex-bench", "Compare lexing speed of stream and buffer input", {"lex-bench"});
 args::Positional<std::string> sourceFile(argParser, "source file(s)", "The id(s) of source file(s)");
 
+InputMode SelectedInputMode()
+{
+    return mappedInput || lexThreads || tokenCacheDir ? InputMode::BUFFER : InputMode::STREAM;
+}
+
+TokenCache *SelectedTokenCache()
+{
+    static TokenCache *cache = nullptr;
+    if (!cache && tokenCacheDir)
+        cache = new TokenCache(tokenCacheDir.Get(), (tokenCacheSize ? tokenCacheSize.Get() : 256) * (1ull << 20));
+    return cache;
+}
+
+void PrintTokenCacheStats()
+{
+    if (!tokenCacheStats || !SelectedTokenCache())
+        return;
+    auto &stats = SelectedTokenCache()->Stats();
+    fprintf(stderr, "token cache: %llu hits, %llu misses (%llu rejected), %llu stores, %llu evictions\n",
+            (unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.rejected,
+            (unsigned long long)stats.stores, (unsigned long long)stats.evictions);
+}
+
 void TokenizeOnly()
 {
     Tokenizer tok;
-    printf("Position\t\tType\t\t\tValue\t\t\tText\n\n");
-    tok.OpenFile(sourceFile.Get());
-    std::shared_ptr<Token> t;
-    while ((t = tok.Next())->type != TokenType::END_OF_FILE)
+    tok.SetTokenCache(SelectedTokenCache());
+    TokenWriter writer(stdout, binaryTokens ? TokenDumpFormat::BINARY : TokenDumpFormat::TEXT);
+    writer.WriteHeader();
+    tok.Tokenize(sourceFile.Get(), SelectedInputMode(), lexThreads ? lexThreads.Get() : 1);
+    Token t;
+    while ((t = tok.Next()).GetType() != TokenType::END_OF_FILE)
+        writer.Write(t);
+    if (binaryTokens)
+        writer.Write(t);
+}
+
+static void lexBenchRun(InputMode mode, const char *name)
+{
+    const int runs = 5;
+    uint64_t tokens = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++)
     {
-        auto pos = t->position;
-        switch (t->type)
+        Tokenizer tok(sourceFile.Get(), mode);
+        while (tok.Next().GetType() != TokenType::END_OF_FILE)
+            tokens++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%s\t%llu tokens\t%.3f s\t%.0f tokens/s\n", name,
+           (unsigned long long)tokens / runs, elapsed.count() / runs, tokens / elapsed.count());
+}
+
+void LexBench()
+{
+    lexBenchRun(InputMode::STREAM, "stream");
+    auto detected = DetectSimdLevel();
+    for (auto level: {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        if (level > detected)
+            break;
+        SelectSimdLevel(level);
+        lexBenchRun(InputMode::BUFFER, (std::string("buffer/") + SimdLevelName(level)).c_str());
+    }
+    SelectSimdLevel(detected);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= cores; threads = threads < cores && threads * 2 > cores ? cores : threads * 2)
+    {
+        const int runs = 5;
+        uint64_t tokens = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; i++)
         {
-            case TokenType::NUM_INT:case TokenType::CHARACTER:
-                printf("(%d, %d)\t\t\t%s\t\t\t%llu\t\t\t\t  %s\n", pos.row, pos.col,
-                       TokenTypeToString[t->type].c_str(), t->intValue,t->text.c_str());
-                break;
-            case TokenType::NUM_FLOAT:
-                printf("(%d, %d)\t\t\t%s\t\t\t%llf\t\t\t\t  %s\n", pos.row,
-                       pos.col, TokenTypeToString[t->type].c_str(), t->floatValue, t->text.c_str());
-                break;
-            case TokenType::KEYWORD:
-                printf("(%d, %d)\t\t\t%s\t\t\t%d\t\t\t\t  %s\n", pos.row, pos.col,
-                       TokenTypeToString[t->type].c_str(), (int)t->keyword,t->text.c_str());
-                break;
-            default:
-                printf("(%d, %d)\t\t\t%s\t\t\t%s\t\t\t\t  %s\n", pos.row, pos.col,
-                       TokenTypeToString[t->type].c_str(), t->text.c_str(),t->text.c_str());
+            Tokenizer tok;
+            tokens += tok.Tokenize(sourceFile.Get(), InputMode::BUFFER, threads).Size() - 1;
         }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        printf("batch/%u\t%llu tokens\t%.3f s\t%.0f tokens/s\n", threads,
+               (unsigned long long)tokens / runs, elapsed.count() / runs, tokens / elapsed.count());
     }
+}
+
+void PrintMemStats()
+{
+    if (!memStats)
+        return;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "arena: %llu allocations, %llu bytes in %zu blocks of %llu bytes reserved, peak rss %ld KB\n",
+            (unsigned long long)CompilationArena.Allocations(), (unsigned long long)CompilationArena.BytesAllocated(),
+            CompilationArena.Blocks(), (unsigned long long)CompilationArena.BytesReserved(), usage.ru_maxrss);
+    fprintf(stderr, "types: %zu canonical in %llu bytes\n", Types.Size(), (unsigned long long)Types.BytesAllocated());
+}
 
+Tokenizer *TokenizeSource()
+{
+    auto *tokenizer = new Tokenizer();
+    tokenizer->SetTokenCache(SelectedTokenCache());
+    tokenizer->Tokenize(sourceFile.Get(), SelectedInputMode(), lexThreads ? lexThreads.Get() : 1);
+    return tokenizer;
 }
 
 void ParseOnly()
 {
-    Parser par(new Tokenizer(sourceFile.Get()));
+    Parser par(TokenizeSource());
+    par.DeferBodies(lazyBodies);
+    par.SetBodyThreads(parseThreads ? parseThreads.Get() : 1);
     par.Parse();
     std::cout << par;
+    if (dumpLayout)
+        par.PrintLayouts(std::cerr);
 }
 
 void Compile()
 {
-    Parser par(new Tokenizer(sourceFile.Get()));
+    Parser par(TokenizeSource());
     auto *assembly = new Asm::Assembly();
+    par.DeferBodies(lazyBodies);
+    par.SetBodyThreads(parseThreads ? parseThreads.Get() : 1);
+    par.FoldConstants(true);
     par.Parse();
     par.Generate(assembly);
     std::cout << *assembly;
+    if (dumpLayout)
+        par.PrintLayouts(std::cerr);
 }
 
 int main(int argc, char **argv)
@@ -84,23 +192,37 @@ int main(int argc, char **argv)
         throw new std::exception();
     try
     {
-        if (tokenizeOnly)
-        {
-            TokenizeOnly();
-        }
-        else if (parseOnly)
+        RunWithStack((stackSize ? stackSize.Get() : 256) * (1ull << 20), []()
         {
-            ParseOnly();
-        }
-        else
-        {
-            Compile();
-        }
+            if (lexBench)
+            {
+                LexBench();
+            }
+            else if (tokenizeOnly)
+            {
+                TokenizeOnly();
+            }
+            else if (parseOnly)
+            {
+                ParseOnly();
+            }
+            else
+            {
+                Compile();
+            }
+        });
     }
     catch (CompilationError &e)
     {
-        std::cout << e.what() << std::endl;
+        // the binary token dump is read by tools, the message must not end up among its records
+        (binaryTokens ? std::cerr : std::cout) << e.what() << std::endl;
+        PrintTokenCacheStats();
+        PrintMemStats();
         exit(1);
     }
+    PrintTokenCacheStats();
+    PrintMemStats();
+    // the AST and the symbols of the file go at once
+    CompilationArena.Release();
 	return 0;
 }
\ No newline at end of file
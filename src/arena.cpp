@@ -0,0 +1,76 @@
+#include "arena.h"
+
+#include <algorithm>
+
+Arena CompilationArena;
+thread_local Arena *Arena::active = &CompilationArena;
+
+Arena::~Arena()
+{
+    Release();
+    if (active == this)
+        active = nullptr;
+}
+
+void *Arena::allocateSlow(size_t size, size_t alignment)
+{
+    // blocks kept by Reset come first, a new block is only added when none of them fits
+    for (current = next ? current + 1 : 0; current < blocks.size(); current++)
+    {
+        auto &block = blocks[current];
+        auto p = (char *)(((uintptr_t)block.data + alignment - 1) & ~(uintptr_t)(alignment - 1));
+        if (p + size <= block.data + block.size)
+        {
+            next = p + size;
+            end = block.data + block.size;
+            return p;
+        }
+    }
+    // an object bigger than a block gets one of its own
+    Block block{nullptr, std::max(BlockSize, size + alignment)};
+    block.data = new char[block.size];
+    blocks.push_back(block);
+    current = blocks.size() - 1;
+    auto p = (char *)(((uintptr_t)block.data + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    next = p + size;
+    end = block.data + block.size;
+    return p;
+}
+
+void Arena::Forget(void *object)
+{
+    // it is one of the last objects, the ones its constructor made come after it
+    for (auto i = objects.size(); i--;)
+        if (objects[i] == object)
+        {
+            objects[i] = nullptr;
+            return;
+        }
+}
+
+void Arena::Reset()
+{
+    for (auto i = objects.size(); i--;)
+        if (objects[i])
+            objects[i]->~ArenaObject();
+    objects.clear();
+    current = 0;
+    next = end = nullptr;
+    allocations = bytesAllocated = 0;
+}
+
+void Arena::Release()
+{
+    Reset();
+    for (auto &block: blocks)
+        delete[] block.data;
+    blocks.clear();
+}
+
+uint64_t Arena::BytesReserved() const
+{
+    uint64_t total = 0;
+    for (auto &block: blocks)
+        total += block.size;
+    return total;
+}
@@ -21,12 +21,11 @@ Asm::ArgumentConstant::ArgumentConstant(ConstNode *constNode): constant(constNod
 
 void Asm::ArgumentConstant::Print(std::ostream &os)
 {
-    void *typedConstant = nullptr;
-    if ((typedConstant = dynamic_cast<IntConstNode *>(this->constant)))
-        os << "$" + std::to_string(((IntConstNode *)typedConstant)->GetValue()) + " ";
-    else if ((typedConstant = dynamic_cast<FloatConstNode *>(this->constant)))
+    if (constant->GetNodeKind() == NodeKind::INT_CONST)
+        os << "$" + std::to_string(((IntConstNode *)constant)->GetValue()) + " ";
+    else if (constant->GetNodeKind() == NodeKind::FLOAT_CONST)
     {
-        float f = ((FloatConstNode *)typedConstant)->GetValue();
+        float f = ((FloatConstNode *)constant)->GetValue();
         os << "$" + std::to_string(*((unsigned int *)&f)) + " ";
     }
 }
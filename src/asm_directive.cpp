@@ -8,4 +8,4 @@ void Asm::AsmStringDirective::Print(std::ostream &os)
     os << ".string " << str << std::endl;
 }
 
-Asm::AsmStringDirective::AsmStringDirective(std::string str): str(std::move(str)) {}
+Asm::AsmStringDirective::AsmStringDirective(std::string_view str): str(str) {}
@@ -16,12 +16,12 @@ std::string Asm::AsmSimpleLabel::GetName()
 
 void Asm::AsmFunction::Print(std::ostream &os)
 {
-    os << name << ":";
+    os << Identifiers.Spelling(name) << ":";
 }
 
-Asm::AsmFunction::AsmFunction(std::string name): name(std::move(name)) {}
+Asm::AsmFunction::AsmFunction(NameId name): name(name) {}
 
 std::string Asm::AsmFunction::GetName()
 {
-    return name;
+    return Identifiers.Spelling(name);
 }
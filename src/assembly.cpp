@@ -8,6 +8,7 @@ std::ostream &Asm::operator<<(std::ostream &os, Asm::Assembly &assembly)
     os << assembly.dataSection << std::endl;
     os << ".section .text" << std::endl << ".globl main" << std::endl;
     os << assembly.textSection << std::endl;
+    return os;
 }
 
 Asm::Section &Asm::Assembly::TextSection()
@@ -30,7 +31,7 @@ Asm::AsmSimpleLabel *Asm::Assembly::NextLabel()
     return new AsmSimpleLabel(nextLabel++);
 }
 
-Asm::AsmFunction *Asm::Assembly::MakeFunctionLabel(std::string name)
+Asm::AsmFunction *Asm::Assembly::MakeFunctionLabel(NameId name)
 {
-    return new AsmFunction(std::move(name));
+    return new AsmFunction(name);
 }
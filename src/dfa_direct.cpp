@@ -0,0 +1,714 @@
+// Generated by FiniteAutomata/gen_direct.py from FiniteAutomata/FAC.csv, do not edit.
+
+#include "dfa.h"
+
+int RunFiniteAutomataDirect(int state, const char *&p, const char *end)
+{
+	switch (state)
+	{
+		case 0: goto s0;
+		case 1: goto s1;
+		case 2: goto s2;
+		case 3: goto s3;
+		case 4: goto s4;
+		case 5: goto s5;
+		case 6: goto s6;
+		case 7: goto s7;
+		case 8: goto s8;
+		case 9: goto s9;
+		case 10: goto s10;
+		case 11: goto s11;
+		case 12: goto s12;
+		case 13: goto s13;
+		case 14: goto s14;
+		case 15: goto s15;
+		case 16: goto s16;
+		case 17: goto s17;
+		case 18: goto s18;
+		case 19: goto s19;
+		case 20: goto s20;
+		case 21: goto s21;
+		case 22: goto s22;
+		case 23: goto s23;
+		case 24: goto s24;
+		case 25: goto s25;
+		case 26: goto s26;
+		case 27: goto s27;
+		case 28: goto s28;
+		case 29: goto s29;
+		case 30: goto s30;
+		case 31: goto s31;
+		case 32: goto s32;
+		case 33: goto s33;
+		case 34: goto s34;
+		case 35: goto s35;
+		case 36: goto s36;
+		case 37: goto s37;
+		case 38: goto s38;
+		case 39: goto s39;
+		case 40: goto s40;
+		case 41: goto s41;
+		case 42: goto s42;
+		case 43: goto s43;
+		case 44: goto s44;
+		case 45: goto s45;
+		case 46: goto s46;
+		case 47: goto s47;
+		case 48: goto s48;
+		case 49: goto s49;
+		case 50: goto s50;
+		case 51: goto s51;
+		case 52: goto s52;
+		case 53: goto s53;
+		case 55: goto s55;
+		case 58: goto s58;
+		case 59: goto s59;
+		case 60: goto s60;
+		case 61: goto s61;
+		case 62: goto s62;
+		case 63: goto s63;
+		case 64: goto s64;
+		case 65: goto s65;
+		case 66: goto s66;
+		case 67: goto s67;
+		case 68: goto s68;
+		case 69: goto s69;
+		case 70: goto s70;
+		case 71: goto s71;
+		default: return state;
+	}
+s0:
+	if (p == end) return 0;
+	switch ((uint8_t)*p)
+	{
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s1;
+		case '-':
+			p++; goto s2;
+		case '+':
+			p++; goto s3;
+		case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8':
+		case '9':
+			p++; goto s4;
+		case '(':
+			p++; goto s12;
+		case ')':
+			p++; goto s13;
+		case '[':
+			p++; goto s14;
+		case ']':
+			p++; goto s15;
+		case '{':
+			p++; goto s16;
+		case '}':
+			p++; goto s17;
+		case ':':
+			p++; goto s18;
+		case ';':
+			p++; goto s19;
+		case '?':
+			p++; goto s20;
+		case ',':
+			p++; goto s21;
+		case '=':
+			p++; goto s22;
+		case '>':
+			p++; goto s24;
+		case '<':
+			p++; goto s26;
+		case '!':
+			p++; goto s28;
+		case '~':
+			p++; goto s30;
+		case '.':
+			p++; goto s31;
+		case '%':
+			p++; goto s32;
+		case '^':
+			p++; goto s35;
+		case '&':
+			p++; goto s36;
+		case '|':
+			p++; goto s37;
+		case '*':
+			p++; goto s42;
+		case '\\':
+			p++; goto s49;
+		case '/':
+			p++; goto s52;
+		case '"':
+			p++; goto s58;
+		case '\'':
+			p++; goto s62;
+		case '0':
+			p++; goto s67;
+	}
+	return 0;
+s1:
+	if (p == end) return 1;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9': case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
+		case 'G': case 'H': case 'I': case 'J': case 'K': case 'L': case 'M': case 'N':
+		case 'O': case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V':
+		case 'W': case 'X': case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c':
+		case 'd': case 'e': case 'f': case 'g': case 'h': case 'i': case 'j': case 'k':
+		case 'l': case 'm': case 'n': case 'o': case 'p': case 'q': case 'r': case 's':
+		case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s1;
+	}
+	return 1;
+s2:
+	if (p == end) return 2;
+	switch ((uint8_t)*p)
+	{
+		case 'z':
+			p++; goto s1;
+		case '-':
+			p++; goto s40;
+		case '=':
+			p++; goto s43;
+		case '>':
+			p++; goto s53;
+	}
+	return 2;
+s3:
+	if (p == end) return 3;
+	switch ((uint8_t)*p)
+	{
+		case '+':
+			p++; goto s41;
+		case '=':
+			p++; goto s44;
+	}
+	return 3;
+s4:
+	if (p == end) return 4;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s4;
+		case '.':
+			p++; goto s5;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 4;
+s5:
+	if (p == end) return 5;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s6;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 5;
+s6:
+	if (p == end) return 6;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s6;
+		case 'e':
+			p++; goto s7;
+		case 'E':
+			p++; goto s8;
+		case 'A': case 'B': case 'C': case 'D': case 'F': case 'G': case 'H': case 'I':
+		case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P': case 'Q':
+		case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X': case 'Y':
+		case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'f': case 'g':
+		case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n': case 'o':
+		case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v': case 'w':
+		case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 6;
+s7:
+	if (p == end) return 7;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s9;
+		case '+':
+			p++; goto s10;
+		case '-':
+			p++; goto s11;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 7;
+s8:
+	if (p == end) return 8;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s9;
+		case '+':
+			p++; goto s10;
+		case '-':
+			p++; goto s11;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 8;
+s9:
+	if (p == end) return 9;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s9;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 9;
+s10:
+	if (p == end) return 10;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s9;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 10;
+s11:
+	if (p == end) return 11;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s9;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e':
+		case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm':
+		case 'n': case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u':
+		case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 11;
+s12:
+	if (p == end) return 12;
+	return 12;
+s13:
+	if (p == end) return 13;
+	return 13;
+s14:
+	if (p == end) return 14;
+	return 14;
+s15:
+	if (p == end) return 15;
+	return 15;
+s16:
+	if (p == end) return 16;
+	return 16;
+s17:
+	if (p == end) return 17;
+	return 17;
+s18:
+	if (p == end) return 18;
+	return 18;
+s19:
+	if (p == end) return 19;
+	return 19;
+s20:
+	if (p == end) return 20;
+	return 20;
+s21:
+	if (p == end) return 21;
+	return 21;
+s22:
+	if (p == end) return 22;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s23;
+	}
+	return 22;
+s23:
+	if (p == end) return 23;
+	return 23;
+s24:
+	if (p == end) return 24;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s25;
+		case '>':
+			p++; goto s34;
+	}
+	return 24;
+s25:
+	if (p == end) return 25;
+	return 25;
+s26:
+	if (p == end) return 26;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s27;
+		case '<':
+			p++; goto s33;
+	}
+	return 26;
+s27:
+	if (p == end) return 27;
+	return 27;
+s28:
+	if (p == end) return 28;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s29;
+	}
+	return 28;
+s29:
+	if (p == end) return 29;
+	return 29;
+s30:
+	if (p == end) return 30;
+	return 30;
+s31:
+	if (p == end) return 31;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s6;
+	}
+	return 31;
+s32:
+	if (p == end) return 32;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s71;
+	}
+	return 32;
+s33:
+	if (p == end) return 33;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s47;
+	}
+	return 33;
+s34:
+	if (p == end) return 34;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s48;
+	}
+	return 34;
+s35:
+	if (p == end) return 35;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s50;
+	}
+	return 35;
+s36:
+	if (p == end) return 36;
+	switch ((uint8_t)*p)
+	{
+		case '&':
+			p++; goto s38;
+		case '=':
+			p++; goto s51;
+	}
+	return 36;
+s37:
+	if (p == end) return 37;
+	switch ((uint8_t)*p)
+	{
+		case '|':
+			p++; goto s39;
+		case '=':
+			p++; goto s46;
+	}
+	return 37;
+s38:
+	if (p == end) return 38;
+	return 38;
+s39:
+	if (p == end) return 39;
+	return 39;
+s40:
+	if (p == end) return 40;
+	return 40;
+s41:
+	if (p == end) return 41;
+	return 41;
+s42:
+	if (p == end) return 42;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s45;
+	}
+	return 42;
+s43:
+	if (p == end) return 43;
+	return 43;
+s44:
+	if (p == end) return 44;
+	return 44;
+s45:
+	if (p == end) return 45;
+	return 45;
+s46:
+	if (p == end) return 46;
+	return 46;
+s47:
+	if (p == end) return 47;
+	return 47;
+s48:
+	if (p == end) return 48;
+	return 48;
+s49:
+	if (p == end) return 49;
+	return 49;
+s50:
+	if (p == end) return 50;
+	return 50;
+s51:
+	if (p == end) return 51;
+	return 51;
+s52:
+	if (p == end) return 52;
+	switch ((uint8_t)*p)
+	{
+		case '=':
+			p++; goto s55;
+	}
+	return 52;
+s53:
+	if (p == end) return 53;
+	return 53;
+s55:
+	if (p == end) return 55;
+	return 55;
+s58:
+	if (p == end) return 58;
+	switch ((uint8_t)*p)
+	{
+		case ' ': case '!': case '#': case '$': case '%': case '&': case '\'': case '(':
+		case ')': case '*': case '+': case ',': case '-': case '.': case '/': case '0':
+		case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8':
+		case '9': case ':': case ';': case '<': case '=': case '>': case '?': case '@':
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '[': case ']': case '^': case '_': case '`': case 'a':
+		case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i':
+		case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q':
+		case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y':
+		case 'z': case '{': case '|': case '}': case '~':
+			p++; goto s59;
+		case '\\':
+			p++; goto s60;
+		case '"':
+			p++; goto s61;
+		default:
+			if ((uint8_t)*p < 0x80) break;
+			p++; goto s59;
+	}
+	return 58;
+s59:
+	if (p == end) return 59;
+	switch ((uint8_t)*p)
+	{
+		case ' ': case '!': case '#': case '$': case '%': case '&': case '\'': case '(':
+		case ')': case '*': case '+': case ',': case '-': case '.': case '/': case '0':
+		case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8':
+		case '9': case ':': case ';': case '<': case '=': case '>': case '?': case '@':
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '[': case ']': case '^': case '_': case '`': case 'a':
+		case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i':
+		case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q':
+		case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y':
+		case 'z': case '{': case '|': case '}': case '~':
+			p++; goto s59;
+		case '\\':
+			p++; goto s60;
+		case '"':
+			p++; goto s61;
+		default:
+			if ((uint8_t)*p < 0x80) break;
+			p++; goto s59;
+	}
+	return 59;
+s60:
+	if (p == end) return 60;
+	switch ((uint8_t)*p)
+	{
+		case '"': case '\'': case '0': case '?': case '\\': case 'a': case 'b': case 'e':
+		case 'f': case 'n': case 'r': case 't': case 'v':
+			p++; goto s59;
+	}
+	return 60;
+s61:
+	if (p == end) return 61;
+	return 61;
+s62:
+	if (p == end) return 62;
+	switch ((uint8_t)*p)
+	{
+		case ' ': case '!': case '"': case '#': case '$': case '%': case '&': case '(':
+		case ')': case '*': case '+': case ',': case '-': case '.': case '/': case '0':
+		case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8':
+		case '9': case ':': case ';': case '<': case '=': case '>': case '?': case '@':
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+		case 'Y': case 'Z': case '[': case ']': case '^': case '_': case '`': case 'a':
+		case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i':
+		case 'j': case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q':
+		case 'r': case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y':
+		case 'z': case '{': case '|': case '}': case '~':
+			p++; goto s63;
+		case '\\':
+			p++; goto s64;
+		default:
+			if ((uint8_t)*p < 0x80) break;
+			p++; goto s63;
+	}
+	return 62;
+s63:
+	if (p == end) return 63;
+	switch ((uint8_t)*p)
+	{
+		case '\'':
+			p++; goto s66;
+	}
+	return 63;
+s64:
+	if (p == end) return 64;
+	switch ((uint8_t)*p)
+	{
+		case '"': case '\'': case '0': case '?': case '\\': case 'a': case 'b': case 'e':
+		case 'f': case 'n': case 'r': case 't': case 'v':
+			p++; goto s65;
+	}
+	return 64;
+s65:
+	if (p == end) return 65;
+	switch ((uint8_t)*p)
+	{
+		case '\'':
+			p++; goto s66;
+	}
+	return 65;
+s66:
+	if (p == end) return 66;
+	return 66;
+s67:
+	if (p == end) return 67;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9':
+			p++; goto s4;
+		case '.':
+			p++; goto s5;
+		case 'X': case 'x':
+			p++; goto s68;
+		case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H':
+		case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P':
+		case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'Y':
+		case 'Z': case '_': case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+		case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': case 'n':
+		case 'o': case 'p': case 'q': case 'r': case 's': case 't': case 'u': case 'v':
+		case 'w': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 67;
+s68:
+	if (p == end) return 68;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9': case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
+		case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+			p++; goto s69;
+	}
+	return 68;
+s69:
+	if (p == end) return 69;
+	switch ((uint8_t)*p)
+	{
+		case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+		case '8': case '9': case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
+		case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+			p++; goto s69;
+		case 'G': case 'H': case 'I': case 'J': case 'K': case 'L': case 'M': case 'N':
+		case 'O': case 'P': case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V':
+		case 'W': case 'X': case 'Y': case 'Z': case 'g': case 'h': case 'i': case 'j':
+		case 'k': case 'l': case 'm': case 'n': case 'o': case 'p': case 'q': case 'r':
+		case 's': case 't': case 'u': case 'v': case 'w': case 'x': case 'y': case 'z':
+			p++; goto s70;
+	}
+	return 69;
+s70:
+	if (p == end) return 70;
+	return 70;
+s71:
+	if (p == end) return 71;
+	return 71;
+}
@@ -1,118 +1,353 @@
+#include <cmath>
 #include <errors/tcc_exceptions.h>
 #include "../includes/evaluator.h"
+#include "../includes/stack_guard.h"
+#include "../includes/symbols/type_context.h"
 
-ExprNode *Evaluator::Eval(ExprNode *node)
+static bool isInteger(BuiltInTypeKind kind)
+{
+    return kind >= BuiltInTypeKind::INT8 && kind <= BuiltInTypeKind::UINT64;
+}
+
+static bool isSigned(BuiltInTypeKind kind)
+{
+    return kind == BuiltInTypeKind::INT8 || kind == BuiltInTypeKind::INT16 || kind == BuiltInTypeKind::INT32 ||
+           kind == BuiltInTypeKind::INT64;
+}
+
+static int bits(BuiltInTypeKind kind)
 {
-    return node->Eval(this);
+    switch (kind)
+    {
+        case BuiltInTypeKind::INT8: case BuiltInTypeKind::UINT8:
+            return 8;
+        case BuiltInTypeKind::INT16: case BuiltInTypeKind::UINT16:
+            return 16;
+        case BuiltInTypeKind::INT32: case BuiltInTypeKind::UINT32:
+            return 32;
+        default:
+            return 64;
+    }
 }
 
-ExprNode *Evaluator::Eval(PostfixDecrementNode *node)
+// cuts value to the width of kind and extends it back by the signedness of kind
+static int64_t wrap(uint64_t value, BuiltInTypeKind kind)
 {
-    return nullptr;
+    auto width = bits(kind);
+    if (width == 64) return (int64_t)value;
+    auto mask = (UINT64_C(1) << width) - 1;
+    value &= mask;
+    if (isSigned(kind) && (value >> (width - 1)))
+        value |= ~mask;
+    return (int64_t)value;
 }
 
-ExprNode *Evaluator::Eval(PrefixDecrementNode *node)
+// what is narrower than int is computed as int, as C and the generated code do
+static BuiltInTypeKind promote(BuiltInTypeKind kind)
 {
-    return nullptr;
+    return isInteger(kind) && bits(kind) < 32 ? BuiltInTypeKind::INT32 : kind;
 }
 
-ExprNode *Evaluator::Eval(PostfixIncrementNode *node)
+static bool builtInKind(SymType *type, BuiltInTypeKind &kind)
 {
-    return nullptr;
+    if (!type) return false;
+    type = type->GetUnqualified();
+    if (type->GetTypeKind() != TypeKind::BUILTIN) return false;
+    kind = static_cast<SymBuiltInType *>(type)->GetBuiltInTypeKind();
+    return true;
 }
 
-ExprNode *Evaluator::Eval(PrefixIncrementNode *node)
+ExprNode *Evaluator::Eval(ExprNode *node)
 {
-    return nullptr;
+    deep = true;
+    return Visit(node);
 }
 
-ExprNode *Evaluator::Eval(ArrayAccessNode *node)
+ExprNode *Evaluator::Fold(ExprNode *node)
 {
-    return nullptr;
+    deep = false;
+    auto res = Visit(node);
+    deep = true;
+    return res;
 }
 
-ExprNode *Evaluator::Eval(BinOpNode *node)
+ExprNode *Evaluator::VisitBinOp(BinOpNode *node)
 {
-    auto left = Eval(node->Left()), right = Eval(node->Right());
-    if (!left || !right) return nullptr;
-    auto ileft = dynamic_cast<IntConstNode *>(left), iright = dynamic_cast<IntConstNode *>(right);
-    auto fleft = dynamic_cast<FloatConstNode *>(left), fright = dynamic_cast<FloatConstNode *>(right);
-    std::shared_ptr<Token> t;
-    double value = 0;
-#define EVAL(OP)\
-    if (ileft && iright)\
-    {\
-        return new IntConstNode(ileft->GetValue() OP iright->GetValue());\
+    if (StackLeft() < StackReserve)
+        throw NestingTooDeepError(node->GetPosition());
+    BuiltInTypeKind kind;
+    Value left{}, right{};
+    if (!builtInKind(node->GetType(), kind) || !read(operand(node->Left()), left)) return nullptr;
+    kind = promote(kind);
+    auto op = node->GetOperation().GetType();
+    auto truth = [](const Value &value) { return isInteger(value.kind) ? value.integer != 0 : value.real != 0; };
+    if (op == TokenType::LOGIC_AND || op == TokenType::LOGIC_OR)
+    {
+        // the left operand alone decides 0 && x and 1 || x
+        if (truth(left) == (op == TokenType::LOGIC_OR))
+            return make(Value{BuiltInTypeKind::INT32, truth(left), 0}, node);
+        if (!read(operand(node->Right()), right)) return nullptr;
+        return make(Value{BuiltInTypeKind::INT32, truth(right), 0}, node);
     }
+    if (!read(operand(node->Right()), right)) return nullptr;
+    switch (op)
+    {
+        case TokenType::RELOP_LT: case TokenType::RELOP_LE: case TokenType::RELOP_GT:
+        case TokenType::RELOP_GE: case TokenType::RELOP_EQ: case TokenType::RELOP_NE:
+        {
+            if (left.kind != right.kind) return nullptr;
+            int order;
+            if (!isInteger(left.kind))
+                order = left.real < right.real ? -1 : left.real > right.real ? 1 : left.real == right.real ? 0 : 2;
+            else if (isSigned(left.kind))
+                order = left.integer < right.integer ? -1 : left.integer > right.integer;
+            else
+                order = (uint64_t)left.integer < (uint64_t)right.integer ? -1 :
+                        (uint64_t)left.integer > (uint64_t)right.integer;
+            // 2 is unordered, a NaN is not equal to anything
+            bool res = false;
+            switch (op)
+            {
+                case TokenType::RELOP_LT: res = order == -1; break;
+                case TokenType::RELOP_LE: res = order == -1 || order == 0; break;
+                case TokenType::RELOP_GT: res = order == 1; break;
+                case TokenType::RELOP_GE: res = order == 1 || order == 0; break;
+                case TokenType::RELOP_EQ: res = order == 0; break;
+                default: res = order != 0; break;
+            }
+            return make(Value{BuiltInTypeKind::INT32, res, 0}, node);
+        }
+        case TokenType::BITWISE_LSHIFT: case TokenType::BITWISE_RSHIFT:
+        {
+            if (!isInteger(kind) || !isInteger(right.kind) || !convert(left, kind)) return nullptr;
+            // the count has to be less than the width of the promoted left operand
+            auto count = right.integer;
+            if (count < 0 || count >= bits(kind)) return nullptr;
+            uint64_t res;
+            if (op == TokenType::BITWISE_LSHIFT)
+                res = (uint64_t)left.integer << count;
+            else
+                res = isSigned(kind) ? (uint64_t)(left.integer >> count) : (uint64_t)left.integer >> count;
+            return make(Value{kind, wrap(res, kind), 0}, node);
+        }
+        default:
+            break;
+    }
+    if (!convert(left, kind) || !convert(right, kind)) return nullptr;
+    if (!isInteger(kind))
+    {
+        double res;
+        switch (op)
+        {
+            case TokenType::PLUS: res = left.real + right.real; break;
+            case TokenType::MINUS: res = left.real - right.real; break;
+            case TokenType::ASTERIX: res = left.real * right.real; break;
+            case TokenType::FORWARD_SLASH:
+                if (right.real == 0) return nullptr;
+                res = left.real / right.real;
+                break;
+            default:
+                return nullptr;
+        }
+        return make(Value{kind, 0, kind == BuiltInTypeKind::FLOAT ? (float)res : res}, node);
+    }
+    auto x = (uint64_t)left.integer, y = (uint64_t)right.integer;
+    uint64_t res;
+    switch (op)
+    {
+        case TokenType::PLUS: res = x + y; break;
+        case TokenType::MINUS: res = x - y; break;
+        case TokenType::ASTERIX: res = x * y; break;
+        case TokenType::BITWISE_AND: res = x & y; break;
+        case TokenType::BITWISE_OR: res = x | y; break;
+        case TokenType::BITWISE_XOR: res = x ^ y; break;
+        case TokenType::FORWARD_SLASH: case TokenType::REMINDER:
+            if (!y) return nullptr;
+            if (isSigned(kind))
+            {
+                // the quotient of the smallest value by -1 does not fit
+                if (right.integer == -1 && left.integer == wrap(UINT64_C(1) << (bits(kind) - 1), kind))
+                    return nullptr;
+                res = (uint64_t)(op == TokenType::REMINDER ? left.integer % right.integer :
+                                                             left.integer / right.integer);
+            }
+            else
+                res = op == TokenType::REMINDER ? x % y : x / y;
+            break;
+        default:
+            return nullptr;
+    }
+    return make(Value{kind, wrap(res, kind), 0}, node);
+}
 
-    switch (node->GetOperation()->type)
+ExprNode *Evaluator::VisitUnaryOp(UnaryOpNode *node)
+{
+    BuiltInTypeKind kind;
+    Value value{};
+    if (!builtInKind(node->GetType(), kind) || !read(operand(node->Operand()), value)) return nullptr;
+    kind = promote(kind);
+    switch (node->GetOperation().GetType())
     {
+        case TokenType::LOGIC_NO:
+            return make(Value{BuiltInTypeKind::INT32, isInteger(value.kind) ? !value.integer : value.real == 0, 0},
+                        node);
         case TokenType::PLUS:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() + iright->GetValue());
+            break;
         case TokenType::MINUS:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() - iright->GetValue());
-        case TokenType::ASTERIX:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() * iright->GetValue());
-        case TokenType::BITWISE_AND:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() * iright->GetValue());
-        case TokenType::BITWISE_OR:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() | iright->GetValue());
-        case TokenType::BITWISE_XOR:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() ^ iright->GetValue());
-        case TokenType::BITWISE_LSHIFT:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() | iright->GetValue());
-        case TokenType::BITWISE_RSHIFT:
-            if (ileft && iright)
-                return new IntConstNode(ileft->GetValue() | iright->GetValue());
-
-
+            if (!convert(value, kind)) return nullptr;
+            if (isInteger(kind))
+                value.integer = wrap(0 - (uint64_t)value.integer, kind);
+            else
+                value.real = -value.real;
+            break;
+        case TokenType::BITWISE_NOT:
+            if (!convert(value, kind) || !isInteger(kind)) return nullptr;
+            value.integer = wrap(~(uint64_t)value.integer, kind);
+            break;
+        default:
+            return nullptr;
     }
-    return nullptr;
+    if (!convert(value, kind)) return nullptr;
+    return make(value, node);
 }
 
-ExprNode *Evaluator::Eval(UnaryOpNode *node)
+ExprNode *Evaluator::VisitTernary(TernaryOperatorNode *node)
 {
-    return nullptr;
+    BuiltInTypeKind kind;
+    Value condition{}, value{};
+    if (!builtInKind(node->GetType(), kind) || !read(operand(node->Condition()), condition)) return nullptr;
+    auto taken = (isInteger(condition.kind) ? condition.integer != 0 : condition.real != 0) ?
+                 node->IfTrue() : node->IfFalse();
+    // the other branch is never evaluated, so it does not have to be constant
+    if (!read(operand(taken), value) || !convert(value, kind)) return nullptr;
+    return make(value, node);
 }
 
-ExprNode *Evaluator::Eval(SizeofExprNode *node)
+ExprNode *Evaluator::VisitComma(CommaSeparatedExprs *node)
 {
-    return nullptr;
+    BuiltInTypeKind kind;
+    Value value{};
+    if (!builtInKind(node->GetType(), kind)) return nullptr;
+    // constants have no side effects, so only the last one is left when all of them are constant
+    for (auto expr: node->List())
+        if (!read(operand(expr), value)) return nullptr;
+    if (!convert(value, kind)) return nullptr;
+    return make(value, node);
 }
 
-ExprNode *Evaluator::Eval(SizeofTypeNameNode *node)
+ExprNode *Evaluator::VisitTypeCast(TypeCastNode *node)
 {
-    return nullptr;
+    BuiltInTypeKind kind;
+    Value value{};
+    if (!builtInKind(node->GetType(), kind) || !read(operand(node->Operand()), value) || !convert(value, kind))
+        return nullptr;
+    return make(value, node);
 }
 
-ExprNode *Evaluator::Eval(AssignmentNode *node)
+ExprNode *Evaluator::VisitSizeofExpr(SizeofExprNode *node)
 {
-    return nullptr;
+    return sizeOf(node->Operand()->GetType(), node);
 }
 
-ExprNode *Evaluator::Eval(IntConstNode *node)
+ExprNode *Evaluator::VisitSizeofTypeName(SizeofTypeNameNode *node)
 {
-    return node;
+    return sizeOf(node->GetTypeName(), node);
 }
 
-ExprNode *Evaluator::Eval(FloatConstNode *node)
+ExprNode *Evaluator::VisitIntConst(IntConstNode *node)
 {
     return node;
 }
 
-ExprNode *Evaluator::Eval(TypeCastNode *node)
+ExprNode *Evaluator::VisitFloatConst(FloatConstNode *node)
 {
-    return nullptr;
+    return node;
 }
 
-ExprNode *Evaluator::Eval(EnumeratorNode *node)
+ExprNode *Evaluator::VisitEnumerator(EnumeratorNode *node)
 {
     return node->GetValue();
 }
+
+ExprNode *Evaluator::operand(ExprNode *node)
+{
+    if (deep) return Visit(node);
+    auto kind = node->GetNodeKind();
+    return kind == NodeKind::INT_CONST || kind == NodeKind::FLOAT_CONST ? node : nullptr;
+}
+
+bool Evaluator::read(ExprNode *node, Value &value)
+{
+    if (!node) return false;
+    if (node->GetNodeKind() == NodeKind::FLOAT_CONST)
+    {
+        value = Value{BuiltInTypeKind::FLOAT, 0, static_cast<FloatConstNode *>(node)->GetValue()};
+        return true;
+    }
+    if (node->GetNodeKind() != NodeKind::INT_CONST) return false;
+    if (!builtInKind(node->GetType(), value.kind) || !isInteger(value.kind)) value.kind = BuiltInTypeKind::INT32;
+    value.integer = wrap((uint64_t)(int64_t)static_cast<IntConstNode *>(node)->GetValue(), value.kind);
+    value.real = 0;
+    return true;
+}
+
+bool Evaluator::convert(Value &value, BuiltInTypeKind kind)
+{
+    if (value.kind == kind) return true;
+    if (isInteger(kind))
+    {
+        if (isInteger(value.kind))
+            value.integer = wrap((uint64_t)value.integer, kind);
+        else
+        {
+            // out of range is undefined, it is left for the run time
+            auto width = bits(kind);
+            if (width == 64 || std::isnan(value.real)) return false;
+            auto truncated = std::trunc(value.real);
+            auto min = isSigned(kind) ? -std::ldexp(1.0, width - 1) : 0.0;
+            auto max = std::ldexp(1.0, isSigned(kind) ? width - 1 : width) - 1;
+            if (truncated < min || truncated > max) return false;
+            value.integer = (int64_t)truncated;
+        }
+    }
+    else if (kind == BuiltInTypeKind::FLOAT || kind == BuiltInTypeKind::DOUBLE)
+    {
+        if (isInteger(value.kind))
+            value.real = isSigned(value.kind) ? (double)value.integer : (double)(uint64_t)value.integer;
+        if (kind == BuiltInTypeKind::FLOAT)
+            value.real = (float)value.real;
+    }
+    else
+        return false;
+    value.kind = kind;
+    return true;
+}
+
+// only what fits a constant node comes out, there are none for 64 bit integers and doubles
+ExprNode *Evaluator::make(const Value &value, ExprNode *origin)
+{
+    ExprNode *res;
+    if (isInteger(value.kind) && bits(value.kind) <= 32)
+    {
+        res = new IntConstNode((int32_t)(uint32_t)value.integer);
+        if (value.kind != BuiltInTypeKind::INT32)
+            res->SetType(Types.BuiltIn(value.kind));
+    }
+    else if (value.kind == BuiltInTypeKind::FLOAT)
+        res = new FloatConstNode((float)value.real);
+    else
+        return nullptr;
+    res->SetPosition(origin->GetPosition());
+    return res;
+}
+
+ExprNode *Evaluator::sizeOf(SymType *type, ExprNode *origin)
+{
+    if (!type) return nullptr;
+    type = type->GetUnqualified();
+    BuiltInTypeKind kind;
+    if (type->GetTypeKind() == TypeKind::FUNCTION || !type->IsComplete() ||
+        (builtInKind(type, kind) && kind == BuiltInTypeKind::VOID))
+        return nullptr;
+    return make(Value{BuiltInTypeKind::UINT32, (uint32_t)type->Size(), 0}, origin);
+}
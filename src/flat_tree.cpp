@@ -0,0 +1,88 @@
+#include "flat_tree.h"
+#include "nodes.h"
+
+constexpr const char *NodeKindNames[] =
+{
+    "EMPTY", "OPAQUE",
+    "INT_CONST", "FLOAT_CONST", "STRING_LITERAL", "ID",
+    "POSTFIX_INCREMENT", "POSTFIX_DECREMENT", "PREFIX_INCREMENT", "PREFIX_DECREMENT",
+    "MEMBER_ACCESS", "MEMBER_ACCESS_BY_POINTER", "ARRAY_ACCESS", "FUNCTION_CALL", "PRINTF",
+    "SIZEOF_EXPR", "SIZEOF_TYPE", "UNARY_OP", "BIN_OP", "TERNARY", "ASSIGNMENT", "COMMA", "TYPE_CAST", "ENUMERATOR",
+    "EXPR_STATEMENT", "IF", "IF_ELSE", "GOTO", "CONTINUE", "BREAK", "RETURN", "WHILE", "DO_WHILE", "FOR", "LABEL",
+    "COMPOUND", "FUNCTION_DEFINITION", "TRANSLATION_UNIT",
+    "SIMPLE_INITIALIZER", "INITIALIZER_LIST", "DESIGNATED_INITIALIZER", "ARRAY_DESIGNATOR", "STRUCT_MEMBER_DESIGNATOR"
+};
+
+static_assert(sizeof(NodeKindNames) / sizeof(NodeKindNames[0]) == NodeKindCount,
+              "every node kind needs a name");
+
+const char *NodeKindName(NodeKind kind)
+{
+    return NodeKindNames[(size_t)kind];
+}
+
+void Node::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::OPAQUE);
+    description->Source(this);
+}
+
+// Breadth first: describing a node appends its children to the end of the array, all at once
+FlatTree FlatTreeBuilder::Build(Node *root)
+{
+    tree = FlatTree();
+    pending.assign(1, root);
+    tree.nodes.push_back(FlatNode{0, 0, 0, NodeKind::EMPTY});
+    tree.types.push_back(nullptr);
+    for (current = 0; current < pending.size(); current++)
+    {
+        auto first = (uint32_t)tree.nodes.size();
+        tree.nodes[current].first = first;
+        if (pending[current])
+            pending[current]->Describe(this);
+        tree.nodes[current].count = (uint32_t)tree.nodes.size() - first;
+    }
+    pending.clear();
+    return std::move(tree);
+}
+
+void FlatTreeBuilder::Kind(NodeKind kind)
+{
+    tree.nodes[current].kind = kind;
+}
+
+void FlatTreeBuilder::Child(Node *child)
+{
+    tree.nodes.push_back(FlatNode{0, 0, 0, NodeKind::EMPTY});
+    tree.types.push_back(nullptr);
+    pending.push_back(child);
+}
+
+void FlatTreeBuilder::Int(int32_t value)
+{
+    tree.nodes[current].payload = (uint32_t)tree.ints.size();
+    tree.ints.push_back(value);
+}
+
+void FlatTreeBuilder::Float(float value)
+{
+    tree.nodes[current].payload = (uint32_t)tree.floats.size();
+    tree.floats.push_back(value);
+}
+
+void FlatTreeBuilder::Lexeme(Token token)
+{
+    tree.nodes[current].payload = (uint32_t)tree.lexemes.size();
+    tree.lexemes.push_back(token);
+}
+
+void FlatTreeBuilder::Source(Node *node)
+{
+    tree.nodes[current].payload = (uint32_t)tree.sources.size();
+    tree.sources.push_back(node);
+}
+
+void FlatTreeBuilder::Type(SymType *type)
+{
+    tree.types[current] = type;
+}
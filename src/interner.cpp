@@ -0,0 +1,21 @@
+#include "interner.h"
+
+Interner Identifiers;
+
+Interner::Interner()
+{
+    Intern("");
+}
+
+NameId Interner::Intern(std::string_view name)
+{
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (shared)
+        lock.lock();
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+    auto id = (NameId)spellings.size();
+    spellings.emplace_back(name);
+    ids.emplace(spellings.back(), id);
+    return id;
+}
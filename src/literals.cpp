@@ -0,0 +1,158 @@
+#include "literals.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static inline int digitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        return (c | 0x20) - 'a' + 10;
+    return 16;
+}
+
+LiteralStatus DecodeIntLiteral(std::string_view text, uint64_t &value)
+{
+    unsigned base = 10;
+    size_t i = 0;
+    if (text.length() >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+    {
+        base = 16;
+        i = 2;
+    }
+    else if (!text.empty() && text[0] == '0')
+        base = 8;
+    value = 0;
+    size_t digits = 0;
+    for (; i < text.length(); i++, digits++)
+    {
+        unsigned d = (unsigned)digitValue(text[i]);
+        if (d >= base)
+            break;
+        if (__builtin_mul_overflow(value, (uint64_t)base, &value) || __builtin_add_overflow(value, d, &value))
+            return LiteralStatus::OUT_OF_RANGE;
+    }
+    return digits ? LiteralStatus::OK : LiteralStatus::MALFORMED;
+}
+
+// powers of ten that long double represents exactly, 5^27 still fits in a 64 bit mantissa
+constexpr int ExactPowers = 28;
+
+struct PowersOfTen
+{
+    long double values[ExactPowers];
+    constexpr PowersOfTen(): values()
+    {
+        long double p = 1;
+        for (int i = 0; i < ExactPowers; i++, p *= 10)
+            values[i] = p;
+    }
+};
+
+constexpr PowersOfTen Powers;
+
+LiteralStatus DecodeFloatLiteral(std::string_view text, long double &value)
+{
+    uint64_t mantissa = 0;
+    int exponent = 0, digits = 0;
+    bool exact = true;
+    size_t i = 0;
+    for (bool fraction = false; i < text.length(); i++)
+    {
+        if (text[i] == '.' && !fraction)
+        {
+            fraction = true;
+            continue;
+        }
+        if (text[i] < '0' || text[i] > '9')
+            break;
+        digits++;
+        if (__builtin_mul_overflow(mantissa, (uint64_t)10, &mantissa) ||
+            __builtin_add_overflow(mantissa, (uint64_t)(text[i] - '0'), &mantissa))
+            exact = false;
+        exponent -= fraction;
+    }
+    if (!digits)
+        return LiteralStatus::MALFORMED;
+    if (i < text.length() && (text[i] == 'e' || text[i] == 'E'))
+    {
+        i++;
+        bool negative = i < text.length() && text[i] == '-';
+        if (i < text.length() && (text[i] == '-' || text[i] == '+'))
+            i++;
+        int e = 0;
+        for (; i < text.length() && text[i] >= '0' && text[i] <= '9'; i++)
+            if (e < 100000)
+                e = e * 10 + text[i] - '0';
+        exponent += negative ? -e : e;
+    }
+    // the mantissa and the power of ten are both exact, so a single operation rounds correctly
+    // and gives what strtold gives
+    if (exact && (mantissa >> 63) == 0 && exponent > -ExactPowers && exponent < ExactPowers)
+    {
+        value = exponent < 0 ? (long double)mantissa / Powers.values[-exponent]
+                             : (long double)mantissa * Powers.values[exponent];
+        return LiteralStatus::OK;
+    }
+    // long mantissas and big exponents need a correctly rounded conversion, which strtold does;
+    // source buffers are not terminated, so it gets a copy
+    char local[128];
+    std::string heap;
+    const char *terminated = local;
+    if (text.length() < sizeof(local))
+    {
+        memcpy(local, text.data(), text.length());
+        local[text.length()] = 0;
+    }
+    else
+        terminated = (heap = std::string(text)).c_str();
+    errno = 0;
+    value = strtold(terminated, nullptr);
+    return errno == ERANGE ? LiteralStatus::OUT_OF_RANGE : LiteralStatus::OK;
+}
+
+LiteralStatus DecodeEscape(char c, char &value)
+{
+    switch (c)
+    {
+        case 'n':
+            value = '\n';
+            break;
+        case 'a':
+            value = '\a';
+            break;
+        case 't':
+            value = '\t';
+            break;
+        case 'v':
+            value = '\v';
+            break;
+        case '?':
+            value = '\?';
+            break;
+        case '\\':
+            value = '\\';
+            break;
+        case '\'':
+            value = '\'';
+            break;
+        case 'b':
+            value = '\b';
+            break;
+        case 'f':
+            value = '\f';
+            break;
+        case '0':
+            value = '\0';
+            break;
+        case '\"':
+            value = '\"';
+            break;
+        default:
+            return LiteralStatus::MALFORMED;
+    }
+    return LiteralStatus::OK;
+}
@@ -4,7 +4,9 @@
 
 #include <gmpxx.h>
 #include "../includes/nodes.h"
-#include "../includes/evaluator.h"
+#include "../includes/symbols/type_context.h"
+#include "../includes/stack_guard.h"
+#include "../includes/errors/syntax_errors.h"
 
 void IntConstNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
@@ -12,17 +14,13 @@ void IntConstNode::Print(std::ostream &os, std::string indent, bool isTail)
     os << value << std::endl;
 }
 
-IntConstNode::IntConstNode(std::shared_ptr<Token> token)
+IntConstNode::IntConstNode(Token token)
 {
-    if (token->type != TokenType::NUM_INT) throw "";
-    type = new SymBuiltInType(BuiltInTypeKind::INT32, 0);
-    position = token->position;
-    value = token->intValue;
-}
-
-ExprNode *IntConstNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
+    nodeKind = NodeKind::INT_CONST;
+    if (token.GetType() != TokenType::NUM_INT) throw "";
+    type = Types.BuiltIn(BuiltInTypeKind::INT32);
+    position = token.GetPosition();
+    value = token.GetIntValue();
 }
 
 int32_t IntConstNode::GetValue() const
@@ -32,8 +30,9 @@ int32_t IntConstNode::GetValue() const
 
 IntConstNode::IntConstNode(int32_t value)
 {
+    nodeKind = NodeKind::INT_CONST;
     this->value = value;
-    type = new SymBuiltInType(BuiltInTypeKind::INT32);
+    type = Types.BuiltIn(BuiltInTypeKind::INT32);
 }
 
 void IntConstNode::Generate(Asm::Assembly *assembly)
@@ -42,23 +41,25 @@ void IntConstNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
-void FloatConstNode::Print(std::ostream &os, std::string indent, bool isTail)
+void IntConstNode::Describe(NodeDescription *description)
 {
-    os << indent << (isTail ? "└── " : "├── ");
-    os << value << std::endl;
+    describe(description, NodeKind::INT_CONST);
+    description->Int(value);
 }
 
-FloatConstNode::FloatConstNode(std::shared_ptr<Token> token)
+void FloatConstNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
-    if (token->type != TokenType::NUM_FLOAT) throw "";
-    type = new SymBuiltInType(BuiltInTypeKind::FLOAT, 0);
-    position = token->position;
-    value = token->floatValue;
+    os << indent << (isTail ? "└── " : "├── ");
+    os << value << std::endl;
 }
 
-ExprNode *FloatConstNode::Eval(Evaluator *evaluator)
+FloatConstNode::FloatConstNode(Token token)
 {
-    return evaluator->Eval(this);
+    nodeKind = NodeKind::FLOAT_CONST;
+    if (token.GetType() != TokenType::NUM_FLOAT) throw "";
+    type = Types.BuiltIn(BuiltInTypeKind::FLOAT);
+    position = token.GetPosition();
+    value = token.GetFloatValue();
 }
 
 float FloatConstNode::GetValue() const
@@ -72,38 +73,47 @@ void FloatConstNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void FloatConstNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::FLOAT_CONST);
+    description->Float(value);
+}
+
 FloatConstNode::FloatConstNode(float value)
 {
+    nodeKind = NodeKind::FLOAT_CONST;
     this->value = value;
+    type = Types.BuiltIn(BuiltInTypeKind::FLOAT);
 }
 
 void IdNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << token->text << std::endl;
+    os << token.GetText() << std::endl;
 }
 
-IdNode::IdNode(std::shared_ptr<Token> token): token(token)
+IdNode::IdNode(Token token): token(token)
 {
-    if (token->type != TokenType::ID) throw "";
+    nodeKind = NodeKind::ID;
+    if (token.GetType() != TokenType::ID) throw "";
     category = ValueCategory::LVAVLUE;
-    position = token->position;
+    position = token.GetPosition();
 }
 
-std::string IdNode::GetName() const
+const std::string &IdNode::GetName() const
 {
-    return token->stringValue;
+    return Identifiers.Spelling(token.GetNameId());
 }
 
-IdNode::IdNode(std::shared_ptr<Token> token, SymType *type): IdNode(token)
+NameId IdNode::GetNameId() const
 {
-    this->type = type;
-    position = token->position;
+    return token.GetNameId();
 }
 
-ExprNode *IdNode::Eval(Evaluator *evaluator)
+IdNode::IdNode(Token token, SymType *type): IdNode(token)
 {
-    return evaluator->Eval(this);
+    this->type = type;
+    position = token.GetPosition();
 }
 
 void IdNode::Generate(Asm::Assembly *assembly)
@@ -115,30 +125,28 @@ void IdNode::Generate(Asm::Assembly *assembly)
         auto vt = variable->GetType()->GetUnqualified();
         if (vt->GetTypeKind() == TypeKind::STRUCT && category == ValueCategory::RVALUE)
         {
+            // the image of the structure as it lies in memory, its first byte ends up at the top of the stack
             s.AddCommand(CommandName::LEA, MakeAddress(variable->GetOffset(), Register::EBP),
                          Register::EAX, CommandSuffix::L);
-            for (auto field: reinterpret_cast<SymRecord *>(vt)->GetOrderedFields())
-            {
-                auto ft = field->GetType()->GetUnqualified();
-                if (ft->GetTypeKind() == TypeKind::ARRAY)
-                    arrayGenerate(assembly, field->GetOffset(), reinterpret_cast<SymArray *>(ft));
-                else if (ft->GetTypeKind() == TypeKind::STRUCT)
-                    structureGenerate(assembly, field->GetOffset(), reinterpret_cast<SymRecord *>(ft));
-                else
-                    s.AddCommand(CommandName::PUSH, MakeAddress(field->GetOffset(), Register::EAX), CommandSuffix::L);
-            }
+            for (auto offset = vt->StackSize() - 4; offset >= 0; offset -= 4)
+                s.AddCommand(CommandName::PUSH, MakeAddress(offset, Register::EAX), CommandSuffix::L);
             return;
         }
         if (GetValueCategory() == ValueCategory::LVAVLUE || variable->GetType()->GetTypeKind() == TypeKind::ARRAY)
             s.AddCommand(CommandName::LEA, MakeAddress(variable->GetOffset(), Register::EBP),
                          Register::EAX, CommandSuffix::L);
         else
-            s.AddCommand(CommandName::MOV, MakeAddress(variable->GetOffset(), Register::EBP),
-                         Register::EAX, CommandSuffix::L);
+            load(s, vt, MakeAddress(variable->GetOffset(), Register::EBP), Register::EAX);
         s.AddCommand(CommandName::PUSH, Register::EAX, CommandSuffix::L);
     }
 }
 
+void IdNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::ID);
+    description->Lexeme(token);
+}
+
 void IdNode::SetVariable(SymVariable *variable)
 {
     this->variable = variable;
@@ -149,65 +157,31 @@ SymVariable *IdNode::GetVariable() const
     return variable;
 }
 
-void IdNode::arrayGenerate(Asm::Assembly *assembly, int32_t offset, SymArray *array)
-{
-    using namespace Asm;
-    Section &s = assembly->TextSection();
-    auto n =  array->NumberOfElements();
-    auto vt = array->GetValueType()->GetUnqualified();
-    auto elemSize = vt->Size();
-    for (int i = n - 1; i >= 0; i--)
-    {
-        if (vt->GetTypeKind() == TypeKind::ARRAY)
-            arrayGenerate(assembly, offset + i * elemSize, reinterpret_cast<SymArray *>(vt));
-        else if (vt->GetTypeKind() == TypeKind::STRUCT)
-            structureGenerate(assembly, offset + i * elemSize, reinterpret_cast<SymRecord *>(vt));
-        else
-            s.AddCommand(CommandName::PUSH, MakeAddress(offset + i * elemSize, Register::EAX), CommandSuffix::L);
-    }
-}
-
-void IdNode::structureGenerate(Asm::Assembly *assembly, int32_t offset, SymRecord *record)
-{
-    using namespace Asm;
-    Section &s = assembly->TextSection();
-    auto &fields = record->GetOrderedFields();
-    auto n =  fields.size();
-    for (int i = static_cast<int>(n - 1); i >= 0; i--)
-    {
-        auto ft = fields[i]->GetType()->GetUnqualified();
-        if (ft->GetTypeKind() == TypeKind::ARRAY)
-            arrayGenerate(assembly, offset + ft->Size(), reinterpret_cast<SymArray *>(ft));
-        else if (ft->GetTypeKind() == TypeKind::STRUCT)
-            structureGenerate(assembly, offset + ft->Size(), reinterpret_cast<SymRecord *>(ft));
-        else
-            s.AddCommand(CommandName::PUSH, MakeAddress(offset + ft->Size(), Register::EAX), CommandSuffix::L);
-    }
-}
-
 void StringLiteralNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << token->text << std::endl;
-}
-
-StringLiteralNode::StringLiteralNode(std::shared_ptr<Token> token): token(token)
-{
-    if (token->type != TokenType::STRING) throw "";
-    position = token->position;
-    this->type = new SymPointer(new SymBuiltInType(BuiltInTypeKind::INT8));
+    os << token.GetText() << std::endl;
 }
 
-ExprNode *StringLiteralNode::Eval(Evaluator *evaluator)
+StringLiteralNode::StringLiteralNode(Token token): token(token)
 {
-    return evaluator->Eval(this);
+    nodeKind = NodeKind::STRING_LITERAL;
+    if (token.GetType() != TokenType::STRING) throw "";
+    position = token.GetPosition();
+    this->type = Types.Pointer(Types.BuiltIn(BuiltInTypeKind::INT8));
 }
 
 void StringLiteralNode::Generate(Asm::Assembly *assembly)
 {
     address = assembly->NextLabel();
     assembly->DataSection().AddLabel(address);
-    assembly->DataSection().AddDirective(new Asm::AsmStringDirective(token->text));
+    assembly->DataSection().AddDirective(new Asm::AsmStringDirective(token.GetText()));
+}
+
+void StringLiteralNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::STRING_LITERAL);
+    description->Lexeme(token);
 }
 
 Asm::AsmLabel *StringLiteralNode::GetAddress() const
@@ -225,14 +199,10 @@ void PostfixIncrementNode::Print(std::ostream &os, std::string indent, bool isTa
 
 PostfixIncrementNode::PostfixIncrementNode(ExprNode *node) : expr(node)
 {
+    nodeKind = NodeKind::POSTFIX_INCREMENT;
     this->type = node->GetType();
 }
 
-ExprNode * PostfixIncrementNode::Eval(Evaluator *evaluator)
-{
-    evaluator->Eval(this);
-}
-
 void PostfixIncrementNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -259,6 +229,12 @@ void PostfixIncrementNode::Generate(Asm::Assembly *assembly)
     }
 }
 
+void PostfixIncrementNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::POSTFIX_INCREMENT);
+    description->Child(expr);
+}
+
 void PostfixDecrementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -269,14 +245,10 @@ void PostfixDecrementNode::Print(std::ostream &os, std::string indent, bool isTa
 
 PostfixDecrementNode::PostfixDecrementNode(ExprNode *node) : expr(node)
 {
+    nodeKind = NodeKind::POSTFIX_DECREMENT;
     this->type = node->GetType();
 }
 
-ExprNode *PostfixDecrementNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 void PostfixDecrementNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -303,6 +275,12 @@ void PostfixDecrementNode::Generate(Asm::Assembly *assembly)
     }
 }
 
+void PostfixDecrementNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::POSTFIX_DECREMENT);
+    description->Child(expr);
+}
+
 void StructureOrUnionMemberAccessNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -313,12 +291,7 @@ void StructureOrUnionMemberAccessNode::Print(std::ostream &os, std::string inden
 }
 
 StructureOrUnionMemberAccessNode::StructureOrUnionMemberAccessNode(ExprNode *structureOrUnion, IdNode *member) :
-        member(member), structureOrUnion(structureOrUnion) {}
-
-ExprNode *StructureOrUnionMemberAccessNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
+        member(member), structureOrUnion(structureOrUnion) { nodeKind = NodeKind::MEMBER_ACCESS; }
 
 void StructureOrUnionMemberAccessNode::Generate(Asm::Assembly *assembly)
 {
@@ -326,15 +299,22 @@ void StructureOrUnionMemberAccessNode::Generate(Asm::Assembly *assembly)
     auto &s = assembly->TextSection();
     structureOrUnion->Generate(assembly);
     s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    if (category == ValueCategory::LVAVLUE)
+    if (category == ValueCategory::LVAVLUE ||
+        member->GetVariable()->GetType()->GetUnqualified()->GetTypeKind() == TypeKind::ARRAY)
         s.AddCommand(CommandName::LEA, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX,
                      CommandSuffix::L);
     else
-        s.AddCommand(CommandName::MOV, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX,
-                     CommandSuffix::L);
+        load(s, type, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX);
     s.AddCommand(CommandName::PUSH, Register::EBX, CommandSuffix::L);
 }
 
+void StructureOrUnionMemberAccessNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::MEMBER_ACCESS);
+    description->Child(structureOrUnion);
+    description->Child(member);
+}
+
 void StructureOrUnionMemberAccessByPointerNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -346,11 +326,9 @@ void StructureOrUnionMemberAccessByPointerNode::Print(std::ostream &os, std::str
 
 StructureOrUnionMemberAccessByPointerNode::StructureOrUnionMemberAccessByPointerNode(ExprNode *structureOrUnion,
                                                                                      IdNode *member) : member(member),
-                                                                                                       structureOrUnion(structureOrUnion) {}
-
-ExprNode *StructureOrUnionMemberAccessByPointerNode::Eval(Evaluator *evaluator)
+                                                                                                       structureOrUnion(structureOrUnion)
 {
-    return evaluator->Eval(this);
+    nodeKind = NodeKind::MEMBER_ACCESS_BY_POINTER;
 }
 
 void StructureOrUnionMemberAccessByPointerNode::Generate(Asm::Assembly *assembly)
@@ -361,15 +339,22 @@ void StructureOrUnionMemberAccessByPointerNode::Generate(Asm::Assembly *assembly
     auto ptrType = reinterpret_cast<SymPointer *>(structureOrUnion->GetType()->GetUnqualified());
     auto target = ptrType->GetTarget();
     s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    if (category == ValueCategory::LVAVLUE)
+    if (category == ValueCategory::LVAVLUE ||
+        member->GetVariable()->GetType()->GetUnqualified()->GetTypeKind() == TypeKind::ARRAY)
         s.AddCommand(CommandName::LEA, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX,
                      CommandSuffix::L);
     else
-        s.AddCommand(CommandName::MOV, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX,
-                     CommandSuffix::L);
+        load(s, type, MakeAddress(member->GetVariable()->GetOffset(), Register::EAX), Register::EBX);
     s.AddCommand(CommandName::PUSH, Register::EBX, CommandSuffix::L);
 }
 
+void StructureOrUnionMemberAccessByPointerNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::MEMBER_ACCESS_BY_POINTER);
+    description->Child(structureOrUnion);
+    description->Child(member);
+}
+
 void PrefixIncrementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -380,14 +365,10 @@ void PrefixIncrementNode::Print(std::ostream &os, std::string indent, bool isTai
 
 PrefixIncrementNode::PrefixIncrementNode(ExprNode *node) : expr(node)
 {
+    nodeKind = NodeKind::PREFIX_INCREMENT;
     this->type = node->GetType();
 }
 
-ExprNode *PrefixIncrementNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 void PrefixIncrementNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -414,6 +395,12 @@ void PrefixIncrementNode::Generate(Asm::Assembly *assembly)
     }
 }
 
+void PrefixIncrementNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::PREFIX_INCREMENT);
+    description->Child(expr);
+}
+
 void PrefixDecrementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -424,14 +411,10 @@ void PrefixDecrementNode::Print(std::ostream &os, std::string indent, bool isTai
 
 PrefixDecrementNode::PrefixDecrementNode(ExprNode *node) : expr(node)
 {
+    nodeKind = NodeKind::PREFIX_DECREMENT;
     this->type = node->GetType();
 }
 
-ExprNode *PrefixDecrementNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 void PrefixDecrementNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -458,32 +441,39 @@ void PrefixDecrementNode::Generate(Asm::Assembly *assembly)
     }
 }
 
+void PrefixDecrementNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::PREFIX_DECREMENT);
+    description->Child(expr);
+}
+
+// Chains of binary operators and commas are parsed without recursion and can nest deeper than anything else,
+// their walks check the stack themselves.
+
 void BinOpNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
+    if (StackLeft() < StackReserve)
+        throw NestingTooDeepError(position);
     os << indent << (isTail ? "└── " : "├── ");
-    os << op->text << std::endl;
+    os << op.GetText() << std::endl;
     indent.append(isTail ? "    " : "│   ");
     left->Print(os, indent, false);
     right->Print(os, indent, true);
 }
 
-BinOpNode::BinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> op) : left(left), right(right), op(std::move(op))
+BinOpNode::BinOpNode(ExprNode *left, ExprNode *right, Token op) : left(left), right(right), op(std::move(op))
 {
+    nodeKind = NodeKind::BIN_OP;
     this->type = left->GetType();
-    this->position = this->op->position;
+    this->position = this->op.GetPosition();
 }
 
-BinOpNode::BinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> op, SymType *resultType):
+BinOpNode::BinOpNode(ExprNode *left, ExprNode *right, Token op, SymType *resultType):
         BinOpNode(left, right, std::move(op))
 {
     this->type = resultType;
 }
 
-ExprNode *BinOpNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 ExprNode *BinOpNode::Left() const
 {
     return left;
@@ -494,21 +484,26 @@ ExprNode *BinOpNode::Right() const
     return right;
 }
 
-std::shared_ptr<Token> BinOpNode::GetOperation() const
+Token BinOpNode::GetOperation() const
 {
     return op;
 }
 
 void BinOpNode::Generate(Asm::Assembly *assembly)
 {
+    if (StackLeft() < StackReserve)
+        throw NestingTooDeepError(position);
     left->Generate(assembly);
     auto ltk = left->GetType()->GetTypeKind();
-    if (op->type == TokenType::LOGIC_AND || op->type == TokenType::LOGIC_OR)
+    if (op.GetType() == TokenType::LOGIC_AND || op.GetType() == TokenType::LOGIC_OR)
         logicalAndOrGenerate(assembly);
     else if (ltk == TypeKind::BUILTIN)
     {
         switch (reinterpret_cast<SymBuiltInType *>(left->GetType()->GetUnqualified())->GetBuiltInTypeKind())
         {
+            // narrower integers are extended to 4 bytes on the stack
+            case BuiltInTypeKind::INT8: case BuiltInTypeKind::UINT8:
+            case BuiltInTypeKind::INT16: case BuiltInTypeKind::UINT16:
             case BuiltInTypeKind::INT32:
                 int32Generate(assembly);
                 break;
@@ -521,6 +516,14 @@ void BinOpNode::Generate(Asm::Assembly *assembly)
         pointerGenerate(assembly);
 }
 
+void BinOpNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::BIN_OP);
+    description->Lexeme(op);
+    description->Child(left);
+    description->Child(right);
+}
+
 void BinOpNode::int32Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -537,25 +540,25 @@ void BinOpNode::int32Generate(Asm::Assembly *assembly)
             {TokenType::FORWARD_SLASH, CommandName::IDIV}, {TokenType::REMINDER, CommandName::IDIV}
     };
     right->Generate(assembly);
-    section.AddCommand(CommandName::POP, op->type == TokenType::BITWISE_LSHIFT || op->type == TokenType::BITWISE_RSHIFT ?
+    section.AddCommand(CommandName::POP, op.GetType() == TokenType::BITWISE_LSHIFT || op.GetType() == TokenType::BITWISE_RSHIFT ?
                                          Register::ECX : Register::EBX, CommandSuffix::L);
     section.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    if (op->type == TokenType::FORWARD_SLASH || op->type == TokenType::REMINDER)
+    if (op.GetType() == TokenType::FORWARD_SLASH || op.GetType() == TokenType::REMINDER)
     {
         section.AddCommand(CommandName::XOR, Register::EDX, Register::EDX, CommandSuffix::L);
         section.AddCommand(CommandName::IDIV, Register::EBX, CommandSuffix::L);
     }
-    else if (isRelop(op->type))
+    else if (isRelop(op.GetType()))
     {
         section.AddCommand(CommandName::CMP, Register::EBX, Register::EAX, CommandSuffix::L);
-        section.AddCommand(optoasm[op->type], Register::BL);
+        section.AddCommand(optoasm[op.GetType()], Register::BL);
         section.AddCommand(CommandName::MOVZX, Register::BL, Register::EAX);
     }
-    else if (op->type == TokenType::BITWISE_LSHIFT || op->type == TokenType::BITWISE_RSHIFT)
-        section.AddCommand(optoasm[op->type], Register::CL, Register::EAX, CommandSuffix::L);
+    else if (op.GetType() == TokenType::BITWISE_LSHIFT || op.GetType() == TokenType::BITWISE_RSHIFT)
+        section.AddCommand(optoasm[op.GetType()], Register::CL, Register::EAX, CommandSuffix::L);
     else
-        section.AddCommand(optoasm[op->type], Register::EBX, Register::EAX, CommandSuffix::L);
-    section.AddCommand(CommandName::PUSH, op->type == TokenType::REMINDER ? Register::EDX : Register::EAX,
+        section.AddCommand(optoasm[op.GetType()], Register::EBX, Register::EAX, CommandSuffix::L);
+    section.AddCommand(CommandName::PUSH, op.GetType() == TokenType::REMINDER ? Register::EDX : Register::EAX,
                        CommandSuffix::L);
 }
 
@@ -576,17 +579,17 @@ void BinOpNode::floatGenerate(Asm::Assembly *assembly)
     section.AddCommand(CommandName::FLD, MakeAddress(Register::ESP), CommandSuffix::S);
     section.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
     section.AddCommand(CommandName::FLD, MakeAddress(Register::ESP), CommandSuffix::S);
-    if (isRelop(op->type))
+    if (isRelop(op.GetType()))
     {
         section.AddCommand(CommandName::FCOMIP);
         section.AddCommand(CommandName::FSTP, Register::ST0);
-        section.AddCommand(optoasm[op->type], Register::BL);
+        section.AddCommand(optoasm[op.GetType()], Register::BL);
         section.AddCommand(CommandName::MOVZX, Register::BL, Register::EAX);
         section.AddCommand(CommandName::MOV, Register::EAX, MakeAddress(Register::ESP), CommandSuffix::L);
     }
     else
     {
-        section.AddCommand(optoasm[op->type]);
+        section.AddCommand(optoasm[op.GetType()]);
         section.AddCommand(CommandName::FSTP, MakeAddress(Register::ESP), CommandSuffix::S);
     }
 }
@@ -597,20 +600,20 @@ void BinOpNode::logicalAndOrGenerate(Asm::Assembly *assembly)
     Section &section = assembly->TextSection();
     auto l1 = assembly->NextLabel(), l2 = assembly->NextLabel();
     auto ltype = left->GetType(), rtype = right->GetType();
-    auto jmpCommand = op->type == TokenType::LOGIC_AND ? Asm::CommandName::JE : Asm::CommandName::JNE;
-    if (ltype->GetTypeKind() == TypeKind::POINTER) ltype = new SymBuiltInType(BuiltInTypeKind::INT32);
-    if (rtype->GetTypeKind() == TypeKind::POINTER) rtype = new SymBuiltInType(BuiltInTypeKind::INT32);
-    static std::unordered_map<BuiltInTypeKind, std::function<void()>> bttoasm =
+    auto jmpCommand = op.GetType() == TokenType::LOGIC_AND ? Asm::CommandName::JE : Asm::CommandName::JNE;
+    if (ltype->GetTypeKind() == TypeKind::POINTER) ltype = Types.BuiltIn(BuiltInTypeKind::INT32);
+    if (rtype->GetTypeKind() == TypeKind::POINTER) rtype = Types.BuiltIn(BuiltInTypeKind::INT32);
+    static std::unordered_map<BuiltInTypeKind, std::function<void(Section &)>> bttoasm =
     {
             {BuiltInTypeKind::INT32,
-            [&]()
+            [](Section &section)
                  {
                      section.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
                      section.AddCommand(CommandName::CMP, ConstNode::IntZero(), Register::EAX, CommandSuffix::L);
                  }
             },
             {BuiltInTypeKind::FLOAT,
-            [&]()
+            [](Section &section)
                 {
                     section.AddCommand(CommandName::FLD, MakeAddress(Register::ESP), CommandSuffix::S);
                     section.AddCommand(CommandName::FLDZ);
@@ -622,11 +625,11 @@ void BinOpNode::logicalAndOrGenerate(Asm::Assembly *assembly)
 
     };
     if (ltype->GetTypeKind() == TypeKind::BUILTIN)
-        bttoasm[reinterpret_cast<SymBuiltInType *>(ltype)->GetBuiltInTypeKind()]();
+        bttoasm[reinterpret_cast<SymBuiltInType *>(ltype)->GetBuiltInTypeKind()](section);
     section.AddCommand(jmpCommand, l1);
     right->Generate(assembly);
     if (rtype->GetTypeKind() == TypeKind::BUILTIN)
-        bttoasm[reinterpret_cast<SymBuiltInType *>(rtype)->GetBuiltInTypeKind()]();
+        bttoasm[reinterpret_cast<SymBuiltInType *>(rtype)->GetBuiltInTypeKind()](section);
     section.AddCommand(jmpCommand, l1);
     section.AddCommand(CommandName::PUSH, ConstNode::IntOne(), CommandSuffix::L);
     section.AddCommand(CommandName::JMP, l2);
@@ -650,10 +653,10 @@ void BinOpNode::pointerGenerate(Asm::Assembly *assembly)
     section.AddCommand(CommandName::POP, Register::EBX, CommandSuffix::L);
     section.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
     auto target = reinterpret_cast<SymPointer *>(type)->GetTarget();
-    if (op->type == TokenType::PLUS || (op->type == TokenType::MINUS && rtype->GetTypeKind() != TypeKind::POINTER))
+    if (op.GetType() == TokenType::PLUS || (op.GetType() == TokenType::MINUS && rtype->GetTypeKind() != TypeKind::POINTER))
     {
-        if (op->type == TokenType::MINUS) section.AddCommand(CommandName::NEG, Register::EBX, CommandSuffix::L);
-        section.AddCommand(CommandName::LEA, MakeAddress(0, Register::EAX, Register::EBX, target->Size()),
+        if (op.GetType() == TokenType::MINUS) section.AddCommand(CommandName::NEG, Register::EBX, CommandSuffix::L);
+        section.AddCommand(CommandName::LEA, MakeAddress(0, Register::EAX, Register::EBX, scale(section, target, Register::EBX)),
                            Register::EAX, CommandSuffix::L);
     }
     else
@@ -676,12 +679,7 @@ void ArrayAccessNode::Print(std::ostream &os, std::string indent, bool isTail)
     index->Print(os, indent, true);
 }
 
-ArrayAccessNode::ArrayAccessNode(ExprNode *left, ExprNode *inBrackets) : array(left), index(inBrackets) {}
-
-ExprNode *ArrayAccessNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
+ArrayAccessNode::ArrayAccessNode(ExprNode *left, ExprNode *inBrackets) : array(left), index(inBrackets) { nodeKind = NodeKind::ARRAY_ACCESS; }
 
 void ArrayAccessNode::Generate(Asm::Assembly *assembly)
 {
@@ -691,16 +689,27 @@ void ArrayAccessNode::Generate(Asm::Assembly *assembly)
     index->Generate(assembly);
     s.AddCommand(CommandName::POP, Register::ESI, CommandSuffix ::L);
     s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    s.AddCommand(CommandName::LEA, MakeAddress(0, Register::EAX, Register::ESI, type->Size()), Register::EBX, CommandSuffix::L);
+    s.AddCommand(CommandName::LEA, MakeAddress(0, Register::EAX, Register::ESI, scale(s, type, Register::ESI)),
+                 Register::EBX, CommandSuffix::L);
     if (category == ValueCategory::LVAVLUE || type->GetTypeKind() == TypeKind::ARRAY)
         s.AddCommand(CommandName::PUSH, Register::EBX, CommandSuffix::L);
     else
     {
         if (type->GetTypeKind() == TypeKind::BUILTIN)
-            s.AddCommand(CommandName::PUSH, MakeAddress(Register::EBX), CommandSuffix::L);
+        {
+            load(s, type, MakeAddress(Register::EBX), Register::EAX);
+            s.AddCommand(CommandName::PUSH, Register::EAX, CommandSuffix::L);
+        }
     }
 }
 
+void ArrayAccessNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::ARRAY_ACCESS);
+    description->Child(array);
+    description->Child(index);
+}
+
 void TernaryOperatorNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -714,12 +723,23 @@ void TernaryOperatorNode::Print(std::ostream &os, std::string indent, bool isTai
 TernaryOperatorNode::TernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse) :
         condition(condition), iftrue(iftrue), iffalse(iffalse)
 {
+    nodeKind = NodeKind::TERNARY;
     this->type = iftrue->GetType();
 }
 
-ExprNode *TernaryOperatorNode::Eval(Evaluator *evaluator)
+ExprNode *TernaryOperatorNode::Condition() const
+{
+    return condition;
+}
+
+ExprNode *TernaryOperatorNode::IfTrue() const
 {
-    return evaluator->Eval(this);
+    return iftrue;
+}
+
+ExprNode *TernaryOperatorNode::IfFalse() const
+{
+    return iffalse;
 }
 
 void TernaryOperatorNode::Generate(Asm::Assembly *assembly)
@@ -727,27 +747,31 @@ void TernaryOperatorNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void TernaryOperatorNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::TERNARY);
+    description->Child(condition);
+    description->Child(iftrue);
+    description->Child(iffalse);
+}
+
 
 void AssignmentNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << assignmentOp->stringValue << std::endl;
+    os << assignmentOp.GetText() << std::endl;
     indent.append(isTail ? "    " : "│   ");
     left->Print(os, indent, false);
     right->Print(os, indent, true);
 }
 
-AssignmentNode::AssignmentNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> assignmentOp) : left(left), right(right),
+AssignmentNode::AssignmentNode(ExprNode *left, ExprNode *right, Token assignmentOp) : left(left), right(right),
                                                                                                        assignmentOp(std::move(assignmentOp))
 {
+    nodeKind = NodeKind::ASSIGNMENT;
     this->type = left->GetType();
 }
 
-ExprNode *AssignmentNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 void AssignmentNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -757,68 +781,22 @@ void AssignmentNode::Generate(Asm::Assembly *assembly)
     s.AddCommand(CommandName::POP, Register::EBX, CommandSuffix::L);
     if (right->GetType()->GetTypeKind() == TypeKind::STRUCT)
     {
-        auto rt = reinterpret_cast<SymRecord *>(right->GetType()->GetUnqualified());
-        auto &fields = rt->GetOrderedFields();
-        for (auto it = fields.begin(); it != fields.end(); it++)
-        {
-            auto ft = (*it)->GetType()->GetUnqualified();
-            if (ft->GetTypeKind() == TypeKind::ARRAY)
-                assignArray(assembly, (*it)->GetOffset(), reinterpret_cast<SymArray *>(ft));
-            else if (ft->GetTypeKind() == TypeKind::STRUCT)
-                assignStructure(assembly, (*it)->GetOffset(), reinterpret_cast<SymRecord *>(ft));
-            else
-            {
-                s.AddCommand(CommandName::MOV, MakeAddress((*it)->GetOffset(), Register::ESP), Register::EAX, CommandSuffix::L);
-                s.AddCommand(CommandName::MOV, Register::EAX, MakeAddress((*it)->GetOffset(), Register::EBX), CommandSuffix::L);
-            }
-        }
+        // the image of the right structure stays on the stack as the value of the assignment
+        CopyImage(s, right->GetType()->Size(), Register::EBX, 0);
         return;
     }
     s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    s.AddCommand(CommandName::MOV, Register::EAX, MakeAddress(Register::EBX), CommandSuffix::L);
-    s.AddCommand(CommandName::PUSH, MakeAddress(Register::EBX), CommandSuffix::L);
+    store(s, type, MakeAddress(Register::EBX));
+    load(s, type, MakeAddress(Register::EBX), Register::EAX);
+    s.AddCommand(CommandName::PUSH, Register::EAX, CommandSuffix::L);
 }
 
-void AssignmentNode::assignArray(Asm::Assembly *assembly, int32_t offset, SymArray *array)
+void AssignmentNode::Describe(NodeDescription *description)
 {
-    using namespace Asm;
-    Section &s = assembly->TextSection();
-    auto n =  array->NumberOfElements();
-    auto vt = array->GetValueType()->GetUnqualified();
-    auto elemSize = vt->Size();
-    for (int i = 0; i < n; i++)
-    {
-        offset += i * elemSize;
-        if (vt->GetTypeKind() == TypeKind::ARRAY)
-            assignArray(assembly, offset, reinterpret_cast<SymArray *>(vt));
-        else if (vt->GetTypeKind() == TypeKind::STRUCT)
-            assignStructure(assembly, offset, reinterpret_cast<SymRecord *>(vt));
-        else
-        {
-            s.AddCommand(CommandName::MOV, MakeAddress(offset, Register::ESP), Register::EAX, CommandSuffix::L);
-            s.AddCommand(CommandName::MOV, Register::EAX, MakeAddress(offset, Register::EBX), CommandSuffix::L);
-        }
-    }
-
-}
-
-void AssignmentNode::assignStructure(Asm::Assembly *assembly, int32_t offset, SymRecord *record)
-{
-    using namespace Asm;
-    Section &s = assembly->TextSection();
-    for (auto field: record->GetOrderedFields())
-    {
-        auto ft = field->GetType()->GetUnqualified();
-        if (ft->GetTypeKind() == TypeKind::ARRAY)
-            assignArray(assembly, offset + field->GetOffset(), reinterpret_cast<SymArray *>(ft));
-        else if (ft->GetTypeKind() == TypeKind::STRUCT)
-            assignStructure(assembly, offset + field->GetOffset(), reinterpret_cast<SymRecord *>(ft));
-        else
-        {
-            s.AddCommand(CommandName::MOV, MakeAddress(offset + field->GetOffset(), Register::ESP), Register::EAX, CommandSuffix::L);
-            s.AddCommand(CommandName::MOV, Register::EAX, MakeAddress(offset + field->GetOffset(), Register::EBX), CommandSuffix::L);
-        }
-    }
+    describe(description, NodeKind::ASSIGNMENT);
+    description->Lexeme(assignmentOp);
+    description->Child(left);
+    description->Child(right);
 }
 
 void TypeCastNode::Print(std::ostream &os, std::string indent, bool isTail)
@@ -832,12 +810,13 @@ void TypeCastNode::Print(std::ostream &os, std::string indent, bool isTail)
 
 TypeCastNode::TypeCastNode(SymType *type, ExprNode *castExpr) : castType(type), castExpr(castExpr)
 {
+    nodeKind = NodeKind::TYPE_CAST;
     this->type = type;
 }
 
-ExprNode *TypeCastNode::Eval(Evaluator *evaluator)
+ExprNode *TypeCastNode::Operand() const
 {
-    return evaluator->Eval(this);
+    return castExpr;
 }
 
 void TypeCastNode::Generate(Asm::Assembly *assembly)
@@ -853,31 +832,45 @@ void TypeCastNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void TypeCastNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::TYPE_CAST);
+    description->Child(castExpr);
+}
+
 void UnaryOpNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << unaryOp->stringValue << std::endl;
+    os << unaryOp.GetText() << std::endl;
     indent.append(isTail ? "    " : "│   ");
     expr->Print(os, indent, true);
 }
 
-UnaryOpNode::UnaryOpNode(std::shared_ptr<Token> unaryOp, ExprNode *expr) : unaryOp(unaryOp), expr(expr)
+UnaryOpNode::UnaryOpNode(Token unaryOp, ExprNode *expr) : unaryOp(unaryOp), expr(expr)
 {
-    position = unaryOp->position;
+    nodeKind = NodeKind::UNARY_OP;
+    position = unaryOp.GetPosition();
 }
 
-ExprNode *UnaryOpNode::Eval(Evaluator *evaluator)
+ExprNode *UnaryOpNode::Operand() const
 {
-    return evaluator->Eval(this);
+    return expr;
+}
+
+Token UnaryOpNode::GetOperation() const
+{
+    return unaryOp;
 }
 
 void UnaryOpNode::Generate(Asm::Assembly *assembly)
 {
     expr->Generate(assembly);
-    if (unaryOp->type == TokenType::BITWISE_AND) return;
+    if (unaryOp.GetType() == TokenType::BITWISE_AND) return;
     if (expr->GetType()->GetTypeKind() == TypeKind::BUILTIN)
         switch (reinterpret_cast<SymBuiltInType *>(expr->GetType()->GetUnqualified())->GetBuiltInTypeKind())
         {
+            case BuiltInTypeKind::INT8: case BuiltInTypeKind::UINT8:
+            case BuiltInTypeKind::INT16: case BuiltInTypeKind::UINT16:
             case BuiltInTypeKind::INT32:
                 int32Generate(assembly);
                 break;
@@ -889,12 +882,19 @@ void UnaryOpNode::Generate(Asm::Assembly *assembly)
         pointerGenerate(assembly);
 }
 
+void UnaryOpNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::UNARY_OP);
+    description->Lexeme(unaryOp);
+    description->Child(expr);
+}
+
 void UnaryOpNode::int32Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
     Section &section = assembly->TextSection();
     section.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-    switch (unaryOp->type)
+    switch (unaryOp.GetType())
     {
         case TokenType::MINUS:
             section.AddCommand(CommandName::NEG, Register::EAX, CommandSuffix::L);
@@ -916,7 +916,7 @@ void UnaryOpNode::floatGenerate(Asm::Assembly *assembly)
     using namespace Asm;
     Section &section = assembly->TextSection();
     section.AddCommand(CommandName::FLD, MakeAddress(Register::ESP), CommandSuffix::S);
-    switch (unaryOp->type)
+    switch (unaryOp.GetType())
     {
         case TokenType::MINUS:
             section.AddCommand(CommandName::FCHS);
@@ -944,7 +944,7 @@ void UnaryOpNode::pointerGenerate(Asm::Assembly *assembly)
         && category == ValueCategory::RVALUE)
     {
         s.AddCommand(CommandName::POP, Register::EBX, CommandSuffix::L);
-        s.AddCommand(CommandName::MOV, MakeAddress(Register::EBX), Register::EAX, CommandSuffix::L);
+        load(s, target, MakeAddress(Register::EBX), Register::EAX);
         s.AddCommand(CommandName::PUSH, Register::EAX, CommandSuffix::L);
     }
 
@@ -958,11 +958,15 @@ void SizeofExprNode::Print(std::ostream &os, std::string indent, bool isTail)
     expr->Print(os, indent, true);
 }
 
-SizeofExprNode::SizeofExprNode(ExprNode *expr) : expr(expr) {}
+SizeofExprNode::SizeofExprNode(ExprNode *expr) : expr(expr)
+{
+    nodeKind = NodeKind::SIZEOF_EXPR;
+    type = Types.BuiltIn(BuiltInTypeKind::UINT32);
+}
 
-ExprNode *SizeofExprNode::Eval(Evaluator *evaluator)
+ExprNode *SizeofExprNode::Operand() const
 {
-    return evaluator->Eval(this);
+    return expr;
 }
 
 void SizeofExprNode::Generate(Asm::Assembly *assembly)
@@ -970,6 +974,12 @@ void SizeofExprNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void SizeofExprNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::SIZEOF_EXPR);
+    description->Child(expr);
+}
+
 void SizeofTypeNameNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -978,11 +988,15 @@ void SizeofTypeNameNode::Print(std::ostream &os, std::string indent, bool isTail
     typeName->Print(os, indent, true);
 }
 
-SizeofTypeNameNode::SizeofTypeNameNode(SymType *typeName) : typeName(typeName) {}
+SizeofTypeNameNode::SizeofTypeNameNode(SymType *typeName) : typeName(typeName)
+{
+    nodeKind = NodeKind::SIZEOF_TYPE;
+    type = Types.BuiltIn(BuiltInTypeKind::UINT32);
+}
 
-ExprNode *SizeofTypeNameNode::Eval(Evaluator *evaluator)
+SymType *SizeofTypeNameNode::GetTypeName() const
 {
-    return evaluator->Eval(this);
+    return typeName;
 }
 
 void SizeofTypeNameNode::Generate(Asm::Assembly *assembly)
@@ -990,8 +1004,16 @@ void SizeofTypeNameNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void SizeofTypeNameNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::SIZEOF_TYPE);
+    description->Source(this);
+}
+
 void CommaSeparatedExprs::Print(std::ostream &os, std::string indent, bool isTail)
 {
+    if (StackLeft() < StackReserve)
+        throw NestingTooDeepError(expressions.front()->GetPosition());
     os << indent << (isTail ? "└── " : "├── ");
     os << "," << std::endl;
     indent.append(isTail ? "    " : "│   ");
@@ -1002,13 +1024,10 @@ void CommaSeparatedExprs::Print(std::ostream &os, std::string indent, bool isTai
     (*it)->Print(os, indent, true);
 }
 
-ExprNode *CommaSeparatedExprs::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
-
 void CommaSeparatedExprs::Generate(Asm::Assembly *assembly)
 {
+    if (StackLeft() < StackReserve)
+        throw NestingTooDeepError(expressions.front()->GetPosition());
     auto it = expressions.begin();
     for (; it != --expressions.end(); it++)
     {
@@ -1018,6 +1037,13 @@ void CommaSeparatedExprs::Generate(Asm::Assembly *assembly)
     expressions.back()->Generate(assembly);
 }
 
+void CommaSeparatedExprs::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::COMMA);
+    for (auto expr: expressions)
+        description->Child(expr);
+}
+
 void CommaSeparatedExprs::Add(ExprNode *expr)
 {
     expressions.push_back(expr);
@@ -1064,26 +1090,23 @@ void ExprStatmentNode::Print(std::ostream &os, std::string indent, bool isTail)
     if (expr) expr->Print(os, indent, true);
 }
 
-ExprStatmentNode::ExprStatmentNode(ExprNode *expr) : expr(expr) {}
+ExprStatmentNode::ExprStatmentNode(ExprNode *expr) : expr(expr) { nodeKind = NodeKind::EXPR_STATEMENT; }
 
 void ExprStatmentNode::Generate(Asm::Assembly *assembly)
 {
-    using namespace Asm;
-    auto &s = assembly->TextSection();
     if (expr)
     {
         expr->Generate(assembly);
-        auto etype = expr->GetType()->GetUnqualified();
-        if (etype->GetTypeKind() == TypeKind::POINTER || etype->GetTypeKind() == TypeKind::BUILTIN)
-        {
-            if (etype->GetTypeKind() == TypeKind::BUILTIN &&
-                    reinterpret_cast<SymBuiltInType *>(etype)->GetBuiltInTypeKind() == BuiltInTypeKind::VOID)
-                return;
-            s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
-        }
+        CleanStackAfterExpression(expr, assembly);
     }
 }
 
+void ExprStatmentNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::EXPR_STATEMENT);
+    description->Child(expr);
+}
+
 void ExprStatmentNode::CleanStackAfterExpression(ExprNode *expr, Asm::Assembly *assembly)
 {
     using namespace Asm;
@@ -1098,8 +1121,7 @@ void ExprStatmentNode::CleanStackAfterExpression(ExprNode *expr, Asm::Assembly *
     }
     else if (etype->GetTypeKind() == TypeKind::STRUCT)
     {
-        auto rt = reinterpret_cast<SymRecord *>(etype);
-        s.AddCommand(CommandName::ADD, new IntConstNode(rt->Size()), Register::ESP, CommandSuffix::L);
+        s.AddCommand(CommandName::ADD, new IntConstNode(etype->StackSize()), Register::ESP, CommandSuffix::L);
     }
 }
 
@@ -1124,7 +1146,14 @@ void IfStatementNode::Generate(Asm::Assembly *assembly)
     s.AddLabel(outLabel);
 }
 
-IfStatementNode::IfStatementNode(ExprNode *expr, StatementNode *then) : condition(expr), body(then) {}
+void IfStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::IF);
+    description->Child(condition);
+    description->Child(body);
+}
+
+IfStatementNode::IfStatementNode(ExprNode *expr, StatementNode *then) : condition(expr), body(then) { nodeKind = NodeKind::IF; }
 
 void IfElseStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
@@ -1137,7 +1166,7 @@ void IfElseStatementNode::Print(std::ostream &os, std::string indent, bool isTai
 }
 
 IfElseStatementNode::IfElseStatementNode(ExprNode *expr, StatementNode *then, StatementNode *_else) :
-        IfStatementNode(expr, then), elseBody(_else) {}
+        IfStatementNode(expr, then), elseBody(_else) { nodeKind = NodeKind::IF_ELSE; }
 
 void IfElseStatementNode::Generate(Asm::Assembly *assembly)
 {
@@ -1155,6 +1184,14 @@ void IfElseStatementNode::Generate(Asm::Assembly *assembly)
     s.AddLabel(outLabel);
 }
 
+void IfElseStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::IF_ELSE);
+    description->Child(condition);
+    description->Child(body);
+    description->Child(elseBody);
+}
+
 void GotoStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1163,13 +1200,19 @@ void GotoStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
     id->Print(os, indent, true);
 }
 
-GotoStatementNode::GotoStatementNode(IdNode *id) : id(id) {}
+GotoStatementNode::GotoStatementNode(IdNode *id) : id(id) { nodeKind = NodeKind::GOTO; }
 
 void GotoStatementNode::Generate(Asm::Assembly *assembly)
 {
     // TODO
 }
 
+void GotoStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::GOTO);
+    description->Child(id);
+}
+
 void ContinueStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1181,6 +1224,11 @@ void ContinueStatementNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void ContinueStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::CONTINUE);
+}
+
 void BreakStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1192,6 +1240,11 @@ void BreakStatementNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
+void BreakStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::BREAK);
+}
+
 void ReturnStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1200,7 +1253,7 @@ void ReturnStatementNode::Print(std::ostream &os, std::string indent, bool isTai
     if (expr) expr->Print(os, indent, true);
 }
 
-ReturnStatementNode::ReturnStatementNode(ExprNode *expr, SymFunction *function) : expr(expr), function(function) {}
+ReturnStatementNode::ReturnStatementNode(ExprNode *expr, SymFunction *function) : expr(expr), function(function) { nodeKind = NodeKind::RETURN; }
 
 void ReturnStatementNode::Generate(Asm::Assembly *assembly)
 {
@@ -1213,9 +1266,17 @@ void ReturnStatementNode::Generate(Asm::Assembly *assembly)
     {
         s.AddCommand(CommandName::POP, Register::EAX, CommandSuffix::L);
     }
+    else if (etype->GetTypeKind() == TypeKind::STRUCT)
+        ExprNode::CopyImage(s, etype->Size(), Register::EBP, function->GetReturnObjectOffset());
     s.AddCommand(CommandName::JMP, function->GetReturnLabel());
 }
 
+void ReturnStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::RETURN);
+    description->Child(expr);
+}
+
 void WhileStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1227,6 +1288,7 @@ void WhileStatementNode::Print(std::ostream &os, std::string indent, bool isTail
 
 WhileStatementNode::WhileStatementNode(ExprNode *condition, StatementNode *body)
 {
+    nodeKind = NodeKind::WHILE;
     this->condition = condition;
     this->body = body;
 }
@@ -1245,6 +1307,13 @@ void WhileStatementNode::Generate(Asm::Assembly *assembly)
     s.AddLabel(breakLabel);
 }
 
+void WhileStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::WHILE);
+    description->Child(condition);
+    description->Child(body);
+}
+
 void DoWhileStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1256,6 +1325,7 @@ void DoWhileStatementNode::Print(std::ostream &os, std::string indent, bool isTa
 
 DoWhileStatementNode::DoWhileStatementNode(ExprNode *condition, StatementNode *body)
 {
+    nodeKind = NodeKind::DO_WHILE;
     this->condition = condition;
     this->body = body;
 }
@@ -1280,6 +1350,13 @@ void DoWhileStatementNode::Generate(Asm::Assembly *assembly)
     s.AddLabel(breakLabel);
 }
 
+void DoWhileStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::DO_WHILE);
+    description->Child(body);
+    description->Child(condition);
+}
+
 void ForStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1304,6 +1381,7 @@ void ForStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 ForStatementNode::ForStatementNode(ExprNode *init, ExprNode *condition, ExprNode *iteration,
                                    StatementNode *body) : init(init), iteration(iteration)
 {
+    nodeKind = NodeKind::FOR;
     this->condition = condition;
     this->body = body;
 }
@@ -1335,6 +1413,15 @@ void ForStatementNode::Generate(Asm::Assembly *assembly)
     s.AddLabel(breakLabel);
 }
 
+void ForStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::FOR);
+    description->Child(init);
+    description->Child(condition);
+    description->Child(iteration);
+    description->Child(body);
+}
+
 
 void LabelStatementNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
@@ -1345,13 +1432,20 @@ void LabelStatementNode::Print(std::ostream &os, std::string indent, bool isTail
     statement->Print(os, indent, true);
 }
 
-LabelStatementNode::LabelStatementNode(IdNode *labelName, StatementNode *statement) : labelName(labelName), statement(statement) {}
+LabelStatementNode::LabelStatementNode(IdNode *labelName, StatementNode *statement) : labelName(labelName), statement(statement) { nodeKind = NodeKind::LABEL; }
 
 void LabelStatementNode::Generate(Asm::Assembly *assembly)
 {
     // TODO
 }
 
+void LabelStatementNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::LABEL);
+    description->Child(labelName);
+    description->Child(statement);
+}
+
 void DeclaratorNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -1432,7 +1526,7 @@ int32_t ArgumentExprListNode::GetArgumentsSize()
     if (!this) return 0;
     int32_t res = 0;
     for (auto expr: list)
-        res += expr->GetType()->Size();
+        res += expr->GetType()->StackSize();
     return res;
 }
 
@@ -1451,22 +1545,18 @@ void FunctionCallNode::Print(std::ostream &os, std::string indent, bool isTail)
 }
 
 FunctionCallNode::FunctionCallNode(ExprNode *function, ArgumentExprListNode *arguments) :
-        function(function), arguments(arguments) {}
-
-ExprNode *FunctionCallNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
-}
+        function(function), arguments(arguments) { nodeKind = NodeKind::FUNCTION_CALL; }
 
 void FunctionCallNode::Generate(Asm::Assembly *assembly)
 {
     using namespace Asm;
     auto &s = assembly->TextSection();
     auto t = reinterpret_cast<SymFunction *>(function->GetType()->GetUnqualified());
-    if (arguments) arguments->Generate(assembly);
     auto rt = t->GetReturnType()->GetUnqualified();
+    // the returned structure is left in its slot above the arguments, on the top of the stack once they are gone
     if (rt->GetTypeKind() == TypeKind::STRUCT)
-        s.AddCommand(CommandName::SUB, new IntConstNode(rt->Size()), Register::ESP, CommandSuffix::L);
+        s.AddCommand(CommandName::SUB, new IntConstNode(rt->StackSize()), Register::ESP, CommandSuffix::L);
+    if (arguments) arguments->Generate(assembly);
     s.AddCommand(CommandName::CALL, t->GetLabel());
     if (t->GetArgumentsStorageSize())
         s.AddCommand(CommandName::ADD, new IntConstNode(t->GetArgumentsStorageSize()), Register::ESP, CommandSuffix::L);
@@ -1474,6 +1564,14 @@ void FunctionCallNode::Generate(Asm::Assembly *assembly)
         s.AddCommand(CommandName::PUSH, Register::EAX, CommandSuffix::L);
 }
 
+void FunctionCallNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::FUNCTION_CALL);
+    description->Child(function);
+    for (auto argument: arguments->List())
+        description->Child(argument);
+}
+
 void DeclarationSpecifiersNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     if (list.empty()) return;
@@ -1659,11 +1757,18 @@ void CompoundStatement::Print(std::ostream &os, std::string indent, bool isTail)
     if (blockItemList) blockItemList->Print(os, indent, true);
 }
 
-CompoundStatement::CompoundStatement(BlockItemListNode *blockItemList) : blockItemList(blockItemList) {}
+CompoundStatement::CompoundStatement(BlockItemListNode *blockItemList) : blockItemList(blockItemList) { nodeKind = NodeKind::COMPOUND; }
 
 void CompoundStatement::Generate(Asm::Assembly *assembly)
 {
-    blockItemList->Generate(assembly);
+    if (blockItemList) blockItemList->Generate(assembly);
+}
+
+void CompoundStatement::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::COMPOUND);
+    for (auto item: blockItemList->List())
+        description->Child(item->GetDeclOrStatement());
 }
 
 void BlockItemNode::Print(std::ostream &os, std::string indent, bool isTail)
@@ -1676,6 +1781,11 @@ void BlockItemNode::Print(std::ostream &os, std::string indent, bool isTail)
 
 BlockItemNode::BlockItemNode(Node *declOrStatement) : declOrStatement(declOrStatement) {}
 
+Node *BlockItemNode::GetDeclOrStatement() const
+{
+    return declOrStatement;
+}
+
 void BlockItemNode::Generate(Asm::Assembly *assembly)
 {
     // TODO
@@ -1686,6 +1796,11 @@ uint64_t BlockItemListNode::Size()
     return list.size();
 }
 
+std::list<BlockItemNode *> &BlockItemListNode::List()
+{
+    return list;
+}
+
 void BlockItemListNode::Add(BlockItemNode *blockItem)
 {
     list.push_back(blockItem);
@@ -1804,12 +1919,8 @@ IdNode *EnumeratorNode::GetId()
 EnumeratorNode::EnumeratorNode(IdNode *enumerationConstant, ExprNode *value) :
         enumerationConstant(enumerationConstant), value(value)
 {
-    this->type = new SymBuiltInType(BuiltInTypeKind::INT32);
-}
-
-ExprNode *EnumeratorNode::Eval(Evaluator *evaluator)
-{
-    return evaluator->Eval(this);
+    nodeKind = NodeKind::ENUMERATOR;
+    this->type = Types.BuiltIn(BuiltInTypeKind::INT32);
 }
 
 void EnumeratorNode::Generate(Asm::Assembly *assembly)
@@ -1820,10 +1931,10 @@ void EnumeratorNode::Generate(Asm::Assembly *assembly)
 void TypeSpecifierQualifierNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-TypeSpecifierQualifierNode::TypeSpecifierQualifierNode(std::shared_ptr<Token> value) : SimpleSpecifier(std::move(value)) {}
+TypeSpecifierQualifierNode::TypeSpecifierQualifierNode(Token value) : SimpleSpecifier(std::move(value)) {}
 
 void TypeSpecifierQualifierNode::Generate(Asm::Assembly *assembly)
 {
@@ -1833,10 +1944,10 @@ void TypeSpecifierQualifierNode::Generate(Asm::Assembly *assembly)
 void TypeSpecifierNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-TypeSpecifierNode::TypeSpecifierNode(std::shared_ptr<Token> specifier) : TypeSpecifierQualifierNode(std::move(specifier)) {}
+TypeSpecifierNode::TypeSpecifierNode(Token specifier) : TypeSpecifierQualifierNode(std::move(specifier)) {}
 
 void TypeSpecifierNode::Generate(Asm::Assembly *assembly)
 {
@@ -1846,10 +1957,10 @@ void TypeSpecifierNode::Generate(Asm::Assembly *assembly)
 void TypeQualifierNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-TypeQualifierNode::TypeQualifierNode(std::shared_ptr<Token> qualifier) : TypeSpecifierQualifierNode(std::move(qualifier)) {}
+TypeQualifierNode::TypeQualifierNode(Token qualifier) : TypeSpecifierQualifierNode(std::move(qualifier)) {}
 
 void TypeQualifierNode::Generate(Asm::Assembly *assembly)
 {
@@ -1859,10 +1970,10 @@ void TypeQualifierNode::Generate(Asm::Assembly *assembly)
 void StorageClassSpecifierNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-StorageClassSpecifierNode::StorageClassSpecifierNode(std::shared_ptr<Token> specifier) : SimpleSpecifier(std::move(specifier)) {}
+StorageClassSpecifierNode::StorageClassSpecifierNode(Token specifier) : SimpleSpecifier(std::move(specifier)) {}
 
 void StorageClassSpecifierNode::Generate(Asm::Assembly *assembly)
 {
@@ -1872,10 +1983,10 @@ void StorageClassSpecifierNode::Generate(Asm::Assembly *assembly)
 void FunctionSpecifierNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-FunctionSpecifierNode::FunctionSpecifierNode(std::shared_ptr<Token> specifier) : SimpleSpecifier(std::move(specifier)) {}
+FunctionSpecifierNode::FunctionSpecifierNode(Token specifier) : SimpleSpecifier(std::move(specifier)) {}
 
 void FunctionSpecifierNode::Generate(Asm::Assembly *assembly)
 {
@@ -1885,15 +1996,15 @@ void FunctionSpecifierNode::Generate(Asm::Assembly *assembly)
 void SimpleSpecifier::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << value->text << std::endl;
+    os << value.GetText() << std::endl;
 }
 
-std::shared_ptr<Token> SimpleSpecifier::Value()
+Token SimpleSpecifier::Value()
 {
     return value;
 }
 
-SimpleSpecifier::SimpleSpecifier(std::shared_ptr<Token> specifier) : value(std::move(specifier)) { kind = SpecifierKind::SIMPLE; }
+SimpleSpecifier::SimpleSpecifier(Token specifier) : value(std::move(specifier)) { kind = SpecifierKind::SIMPLE; }
 
 void SimpleSpecifier::Generate(Asm::Assembly *assembly)
 {
@@ -2011,13 +2122,13 @@ void StructSpecifierNode::SetRecordType(SymRecord *type)
     this->type = type;
 }
 
-StructSpecifierNode::StructSpecifierNode(SymRecord *type, std::shared_ptr<Token> structToken) : type(type),
+StructSpecifierNode::StructSpecifierNode(SymRecord *type, Token structToken) : type(type),
                                                                                                 token(std::move(structToken))
 {
     kind = SpecifierKind::STRUCT;
 }
 
-std::shared_ptr<Token> StructSpecifierNode::GetToken() const
+Token StructSpecifierNode::GetToken() const
 {
     return token;
 }
@@ -2122,7 +2233,7 @@ void ArrayDesignator::Print(std::ostream &os, std::string indent, bool isTail)
     index->Print(os, indent, true);
 }
 
-ArrayDesignator::ArrayDesignator(ExprNode *index) : index(index) {}
+ArrayDesignator::ArrayDesignator(ExprNode *index) : index(index) { nodeKind = NodeKind::ARRAY_DESIGNATOR; }
 
 ExprNode *ArrayDesignator::GetIndex() const
 {
@@ -2162,7 +2273,7 @@ void StructMemberDesignator::Print(std::ostream &os, std::string indent, bool is
     id->Print(os, indent, true);
 }
 
-StructMemberDesignator::StructMemberDesignator(IdNode *id) : id(id) {}
+StructMemberDesignator::StructMemberDesignator(IdNode *id) : id(id) { nodeKind = NodeKind::STRUCT_MEMBER_DESIGNATOR; }
 
 IdNode *StructMemberDesignator::GetMemberId() const
 {
@@ -2184,7 +2295,7 @@ void DesignatedInitializerNode::Print(std::ostream &os, std::string indent, bool
 }
 
 DesignatedInitializerNode::DesignatedInitializerNode(DesignationNode *designation, InitializerNode *initializer) :
-        designation(designation), initializer(initializer) {}
+        designation(designation), initializer(initializer) { nodeKind = NodeKind::DESIGNATED_INITIALIZER; }
 
 DesignationNode *DesignatedInitializerNode::GetDesignation() const
 {
@@ -2206,8 +2317,9 @@ void FunctionDefinitionNode::Print(std::ostream &os, std::string indent, bool is
     os << indent << (isTail ? "└── " : "├── ");
     os << "FuncDef" << std::endl;
     indent.append(isTail ? "    " : "│   ");
-    declarator->Print(os, indent, false);
-    body->Print(os, indent, true);
+    declarator->Print(os, indent, !body);
+    // the body is missing when parsing it was deferred
+    if (body) body->Print(os, indent, true);
 }
 
 void FunctionDefinitionNode::SetBody(CompoundStatement *body)
@@ -2221,12 +2333,12 @@ SymType *FunctionDefinitionNode::GetType() const
 }
 
 FunctionDefinitionNode::FunctionDefinitionNode(DeclaratorNode *declarator, CompoundStatement *compoundStatement) :
-        declarator(declarator), body(compoundStatement) {}
+        declarator(declarator), body(compoundStatement) { nodeKind = NodeKind::FUNCTION_DEFINITION; }
 
 void FunctionDefinitionNode::Generate(Asm::Assembly *assembly)
 {
     auto t = reinterpret_cast<SymFunction *>(GetType());
-    auto fl = assembly->MakeFunctionLabel(t->GetName());
+    auto fl = assembly->MakeFunctionLabel(t->GetNameId());
     auto rl = assembly->NextLabel();
     t->SetLabel(fl);
     t->SetReturnLabel(rl);
@@ -2243,6 +2355,14 @@ void FunctionDefinitionNode::Generate(Asm::Assembly *assembly)
     s.AddCommand(Asm::CommandName::RET);
 }
 
+void FunctionDefinitionNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::FUNCTION_DEFINITION);
+    description->Source(this);
+    description->Type(GetType());
+    description->Child(body);
+}
+
 void TranslationUnitNode::Print(std::ostream &os, std::string indent, bool isTail)
 {
     if (list.empty()) return;
@@ -2266,12 +2386,24 @@ uint64_t TranslationUnitNode::Size()
     return list.size();
 }
 
+std::list<ExternalDeclarationNode *> &TranslationUnitNode::List()
+{
+    return list;
+}
+
 void TranslationUnitNode::Generate(Asm::Assembly *assembly)
 {
     for (auto it = list.begin(); it != list.end(); it++)
         (*it)->Generate(assembly);
 }
 
+void TranslationUnitNode::Describe(NodeDescription *description)
+{
+    description->Kind(NodeKind::TRANSLATION_UNIT);
+    for (auto declaration: list)
+        description->Child(declaration);
+}
+
 SpecifierKind DeclarationSpecifierNode::Kind()
 {
     return kind;
@@ -2312,9 +2444,88 @@ Position ExprNode::GetPosition() const
     return position;
 }
 
-void ExprNode::SetPosition(std::shared_ptr<Token> token)
+void ExprNode::SetPosition(Token token)
+{
+    position = token.GetPosition();
+}
+
+void ExprNode::describe(NodeDescription *description, NodeKind kind)
+{
+    description->Kind(kind);
+    description->Type(type);
+}
+
+void ExprNode::load(Asm::Section &section, SymType *type, Asm::ArgumentAddress *address, Asm::Register target)
+{
+    using namespace Asm;
+    auto command = CommandName::MOV;
+    auto suffix = CommandSuffix::L;
+    if (type->GetTypeKind() == TypeKind::BUILTIN)
+        switch (reinterpret_cast<SymBuiltInType *>(type->GetUnqualified())->GetBuiltInTypeKind())
+        {
+            case BuiltInTypeKind::INT8:
+                command = CommandName::MOVSBL;
+                suffix = CommandSuffix::NONE;
+                break;
+            case BuiltInTypeKind::UINT8:
+                command = CommandName::MOVZBL;
+                suffix = CommandSuffix::NONE;
+                break;
+            case BuiltInTypeKind::INT16:
+                command = CommandName::MOVSWL;
+                suffix = CommandSuffix::NONE;
+                break;
+            case BuiltInTypeKind::UINT16:
+                command = CommandName::MOVZWL;
+                suffix = CommandSuffix::NONE;
+                break;
+            default:
+                break;
+        }
+    section.AddCommand(command, address, target, suffix);
+}
+
+// gives the multiplier that turns the index register into the offset of an element of type, multiplying
+// the index beforehand when the addressing mode has no such scale
+int32_t ExprNode::scale(Asm::Section &section, SymType *type, Asm::Register index)
 {
-    position = token->position;
+    auto size = type->Size();
+    if (size == 1 || size == 2 || size == 4 || size == 8) return size;
+    section.AddCommand(Asm::CommandName::IMUL, new IntConstNode(size), index, Asm::CommandSuffix::L);
+    return 1;
+}
+
+void ExprNode::CopyImage(Asm::Section &section, int32_t size, Asm::Register base, int32_t offset)
+{
+    using namespace Asm;
+    int32_t i = 0;
+    for (; i + 4 <= size; i += 4)
+    {
+        section.AddCommand(CommandName::MOV, MakeAddress(i, Register::ESP), Register::EAX, CommandSuffix::L);
+        section.AddCommand(CommandName::MOV, Register::EAX, MakeAddress(offset + i, base), CommandSuffix::L);
+    }
+    for (; i < size; i++)
+    {
+        section.AddCommand(CommandName::MOV, MakeAddress(i, Register::ESP), Register::CL, CommandSuffix::B);
+        section.AddCommand(CommandName::MOV, Register::CL, MakeAddress(offset + i, base), CommandSuffix::B);
+    }
+}
+
+// stores eax
+void ExprNode::store(Asm::Section &section, SymType *type, Asm::ArgumentAddress *address)
+{
+    using namespace Asm;
+    switch (type->Size())
+    {
+        case 1:
+            section.AddCommand(CommandName::MOV, Register::AL, address, CommandSuffix::B);
+            break;
+        case 2:
+            section.AddCommand(CommandName::MOV, Register::AX, address, CommandSuffix::W);
+            break;
+        default:
+            section.AddCommand(CommandName::MOV, Register::EAX, address, CommandSuffix::L);
+    }
 }
 
 void IterationStatementNode::SetBody(StatementNode *body)
@@ -2337,7 +2548,7 @@ TypedefIdentifierNode::TypedefIdentifierNode(SymAlias *alias): alias(alias)
     this->kind = SpecifierKind::TYPEDEF;
 }
 
-std::shared_ptr<Token> TypedefIdentifierNode::GetToken()
+Token TypedefIdentifierNode::GetToken()
 {
     return id;
 }
@@ -2360,7 +2571,7 @@ void TypedefIdentifierNode::Generate(Asm::Assembly *assembly)
     // TODO
 }
 
-SimpleInitializer::SimpleInitializer(ExprNode *expr): value(expr) {}
+SimpleInitializer::SimpleInitializer(ExprNode *expr): value(expr) { nodeKind = NodeKind::SIMPLE_INITIALIZER; }
 
 void SimpleInitializer::Print(std::ostream &os, std::string indent, bool isTail)
 {
@@ -2393,7 +2604,8 @@ void DesignatorNode::SetValue(InitializerNode *value)
 PrintfNode::PrintfNode(StringLiteralNode *format, ArgumentExprListNode *arguments):
         format(format), arguments(arguments)
 {
-    type = new SymBuiltInType(BuiltInTypeKind::VOID);
+    nodeKind = NodeKind::PRINTF;
+    type = Types.BuiltIn(BuiltInTypeKind::VOID);
 }
 
 void PrintfNode::Print(std::ostream &os, std::string indent, bool isTail)
@@ -2405,43 +2617,49 @@ void PrintfNode::Print(std::ostream &os, std::string indent, bool isTail)
     if (arguments) arguments->Print(os, indent, true);
 }
 
-ExprNode *PrintfNode::Eval(Evaluator *evaluator)
-{
-    return nullptr;
-}
-
 void PrintfNode::Generate(Asm::Assembly *assembly)
 {
     auto &s = assembly->TextSection();
     if (arguments) arguments->Generate(assembly);
     format->Generate(assembly);
     s.AddCommand(Asm::CommandName::PUSH, format->GetAddress(), true, Asm::CommandSuffix::L);
-    s.AddCommand(Asm::CommandName::CALL, new Asm::AsmFunction("printf"));
+    s.AddCommand(Asm::CommandName::CALL, new Asm::AsmFunction(Identifiers.Intern("printf")));
     auto size = 4 + arguments->GetArgumentsSize();
     s.AddCommand(Asm::CommandName::ADD, new IntConstNode(size), Asm::Register::ESP, Asm::CommandSuffix::L);
 }
 
+void PrintfNode::Describe(NodeDescription *description)
+{
+    describe(description, NodeKind::PRINTF);
+    description->Child(format);
+    if (arguments)
+        for (auto argument: arguments->List())
+            description->Child(argument);
+}
+
+// the shared constants outlive the compilation arena, so they are on the heap
+
 IntConstNode *ConstNode::IntZero()
 {
-    static auto zero = new IntConstNode(0);
+    static auto zero = ::new IntConstNode(0);
     return zero;
 }
 
 IntConstNode *ConstNode::IntOne()
 {
-    static auto one = new IntConstNode(1);
+    static auto one = ::new IntConstNode(1);
     return one;
 }
 
 FloatConstNode *ConstNode::FloatZero()
 {
-    static auto zero = new FloatConstNode(0.0f);
+    static auto zero = ::new FloatConstNode(0.0f);
     return nullptr;
 }
 
 FloatConstNode *ConstNode::FloatOne()
 {
-    static auto one = new FloatConstNode(0.1f);
+    static auto one = ::new FloatConstNode(0.1f);
     return one;
 }
 
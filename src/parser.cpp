@@ -3,6 +3,8 @@
 //
 
 #include "../includes/parser.h"
+#include "../includes/symbols/type_context.h"
+#include <atomic>
 
 Parser::Parser() = default;
 
@@ -11,10 +13,36 @@ Parser::Parser(Tokenizer *tokenizer)
     scanner = tokenizer;
 }
 
+Parser::Parser(Tokenizer *tokenizer, SymbolTable *fileScope): sematicAnalyzer(fileScope)
+{
+    scanner = tokenizer;
+}
+
 void Parser::Parse()
 {
     scanner->Next();
-    tree.root = parseTranslationUnit();
+    if (bodyThreads < 2)
+    {
+        tree.root = parseTranslationUnit();
+        return;
+    }
+    deferBodies = true;
+    try
+    {
+        tree.root = parseTranslationUnit();
+    }
+    catch (...)
+    {
+        // an error in a body before this one is what parsing in one go would have stopped at
+        parseBodiesOnThreads();
+        throw;
+    }
+    parseBodiesOnThreads();
+}
+
+Node *Parser::GetRoot() const
+{
+    return tree.root;
 }
 
 std::ostream &operator<<(std::ostream &os, Parser &parser)
@@ -29,7 +57,7 @@ ExprNode *Parser::parsePrimaryExpr()
 {
     auto t = scanner->Current();
     scanner->Next();
-    switch (t->type)
+    switch (t.GetType())
     {
         case TokenType::NUM_INT:
             return new IntConstNode(t);
@@ -61,7 +89,7 @@ ExprNode *Parser::parsePostfixExpr()
     while (stillPostfixOperator)
     {
         auto op = t;
-        switch (t->type)
+        switch (t.GetType())
         {
             case TokenType::DOUBLE_PLUS:
                 pe = sematicAnalyzer.BuildPostfixIncrementNode(pe, op);
@@ -109,7 +137,7 @@ ExprNode *Parser::parseUnaryExpr()
 {
     ExprNode *ue;
     auto t = scanner->Current(), op = t;
-    switch (t->type)
+    switch (t.GetType())
     {
         case TokenType::DOUBLE_PLUS:
             t = scanner->Next();
@@ -120,20 +148,20 @@ ExprNode *Parser::parseUnaryExpr()
             ue = sematicAnalyzer.BuildPrefixDecrementNode(parseUnaryExpr(), op);
             break;
         case TokenType::KEYWORD:
-            if (t->keyword == Keyword::SIZEOF)
+            if (t.GetKeyword() == Keyword::SIZEOF)
             {
                 t = scanner->Next();
-                if (t->type == TokenType::LBRACKET)
+                if (t.GetType() == TokenType::LBRACKET)
                 {
                     scanner->Next();
-                    ue = new SizeofTypeNameNode(parseTypeName());
+                    ue = sematicAnalyzer.BuildSizeofTypeNameNode(parseTypeName(), op);
                     require(TokenType::RBRACKET);
                     scanner->Next();
                 }
                 else
-                    ue = new SizeofExprNode(parseUnaryExpr());
+                    ue = sematicAnalyzer.BuildSizeofExprNode(parseUnaryExpr(), op);
             }
-            else if (t->keyword == Keyword::PRINTF)
+            else if (t.GetKeyword() == Keyword::PRINTF)
             {
                 ArgumentExprListNode *arguments = nullptr;
                 scanner->Next();
@@ -163,7 +191,8 @@ ExprNode *Parser::parseUnaryExpr()
 
 ExprNode *Parser::parseCastExpr()
 {
-    if (scanner->Current()->type == TokenType::LBRACKET &&
+    checkNesting();
+    if (scanner->Current().GetType() == TokenType::LBRACKET &&
             (isTypeQualifier(scanner->Peek()) || isTypeSpecifier(scanner->Peek())))
     {
         scanner->Next();
@@ -174,106 +203,96 @@ ExprNode *Parser::parseCastExpr()
     return parseUnaryExpr();
 }
 
-//multiplicative-expr ::= cast-expr | multiplicative-expr * cast-expr
-//                        | multiplicative-expr / cast-expr
-//                        | multiplicative-expr % cast-expr
-
-ExprNode *Parser::parseMultiplicativeExpr()
-{
-    static std::unordered_set<TokenType> types = {TokenType::ASTERIX, TokenType::FORWARD_SLASH, TokenType::REMINDER};
-    return parseBinoOps(this, &Parser::parseCastExpr, types);
-}
-
-//addictive-expr ::= multiplicative-expr
-//                   | addictive-expr + multiplicative-expr
-//                   | addictive-expr - multiplicative-expr
-
-ExprNode *Parser::parseAddictiveExpr()
-{
-    static std::unordered_set<TokenType> types = {TokenType::PLUS, TokenType::MINUS};
-    return parseBinoOps(this, &Parser::parseMultiplicativeExpr, types);
-}
-
-//shift-expr ::= addictive-expr
-//               | shift-expr << addictive-expr
-//               | shift-expr >> addictive-expr
-
-ExprNode *Parser::parseShiftExpr()
-{
-    static std::unordered_set<TokenType> types = {TokenType::BITWISE_LSHIFT, TokenType::BITWISE_RSHIFT};
-    return parseBinoOps(this, &Parser::parseAddictiveExpr, types);
-}
-
-//rel-expr ::= shift-expr | rel-expr < shift-expr | rel-expr > shift-expr
-//             | rel-expr <= shift expr | rel-expr >= shift-expr
-
-ExprNode *Parser::parseRelationalExpr()
-{
-    static std::unordered_set<TokenType> types = {TokenType::RELOP_GT, TokenType::RELOP_LT,
-                                                  TokenType::RELOP_GE, TokenType::RELOP_LE};
-    return parseBinoOps(this, &Parser::parseShiftExpr, types);
-}
-
-//eq-expr ::= rel-expr | eq-expr == rel-expr | eq-expr != rel-expr
+// Binary operators are parsed by precedence climbing over this table instead of one function per level:
+//
+// multiplicative-expr ::= cast-expr | multiplicative-expr (* | / | %) cast-expr
+// addictive-expr ::= multiplicative-expr | addictive-expr (+ | -) multiplicative-expr
+// shift-expr ::= addictive-expr | shift-expr (<< | >>) addictive-expr
+// rel-expr ::= shift-expr | rel-expr (< | > | <= | >=) shift-expr
+// eq-expr ::= rel-expr | eq-expr (== | !=) rel-expr
+// AND-expr ::= eq-expr | AND-expr & eq-expr
+// exclusive-OR-expr ::= AND-expr | exclusive-OR-expr ^ AND-expr
+// inclusive-OR-expr ::= exclusive-OR-expr | inclusive-OR-expr '|' exclusive-OR-expr
+// logical-AND-expr ::= inclusive-OR-expr | logical-AND-expr && inclusive-OR-expr
+// logical-OR-expr ::= logical-AND-expr | logical-OR-expr || logical-AND-expr
 
-ExprNode *Parser::parseEqualityExpr()
+enum class Associativity
 {
-    static std::unordered_set<TokenType> types = {TokenType::RELOP_EQ, TokenType::RELOP_NE};
-    return parseBinoOps(this, &Parser::parseRelationalExpr, types);
-}
-
-//AND-expr ::= eq-expr | AND-expr & eq-expr
+    LEFT, RIGHT
+};
 
-ExprNode *Parser::parseAndExpr()
+struct BinaryOperator
 {
-    static std::unordered_set<TokenType> types = {TokenType::BITWISE_AND};
-    return parseBinoOps(this, &Parser::parseEqualityExpr, types);
-}
+    TokenType type;
+    // 0 for tokens that are not binary operators, the higher the tighter
+    int precedence;
+    Associativity associativity;
+};
 
-//exclusive-OR-expr ::= AND-expr | exclusive-OR-expr ^ AND-expr
-
-ExprNode *Parser::parseExclusiveOrExpr()
+constexpr BinaryOperator BinaryOperatorList[] =
 {
-    static std::unordered_set<TokenType> types = {TokenType::BITWISE_XOR};
-    return parseBinoOps(this, &Parser::parseAndExpr, types);
-}
+    {TokenType::LOGIC_OR, 1, Associativity::LEFT},
+    {TokenType::LOGIC_AND, 2, Associativity::LEFT},
+    {TokenType::BITWISE_OR, 3, Associativity::LEFT},
+    {TokenType::BITWISE_XOR, 4, Associativity::LEFT},
+    {TokenType::BITWISE_AND, 5, Associativity::LEFT},
+    {TokenType::RELOP_EQ, 6, Associativity::LEFT}, {TokenType::RELOP_NE, 6, Associativity::LEFT},
+    {TokenType::RELOP_GT, 7, Associativity::LEFT}, {TokenType::RELOP_LT, 7, Associativity::LEFT},
+    {TokenType::RELOP_GE, 7, Associativity::LEFT}, {TokenType::RELOP_LE, 7, Associativity::LEFT},
+    {TokenType::BITWISE_LSHIFT, 8, Associativity::LEFT}, {TokenType::BITWISE_RSHIFT, 8, Associativity::LEFT},
+    {TokenType::PLUS, 9, Associativity::LEFT}, {TokenType::MINUS, 9, Associativity::LEFT},
+    {TokenType::ASTERIX, 10, Associativity::LEFT}, {TokenType::FORWARD_SLASH, 10, Associativity::LEFT},
+    {TokenType::REMINDER, 10, Associativity::LEFT}
+};
 
-//inclusive-OR-expr ::= exclusive-OR-expr | inclusive-OR-expr '|' exclusive-OR-expr
+constexpr int LowestPrecedence = 1;
 
-ExprNode *Parser::parseInclusiveOrExpr()
+struct BinaryOperatorTable
 {
-    static std::unordered_set<TokenType> types = {TokenType::BITWISE_OR};
-    return parseBinoOps(this, &Parser::parseExclusiveOrExpr, types);
-}
-
-//logical-AND-expr ::= inclusive-OR-expr | logical-AND-expr && inclusive-OR-expr
+    BinaryOperator operators[(size_t)TokenType::END_OF_FILE + 1];
+};
 
-ExprNode *Parser::parseLogicalAndExpr()
+constexpr BinaryOperatorTable buildBinaryOperatorTable()
 {
-    static std::unordered_set<TokenType> types = {TokenType::LOGIC_AND};
-    return parseBinoOps(this, &Parser::parseInclusiveOrExpr, types);
+    BinaryOperatorTable table{};
+    for (auto &op: BinaryOperatorList)
+        table.operators[(size_t)op.type] = op;
+    return table;
 }
 
-//logical-OR-expr ::= logical-AND-expr | logical-OR-expr || logical-AND-expr
+// indexed by TokenType
+constexpr BinaryOperatorTable BinaryOperators = buildBinaryOperatorTable();
 
-ExprNode *Parser::parseLogicalOrExpr()
-{
-    static std::unordered_set<TokenType> types = {TokenType::LOGIC_OR};
-    return parseBinoOps(this, &Parser::parseLogicalAndExpr, types);
-}
+// Operands and the operators between them wait on the stacks until an operator that binds looser
+// comes, so a long chain costs no recursion. The nodes are built in the same order recursion would build them.
 
-ExprNode *Parser::parseBinoOps(Parser *self, ExprNode *(Parser::*f)(),
-                               std::unordered_set<TokenType> types)
+ExprNode *Parser::parseBinaryExpr()
 {
-    auto *e = (ExprNode *)(self->*f)();
-    auto t = self->scanner->Current();
-    while (types.find(t->type) != types.end())
+    auto operandBase = operandStack.size(), operatorBase = operatorStack.size();
+    operandStack.push_back(parseCastExpr());
+    while (true)
     {
-        self->scanner->Next();
-        auto right = (ExprNode *) ((*self).*f)();
-        e = sematicAnalyzer.BuildBinOpNode(e, right, t);
-        t = self->scanner->Current();
+        auto t = scanner->Current();
+        auto &op = BinaryOperators.operators[(size_t)t.GetType()];
+        while (operatorStack.size() > operatorBase)
+        {
+            auto &top = BinaryOperators.operators[(size_t)operatorStack.back().GetType()];
+            if (top.precedence < op.precedence ||
+                (top.precedence == op.precedence && op.associativity == Associativity::RIGHT))
+                break;
+            auto right = operandStack.back();
+            operandStack.pop_back();
+            operandStack.back() = sematicAnalyzer.BuildBinOpNode(operandStack.back(), right, operatorStack.back());
+            operatorStack.pop_back();
+        }
+        if (op.precedence < LowestPrecedence)
+            break;
+        scanner->Next();
+        operatorStack.push_back(t);
+        operandStack.push_back(parseCastExpr());
     }
+    auto e = operandStack.back();
+    operandStack.resize(operandBase);
     return e;
 }
 
@@ -281,9 +300,9 @@ ExprNode *Parser::parseBinoOps(Parser *self, ExprNode *(Parser::*f)(),
 
 ExprNode *Parser::parseConditionalExpr()
 {
-    ExprNode *loe =  parseLogicalOrExpr();
+    ExprNode *loe =  parseBinaryExpr();
     auto t = scanner->Current(), q = t;
-    if (t->type == TokenType::QUESTION_MARK)
+    if (t.GetType() == TokenType::QUESTION_MARK)
     {
         t = scanner->Next();
         ExprNode *then = parseExpr();
@@ -315,15 +334,18 @@ ExprNode *Parser::parseAssignmentExpr()
 ExprNode *Parser::parseExpr()
 {
     ExprNode *ae = parseAssignmentExpr();
-    if (maybe(TokenType::COMMA))
-    {
-        auto list = new CommaSeparatedExprs();
-        list->Add(ae);
-        while (maybeNext(TokenType::COMMA))
-            list->Add(parseExpr());
-        return list;
-    }
-    return ae;
+    if (!maybe(TokenType::COMMA))
+        return ae;
+    // a, b, c is a, (b, c): the lists are put together from the right once all of the operands are there
+    auto base = operandStack.size();
+    operandStack.push_back(ae);
+    while (maybeNext(TokenType::COMMA))
+        operandStack.push_back(parseAssignmentExpr());
+    ExprNode *e = operandStack.back();
+    for (auto i = operandStack.size() - 1; i-- > base;)
+        e = sematicAnalyzer.BuildCommaSeparatedExprs(operandStack[i], e);
+    operandStack.resize(base);
+    return e;
 }
 
 //type-id ::= specifier-qualifier-list `abstract-declarator
@@ -342,31 +364,31 @@ SymType *Parser::parseTypeName()
 //                   | unsigned | struct-specifier | enum-specifier |
 //                   | typedef-id
 
-bool Parser::isTypeSpecifier(std::shared_ptr<Token> token)
+bool Parser::isTypeSpecifier(Token token)
 {
-    return (token->type == TokenType::KEYWORD ? TypeSpecifiers.find(token->keyword) != TypeSpecifiers.end() : false)
+    return (token.GetType() == TokenType::KEYWORD ? TypeSpecifiers.find(token.GetKeyword()) != TypeSpecifiers.end() : false)
             || isTypedefIdentifier(token);
 }
 
 //unary-op  ::= & | * | + | - | ~ | !
 
-bool Parser::isUnaryOp(std::shared_ptr<Token> token)
+bool Parser::isUnaryOp(Token token)
 {
-    return UnaryOps.find(token->type) != UnaryOps.end();
+    return UnaryOps.find(token.GetType()) != UnaryOps.end();
 }
 
 //assignment-op ::= = | *= | /= | %= | += | -= | <<= | >>= | &= | ^= | |=
 
-bool Parser::isAssignmentOp(std::shared_ptr<Token> token)
+bool Parser::isAssignmentOp(Token token)
 {
-    return  AssignmentOps.find(token->type) != AssignmentOps.end();
+    return  AssignmentOps.find(token.GetType()) != AssignmentOps.end();
 }
 
 //type-qualifier ::= const
 
-bool Parser::isTypeQualifier(std::shared_ptr<Token> token)
+bool Parser::isTypeQualifier(Token token)
 {
-    return token->type == TokenType::KEYWORD ? TypeQualifiers.find(token->keyword) != TypeQualifiers.end() : false;
+    return token.GetType() == TokenType::KEYWORD ? TypeQualifiers.find(token.GetKeyword()) != TypeQualifiers.end() : false;
 }
 
 //constant-expr ::= conditional-expr
@@ -396,8 +418,9 @@ DeclarationSpecifiersNode *Parser::parseTypeQualifierList()
 
 StatementNode *Parser::parseStatement()
 {
-    if (scanner->Current()->type == TokenType::KEYWORD)
-        switch (scanner->Current()->keyword)
+    checkNesting();
+    if (scanner->Current().GetType() == TokenType::KEYWORD)
+        switch (scanner->Current().GetKeyword())
         {
             case Keyword::IF:
                 return parseSelectionStatement();
@@ -407,9 +430,9 @@ StatementNode *Parser::parseStatement()
             case Keyword::FOR: case Keyword::DO: case Keyword::WHILE:
                 return parseIterationStatement();
         }
-    if (scanner->Current()->type == TokenType::ID && scanner->Peek()->type == TokenType::COLON)
+    if (scanner->Current().GetType() == TokenType::ID && scanner->Peek().GetType() == TokenType::COLON)
         return parseLabelStatement();
-    if (scanner->Current()->type == TokenType::LCURLY_BRACKET)
+    if (scanner->Current().GetType() == TokenType::LCURLY_BRACKET)
         return parseCompoundStatement();
     return reinterpret_cast<StatementNode *>(parseExprStatement());
 }
@@ -451,8 +474,8 @@ JumpStatementNode *Parser::parseJumpStatement()
     JumpStatementNode *js = nullptr;
     auto t = scanner->Current();
     scanner->Next();
-    if (t->type == TokenType::KEYWORD)
-        switch (t->keyword)
+    if (t.GetType() == TokenType::KEYWORD)
+        switch (t.GetKeyword())
         {
             case Keyword::GOTO:
                 require(TokenType::ID);
@@ -466,7 +489,7 @@ JumpStatementNode *Parser::parseJumpStatement()
                 js = sematicAnalyzer.BuildBreakStatementNode(t);
                 break;
             case Keyword::RETURN:
-                js = scanner->Current()->type == TokenType::SEMICOLON ?
+                js = scanner->Current().GetType() == TokenType::SEMICOLON ?
                      sematicAnalyzer.BuildReturnStatementNode(t, nullptr) :
                      sematicAnalyzer.BuildReturnStatementNode(t, parseExpr());
                 break;
@@ -482,7 +505,7 @@ JumpStatementNode *Parser::parseJumpStatement()
 IterationStatementNode *Parser::parseIterationStatement()
 {
     require(TokenType::KEYWORD);
-    switch (scanner->Current()->keyword)
+    switch (scanner->Current().GetKeyword())
     {
         case Keyword::FOR:
             return parseForStatement();
@@ -562,10 +585,10 @@ void Parser::parsePointer(DeclaratorNode *declarator)
 {
     if (!maybeNext(TokenType::ASTERIX)) return;
     auto quals = TypeBuilder::BuildTypeQualifiers(parseTypeQualifierList()); // TODO that's what SymPointer gonna store
-    if (quals)
-        declarator->SetType(new SymQualifiedType(new SymPointer(declarator->GetType()), quals));
-    else
-        declarator->SetType(new SymPointer(declarator->GetType()));
+    // the pointer of a parenthesized declarator gets its target later on, see parseDirectDeclarator
+    auto target = declarator->GetType();
+    SymType *pointer = target ? Types.Pointer(target) : new SymPointer(nullptr);
+    declarator->SetType(quals ? Types.Qualified(pointer, quals) : pointer);
     parsePointer(declarator);
 }
 
@@ -573,6 +596,7 @@ void Parser::parsePointer(DeclaratorNode *declarator)
 
 void Parser::parseDeclarator(DeclaratorKind kind, DeclaratorNode *declarator)
 {
+    checkNesting();
     parsePointer(declarator);
     parseDirectDeclarator(kind, declarator);
 }
@@ -655,7 +679,7 @@ void Parser::parseFunctionDeclarator(DeclaratorNode *declarator)
     std::vector<SymVariable *> orderedParamTypes;
     if (ptl->List().size() == 1)
     {
-        auto bit = dynamic_cast<SymBuiltInType *>(ptl->List().front()->GetType()->GetUnqualified());
+        auto bit = AsBuiltIn(ptl->List().front()->GetType()->GetUnqualified());
         if (bit && bit->GetBuiltInTypeKind() == BuiltInTypeKind::VOID)
             ptl->List().clear();
     }
@@ -663,14 +687,13 @@ void Parser::parseFunctionDeclarator(DeclaratorNode *declarator)
     auto table = new SymbolTable();
     for (auto it: ptl->List())
     {
-        std::string name = it->GetId() ? it->GetId()->GetName() : "#" + std::to_string(orderedParamTypes.size());
+        NameId name = it->GetId() ? it->GetId()->GetNameId() :
+                      Identifiers.Intern("#" + std::to_string(orderedParamTypes.size()));
 
         auto var = new SymVariable(name, (*it).GetType(), (*it).GetId());
-        var->SetName(name);
         orderedParamTypes.push_back(var);
         table->Insert(name, var);
     }
-    table->SetParent(sematicAnalyzer.GetScopeTree()->GetActiveScope());
     requireNext(TokenType::RBRACKET);
     declarator->SetType(new SymFunction(declarator->GetType(), table, orderedParamTypes));
 }
@@ -713,15 +736,15 @@ ArgumentExprListNode *Parser::parseArgumentExprList()
 
 //storage-class-specifier ::= typedef | extern | static | auto | register
 
-bool Parser::isStorageClassSpecifier(std::shared_ptr<Token> token)
+bool Parser::isStorageClassSpecifier(Token token)
 {
-    return token->type == TokenType::KEYWORD ?
-           StorageClassSpecifiers.find(token->keyword) != StorageClassSpecifiers.end() : false;
+    return token.GetType() == TokenType::KEYWORD ?
+           StorageClassSpecifiers.find(token.GetKeyword()) != StorageClassSpecifiers.end() : false;
 }
 
 //function-specifier ::= inline
 
-bool Parser::isFunctionSpecifier(std::shared_ptr<Token> token)
+bool Parser::isFunctionSpecifier(Token token)
 {
     return maybeKeyword(Keyword::INLINE);
 }
@@ -735,7 +758,7 @@ ParameterDeclarationNode *Parser::parseParameterDeclaration()
     parseDeclarator(DeclaratorKind::ABSTRACT_OR_NORMAL, declarator);
     auto type = declarator->GetType()->GetUnqualified();
     if (type->GetTypeKind() == TypeKind::ARRAY)
-        declarator->SetType(new SymPointer(reinterpret_cast<SymArray *>(type)->GetValueType()));
+        declarator->SetType(Types.Pointer(reinterpret_cast<SymArray *>(type)->GetValueType()));
     return new ParameterDeclarationNode(declarator);
 }
 
@@ -794,7 +817,7 @@ ParameterList *Parser::parseParameterTypeList()
 //| type-qualifier `declaration-specifier
 //| function-specifier declaration-specifier
 
-bool Parser::isDeclarationSpecifier(std::shared_ptr<Token> token)
+bool Parser::isDeclarationSpecifier(Token token)
 {
     return isTypeSpecifier(token) || isStorageClassSpecifier(token) || isTypeQualifier(token)
            || isFunctionSpecifier(token);
@@ -872,8 +895,9 @@ CompoundStatement *Parser::parseCompoundStatement()
 
     require(TokenType::LCURLY_BRACKET);
     sematicAnalyzer.GetScopeTree()->StartScope();
-    if (scanner->Next()->type == TokenType::RCURLY_BRACKET && scanner->Next())
+    if (scanner->Next().GetType() == TokenType::RCURLY_BRACKET)
     {
+        scanner->Next();
         sematicAnalyzer.GetScopeTree()->EndScope();
         return new CompoundStatement(nullptr);
     }
@@ -911,7 +935,7 @@ EnumSpecifierNode *Parser::parseEnumSpecifier()
     IdNode *id = nullptr;
     EnumeratorList *list = nullptr;
     requireKeyword(Keyword::ENUM);
-    if (scanner->Next()->type == TokenType::ID)
+    if (scanner->Next().GetType() == TokenType::ID)
     {
         id = new IdNode(scanner->Current());
         scanner->Next();
@@ -931,30 +955,32 @@ EnumSpecifierNode *Parser::parseEnumSpecifier()
 EnumeratorList *Parser::parseEnumeratorList()
 {
     auto list = new EnumeratorList();
+    EnumeratorNode *enumerator = nullptr;
     do
     {
         if (maybe(TokenType::RCURLY_BRACKET)) break;
-        list->Add(parseEnumerator());
+        enumerator = parseEnumerator(enumerator);
+        list->Add(enumerator);
     } while(maybeNext(TokenType::COMMA));
     return list;
 }
 
 //enumerator ::= enumeration-constant, enumeration-constant = constant-expr
 
-EnumeratorNode *Parser::parseEnumerator()
+EnumeratorNode *Parser::parseEnumerator(EnumeratorNode *previous)
 {
     require(TokenType::ID);
     auto id = new IdNode(scanner->Current());
     scanner->Next();
     if (maybeNext(TokenType::ASSIGNMENT))
-        return sematicAnalyzer.BuildEnumeratorNode(id, parseConstantExpr());
-    return sematicAnalyzer.BuildEnumeratorNode(id, nullptr);
+        return sematicAnalyzer.BuildEnumeratorNode(id, parseConstantExpr(), previous);
+    return sematicAnalyzer.BuildEnumeratorNode(id, nullptr, previous);
 }
 
 // a specifier that consists of 1 keyword: type-qualifier | type-specifier
 // | storage-class-specifier | function-specifier
 
-bool Parser::isSimpleSpecifier(std::shared_ptr<Token> token)
+bool Parser::isSimpleSpecifier(Token token)
 {
     return isTypeQualifier(token) || isTypeSpecifier(token) ||
             isStorageClassSpecifier(token) || isFunctionSpecifier(token);
@@ -965,6 +991,7 @@ bool Parser::isSimpleSpecifier(std::shared_ptr<Token> token)
 
 StructSpecifierNode *Parser::parseStructSpecifier()
 {
+    checkNesting();
     auto stoken = scanner->Current();
     requireKeywordNext(Keyword::STRUCT);
     IdNode *id = maybe(TokenType::ID) ? new IdNode(scanner->Current()) : nullptr;
@@ -1060,6 +1087,7 @@ DeclarationSpecifiersNode *Parser::parseSpecifierQualifierList()
 
 InitializerNode *Parser::parseInitializer()
 {
+    checkNesting();
     if (maybe(TokenType::LCURLY_BRACKET))
     {
         auto il =  (InitializerNode *)parseInitializerList();
@@ -1155,8 +1183,10 @@ ExternalDeclarationNode *Parser::parseExternalDeclaration()
     if (maybe(TokenType::LCURLY_BRACKET))
     {
         auto res = sematicAnalyzer.BuildFunctionDefinitionNode(declarator, nullptr);
-        auto body = parseCompoundStatement();
-        res->SetBody(body);
+        if (deferBodies)
+            skipBody(res);
+        else
+            res->SetBody(parseCompoundStatement());
         sematicAnalyzer.GetScopeTree()->EndScope();
         sematicAnalyzer.FinishLastFunctionProcessing();
         return res;
@@ -1168,12 +1198,12 @@ ExternalDeclarationNode *Parser::parseExternalDeclaration()
 
 void Parser::require(TokenType typeExpectation)
 {
-    if (scanner->Current()->type != typeExpectation) throw UnexpectedTokenError(scanner->Current(), typeExpectation);
+    if (scanner->Current().GetType() != typeExpectation) throw UnexpectedTokenError(scanner->Current(), typeExpectation);
 }
 
 void Parser::requireKeyword(Keyword expectedKeyword)
 {
-    if (scanner->Current()->type != TokenType::KEYWORD || scanner->Current()->keyword != expectedKeyword)
+    if (scanner->Current().GetType() != TokenType::KEYWORD || scanner->Current().GetKeyword() != expectedKeyword)
         throw UnexpectedKeywordError(scanner->Current(), expectedKeyword);
 }
 
@@ -1191,32 +1221,200 @@ void Parser::requireKeywordNext(Keyword expectedKeyword)
 
 bool Parser::maybe(TokenType typeExpectation)
 {
-    return scanner->Current()->type == typeExpectation;
+    return scanner->Current().GetType() == typeExpectation;
 }
 
 bool Parser::maybeNext(TokenType typeExpectation)
 {
-    return maybe(typeExpectation) && scanner->Next();
+    if (!maybe(typeExpectation)) return false;
+    scanner->Next();
+    return true;
 }
 
-bool Parser::isTypedefIdentifier(const std::shared_ptr<Token> &token)
+bool Parser::isTypedefIdentifier(Token token)
 {
-    if (token->type != TokenType::ID) return false;
-    auto sym = sematicAnalyzer.GetScopeTree()->Find(token->text);
-    return dynamic_cast<SymAlias *>(sym);
+    if (token.GetType() != TokenType::ID) return false;
+    auto sym = sematicAnalyzer.GetScopeTree()->Find(token.GetNameId());
+    return AsAlias(sym);
 }
 
 bool Parser::maybeKeywordNext(Keyword keyword)
 {
-    return maybeKeyword(keyword) && scanner->Next();
+    if (!maybeKeyword(keyword)) return false;
+    scanner->Next();
+    return true;
 }
 
 bool Parser::maybeKeyword(Keyword keyword)
 {
-    return scanner->Current()->type == TokenType::KEYWORD && scanner->Current()->keyword == keyword;
+    return scanner->Current().GetType() == TokenType::KEYWORD && scanner->Current().GetKeyword() == keyword;
+}
+
+// Every recursion of the parser goes through a cast-expr, a statement, a declarator, an initializer
+// or a struct specifier.
+// Half of the stack is left to the walks over the tree.
+
+void Parser::checkNesting()
+{
+    if (StackLeft() < StackSize() / 2)
+        throw NestingTooDeepError(scanner->Current().GetPosition());
 }
 
 void Parser::Generate(Asm::Assembly *assembly)
 {
-    tree.root->Generate(assembly);
+    if (deferredBodies.empty())
+    {
+        tree.root->Generate(assembly);
+        return;
+    }
+    // one body at a time, as TranslationUnitNode::Generate would go
+    for (auto declaration: ((TranslationUnitNode *)tree.root)->List())
+    {
+        if (declaration->GetNodeKind() == NodeKind::FUNCTION_DEFINITION)
+            ParseBody(static_cast<FunctionDefinitionNode *>(declaration));
+        declaration->Generate(assembly);
+    }
+}
+
+void Parser::DeferBodies(bool defer)
+{
+    deferBodies = defer && scanner->Batched();
+}
+
+void Parser::skipBody(FunctionDefinitionNode *function)
+{
+    deferredOrder.push_back(function);
+    deferredBodies[function] = DeferredBody{scanner->Current(), sematicAnalyzer.GetProcessingFunction(),
+                                            sematicAnalyzer.GetScopeTree()->GetFileScope()->Declared()};
+    uint32_t depth = 0;
+    do
+    {
+        switch (scanner->Current().GetType())
+        {
+            case TokenType::LCURLY_BRACKET:
+                depth++;
+                break;
+            case TokenType::RCURLY_BRACKET:
+                depth--;
+                break;
+            case TokenType::END_OF_FILE:
+                throw UnexpectedTokenError(scanner->Current(), TokenType::RCURLY_BRACKET);
+            default:
+                break;
+        }
+        scanner->Next();
+    } while (depth);
+}
+
+bool Parser::ParseBody(FunctionDefinitionNode *function)
+{
+    auto it = deferredBodies.find(function);
+    if (it == deferredBodies.end())
+        return false;
+    auto body = it->second;
+    deferredBodies.erase(it);
+    parseDeferredBody(function, body);
+    return true;
+}
+
+void Parser::parseDeferredBody(FunctionDefinitionNode *function, const DeferredBody &body)
+{
+    auto resume = scanner->Current();
+    auto scopeTree = sematicAnalyzer.GetScopeTree();
+    scanner->Seek(body.open);
+    scopeTree->SetVisibleGlobals(body.visibleGlobals);
+    SymRecord::SetVisibleCompletions(body.visibleGlobals);
+    scopeTree->StartScope(body.function->GetParamsTable());
+    sematicAnalyzer.ProcessFunction(body.function);
+    function->SetBody(parseCompoundStatement());
+    scopeTree->EndScope();
+    sematicAnalyzer.FinishLastFunctionProcessing();
+    scopeTree->SetVisibleGlobals(SymbolTable::AllVisible);
+    SymRecord::SetVisibleCompletions(SymbolTable::AllVisible);
+    scanner->Seek(resume);
+}
+
+void Parser::SetBodyThreads(unsigned threads)
+{
+    bodyThreads = scanner->Batched() ? threads : 1;
+}
+
+void Parser::FoldConstants(bool fold)
+{
+    foldConstants = fold;
+    sematicAnalyzer.FoldConstants(fold);
+}
+
+void Parser::PrintLayouts(std::ostream &os)
+{
+    auto records = sematicAnalyzer.DefinedRecords();
+    std::stable_sort(records.begin(), records.end(), [](const std::pair<Position, SymRecord *> &a,
+                                                        const std::pair<Position, SymRecord *> &b)
+    {
+        return a.first.row < b.first.row || (a.first.row == b.first.row && a.first.col < b.first.col);
+    });
+    for (auto &record: records)
+    {
+        os << "(" << record.first.row << ", " << record.first.col << ") ";
+        record.second->PrintLayout(os);
+    }
+}
+
+// Every thread takes the next body in source order and parses it over the file scope, which nobody changes
+// by then, with a scope tree, an arena and a shard for made up tokens of its own. Identifiers and canonical
+// types are shared and take a lock meanwhile.
+void Parser::parseBodiesOnThreads()
+{
+    std::vector<std::exception_ptr> errors(deferredOrder.size());
+    std::vector<std::vector<std::pair<Position, SymRecord *>>> records(deferredOrder.size());
+    std::atomic<size_t> next{0}, firstError{deferredOrder.size()};
+    auto fileScope = sematicAnalyzer.GetScopeTree()->GetFileScope();
+    auto threads = (unsigned)std::min<size_t>(bodyThreads, deferredOrder.size());
+    auto firstShard = TokenArena::Active()->AddShards(threads);
+    while (bodyArenas.size() < threads)
+        bodyArenas.emplace_back(new Arena());
+    Identifiers.SetShared(true);
+    Types.SetShared(true);
+    try
+    {
+        RunOnThreads(StackSize(), threads, [&](unsigned thread)
+        {
+            Tokenizer cursor;
+            cursor.Follow(*scanner);
+            TokenArena::UseShard(firstShard + thread);
+            bodyArenas[thread]->Activate();
+            for (size_t i; (i = next++) < firstError;)
+            {
+                try
+                {
+                    Parser parser(&cursor, fileScope);
+                    parser.FoldConstants(foldConstants);
+                    parser.parseDeferredBody(deferredOrder[i], deferredBodies.at(deferredOrder[i]));
+                    records[i] = std::move(parser.sematicAnalyzer.DefinedRecords());
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                    // the bodies after it do not matter any more
+                    auto first = firstError.load();
+                    while (i < first && !firstError.compare_exchange_weak(first, i));
+                }
+            }
+        });
+    }
+    catch (...)
+    {
+        Identifiers.SetShared(false);
+        Types.SetShared(false);
+        throw;
+    }
+    Identifiers.SetShared(false);
+    Types.SetShared(false);
+    deferredBodies.clear();
+    deferredOrder.clear();
+    for (auto &body: records)
+        sematicAnalyzer.DefinedRecords().insert(sematicAnalyzer.DefinedRecords().end(), body.begin(), body.end());
+    for (auto &error: errors)
+        if (error)
+            std::rethrow_exception(error);
 }
@@ -2,40 +2,61 @@
 
 ScopeTree::ScopeTree()
 {
-    root = activeScope = new SymbolTable();
+    root = new SymbolTable();
 }
 
-SymbolTable *ScopeTree::GetActiveScope() const
+ScopeTree::ScopeTree(SymbolTable *fileScope)
 {
-    return activeScope;
+    root = fileScope;
 }
 
-SymbolTable *ScopeTree::StartScope()
+void ScopeTree::StartScope()
 {
-    auto inner = new SymbolTable();
-    inner->SetParent(activeScope);
-    activeScope->AddChild(inner);
-    activeScope = inner;
+    scopeStarts.push_back(undoLog.size());
 }
 
-Symbol *ScopeTree::Find(const std::string &name)
+void ScopeTree::StartScope(SymbolTable *table)
 {
-    Symbol *res = nullptr;
-    auto currentScope = activeScope;
-    do
-    {
-        if ((res = currentScope->Find(name))) return res;
-        currentScope = currentScope->GetParent();
-    } while (currentScope);
-    return res;
+    StartScope();
+    for (auto &it: table->table)
+        Insert((NameId)it.first, it.second.symbol, (SymbolNamespace)(it.first >> 32));
 }
 
 void ScopeTree::EndScope()
 {
-    activeScope = activeScope->GetParent();
+    for (auto start = scopeStarts.back(); undoLog.size() > start; undoLog.pop_back())
+        bindings[undoLog.back().key] = undoLog.back().binding;
+    scopeStarts.pop_back();
+}
+
+void ScopeTree::Insert(NameId name, Symbol *symbol, SymbolNamespace ns)
+{
+    if (scopeStarts.empty())
+    {
+        root->Insert(name, symbol, ns);
+        return;
+    }
+    auto depth = (uint32_t)scopeStarts.size();
+    auto key = SymbolTable::key(name, ns);
+    auto &binding = bindings[key];
+    if (!binding.symbol || binding.depth != depth)
+        undoLog.push_back(Shadowed{key, binding});
+    binding = Binding{symbol, depth};
+}
+
+Symbol *ScopeTree::Find(NameId name, SymbolNamespace ns) const
+{
+    auto it = bindings.find(SymbolTable::key(name, ns));
+    if (it != bindings.end() && it->second.symbol)
+        return it->second.symbol;
+    return root->Find(name, ns, visibleGlobals);
 }
 
-void ScopeTree::SetActiveScope(SymbolTable *table)
+Symbol *ScopeTree::FindInActiveScope(NameId name, SymbolNamespace ns) const
 {
-    activeScope = table;
+    if (scopeStarts.empty())
+        return root->Find(name, ns);
+    auto it = bindings.find(SymbolTable::key(name, ns));
+    return it != bindings.end() && it->second.symbol && it->second.depth == scopeStarts.size() ?
+           it->second.symbol : nullptr;
 }
@@ -1,8 +1,9 @@
 #include "../includes/semantic_analyzer.h"
+#include "../includes/symbols/type_context.h"
 
-IdNode *SemanticAnalyzer::BuildIdNode(std::shared_ptr<Token> token)
+IdNode *SemanticAnalyzer::BuildIdNode(Token token)
 {
-    auto symbol = scopeTree.Find(token->text);
+    auto symbol = scopeTree.Find(token.GetNameId());
     if (!symbol) throw UndeclaredIdentifierError(token);
     if (symbol->GetSymbolClass() == SymbolClass::UNDEFINED) throw UnknownError(); // Unreachable
     if (symbol->GetSymbolClass() == SymbolClass::VARIABLE)
@@ -29,7 +30,8 @@ IdNode *SemanticAnalyzer::BuildIdNode(std::shared_ptr<Token> token)
             case TypeKind::TYPEDEF:
                 throw BadTypedefUsageError((SymAlias *)symbol);
             case TypeKind::ENUMERATOR:
-                return (IdNode *)((SymEnumerator *)symbol)->GetValue();
+                // every use gets a copy of the constant, conversions change the node they are given
+                return (IdNode *)new IntConstNode(*(IntConstNode *)((SymEnumerator *)symbol)->GetValue());
         }
     }
     throw UnknownError(); // Unreachable
@@ -37,7 +39,7 @@ IdNode *SemanticAnalyzer::BuildIdNode(std::shared_ptr<Token> token)
 
 StructSpecifierNode *SemanticAnalyzer::BuildStructSpecifierNode(IdNode *tag,
                                                                 StructDeclarationListNode *structDeclarationList,
-                                                                std::shared_ptr<Token> structToken)
+                                                                Token structToken)
 {
     if (!tag && !structDeclarationList) throw UnknownError();
     SymRecord *rt = nullptr;
@@ -49,8 +51,8 @@ StructSpecifierNode *SemanticAnalyzer::BuildStructSpecifierNode(IdNode *tag,
     Symbol *s = nullptr;
     if (tag)
     {
-        s = structDeclarationList ? scopeTree.GetActiveScope()->Find("struct " + tag->GetName()) :
-            scopeTree.Find("struct " + tag->GetName());
+        s = structDeclarationList ? scopeTree.FindInActiveScope(tag->GetNameId(), SymbolNamespace::STRUCT) :
+            scopeTree.Find(tag->GetNameId(), SymbolNamespace::STRUCT);
         if (s)
         {
             if (s->GetSymbolClass() != SymbolClass::TYPE) throw UnknownError(); // Unreachable
@@ -65,14 +67,17 @@ StructSpecifierNode *SemanticAnalyzer::BuildStructSpecifierNode(IdNode *tag,
             {
                 record->SetFieldsTable(rt->GetFieldsTable());
                 record->SetOrderedFields(rt->GetOrderedFields());
+                if (scopeTree.InFileScope()) record->SetCompletionOrder(scopeTree.GetFileScope()->TakeOrder());
+                definedRecords.emplace_back(structToken.GetPosition(), record);
 //                *record = *rt;
             }
             return new StructSpecifierNode(record, structToken);
         }
         if (!rt) rt = new SymRecord(tag);
         rt->SetName("struct " + tag->GetName());
-        scopeTree.GetActiveScope()->Insert(rt->GetName(), rt);
+        scopeTree.Insert(tag->GetNameId(), rt, SymbolNamespace::STRUCT);
     }
+    if (structDeclarationList) definedRecords.emplace_back(structToken.GetPosition(), rt);
     return new StructSpecifierNode(rt, structToken);
 }
 
@@ -81,7 +86,24 @@ ScopeTree *SemanticAnalyzer::GetScopeTree()
     return &scopeTree;
 }
 
-PostfixDecrementNode *SemanticAnalyzer::BuildPostfixDecrementNode(ExprNode *expr, const std::shared_ptr<Token> &op)
+std::vector<std::pair<Position, SymRecord *>> &SemanticAnalyzer::DefinedRecords()
+{
+    return definedRecords;
+}
+
+void SemanticAnalyzer::FoldConstants(bool fold)
+{
+    foldConstants = fold;
+}
+
+ExprNode *SemanticAnalyzer::fold(ExprNode *expr)
+{
+    if (!foldConstants) return expr;
+    auto value = evaluator.Fold(expr);
+    return value ? value : expr;
+}
+
+PostfixDecrementNode *SemanticAnalyzer::BuildPostfixDecrementNode(ExprNode *expr, Token op)
 {
     CheckIncDecRules(expr, op);
     auto res = new PostfixDecrementNode(expr);
@@ -89,7 +111,7 @@ PostfixDecrementNode *SemanticAnalyzer::BuildPostfixDecrementNode(ExprNode *expr
     return new PostfixDecrementNode(expr);
 }
 
-PostfixIncrementNode *SemanticAnalyzer::BuildPostfixIncrementNode(ExprNode *expr, const std::shared_ptr<Token> &op)
+PostfixIncrementNode *SemanticAnalyzer::BuildPostfixIncrementNode(ExprNode *expr, Token op)
 {
     CheckIncDecRules(expr, op);
     auto res = new PostfixIncrementNode(expr);
@@ -97,7 +119,7 @@ PostfixIncrementNode *SemanticAnalyzer::BuildPostfixIncrementNode(ExprNode *expr
     return res;
 }
 
-void SemanticAnalyzer::CheckIncDecRules(ExprNode *expr, std::shared_ptr<Token> op)
+void SemanticAnalyzer::CheckIncDecRules(ExprNode *expr, Token op)
 {
     if (!isModifiableLvalue(expr)) throw RequiredModifiableLvalueError(expr);
     auto type = unqualify(expr->GetType());
@@ -122,26 +144,26 @@ InitDeclaratorNode *SemanticAnalyzer::BuildInitDeclaratorNode(DeclaratorNode *de
                                                               InitializerNode *initializer,
                                                               bool isTypedef)
 {
-    auto prev = scopeTree.GetActiveScope()->Find(declarator->GetId()->GetName()); // TODO FUNCTIONS
+    auto prev = scopeTree.FindInActiveScope(declarator->GetId()->GetNameId()); // TODO FUNCTIONS
     if (prev) throw RedeclarationError(declarator->GetId(), prev);
-    auto name = declarator->GetId()->GetName();
+    auto name = declarator->GetId()->GetNameId();
     auto t = declarator->GetType();
     SymVariable *var = nullptr;
     if (t->GetTypeKind() == TypeKind::FUNCTION)
     {
         if (isTypedef)
-            scopeTree.GetActiveScope()->Insert(name, new SymAlias(name, t));
+            scopeTree.Insert(name, new SymAlias(name, t));
         else
         {
-            ((SymFunction *)t)->SetName(declarator->GetId()->GetName());
-            scopeTree.GetActiveScope()->Insert(declarator->GetId()->GetName(), t);
+            ((SymFunction *)t)->SetName(declarator->GetId()->GetNameId());
+            scopeTree.Insert(declarator->GetId()->GetNameId(), t);
         }
     }
     else
     {
         if (isVoidType(t)) throw UnknownVariableStorageError(new SymVariable(name, t, declarator->GetId()));
         if (isTypedef)
-            scopeTree.GetActiveScope()->Insert(name, new SymAlias(name, t));
+            scopeTree.Insert(name, new SymAlias(name, t));
         else
         {
             var = new SymVariable(name, t, declarator->GetId());
@@ -150,7 +172,7 @@ InitDeclaratorNode *SemanticAnalyzer::BuildInitDeclaratorNode(DeclaratorNode *de
                 auto f = processingFunctions.top();
                 var->SetOffset(f->AllocateVariable(t->GetUnqualified()->Size()));
             }
-            scopeTree.GetActiveScope()->Insert(name, var);
+            scopeTree.Insert(name, var);
         }
 
     }
@@ -171,31 +193,29 @@ bool SemanticAnalyzer::isVoidPointer(SymType *type)
 }
 
 StructureOrUnionMemberAccessNode *
-SemanticAnalyzer::BuildStructureOrUnionMemberAccessNode(ExprNode *structure, IdNode *field, std::shared_ptr<Token> dot)
+SemanticAnalyzer::BuildStructureOrUnionMemberAccessNode(ExprNode *structure, IdNode *field, Token dot)
 {
     auto type = structure->GetType();
     if (type->GetTypeKind() != TypeKind::STRUCT) throw BadMemberAccessError(type, field);
     auto stype = (SymRecord *)unqualify(type);
     if (!stype->IsComplete()) throw BadMemberAccessError(stype);
     SymVariable *sfield;
-    if (!(sfield = (SymVariable *)stype->GetFieldsTable()->Find(field->GetName())))
+    if (!(sfield = (SymVariable *)stype->GetFieldsTable()->Find(field->GetNameId())))
         throw NonexistentMemberError(stype, field);
     field->SetVariable(sfield);
     auto res = new StructureOrUnionMemberAccessNode(structure, field);
     res->SetPosition(dot);
     uint32_t squals = type->IsQualified() ? ((SymQualifiedType *)type)->GetQualifiers() : 0;
     auto rest = sfield->GetType();
-    if (rest->IsQualified())
-        ((SymQualifiedType *)rest)->SetQualifiers(((SymQualifiedType *)rest)->GetQualifiers() | squals);
-    else
-        rest = new SymQualifiedType(rest, squals);
-    res->SetType(rest);
+    uint32_t fquals = rest->IsQualified() ? ((SymQualifiedType *)rest)->GetQualifiers() : 0;
+    // the type of the field itself is shared, the access gets a type of its own
+    res->SetType(Types.Qualified(unqualify(rest), fquals | squals));
     res->SetValueCategory(structure->GetValueCategory());
     return res;
 }
 
 StructureOrUnionMemberAccessByPointerNode *
-SemanticAnalyzer::BuildStructureOrUnionMemberAccessByPointerNode(ExprNode *ptr, IdNode *field, std::shared_ptr<Token> arrow)
+SemanticAnalyzer::BuildStructureOrUnionMemberAccessByPointerNode(ExprNode *ptr, IdNode *field, Token arrow)
 {
     if (isConstQualified(ptr)) throw InvalidOperandError(arrow, nullptr);
     performLvalueConversion(ptr);
@@ -207,7 +227,7 @@ SemanticAnalyzer::BuildStructureOrUnionMemberAccessByPointerNode(ExprNode *ptr,
     auto stype = (SymRecord *)unqualify(ptype->GetTarget());
     if (!stype->IsComplete()) throw BadMemberAccessError(stype); // TODO InvalidUseOfIncompleteTypeError
     SymVariable *sfield;
-    if (!(sfield = (SymVariable *)stype->GetFieldsTable()->Find(field->GetName())))
+    if (!(sfield = (SymVariable *)stype->GetFieldsTable()->Find(field->GetNameId())))
         throw NonexistentMemberError(stype, field);
     field->SetVariable(sfield);
     auto res = new StructureOrUnionMemberAccessByPointerNode(ptr, field);
@@ -215,11 +235,8 @@ SemanticAnalyzer::BuildStructureOrUnionMemberAccessByPointerNode(ExprNode *ptr,
     res->SetValueCategory(ValueCategory::LVAVLUE);
     auto rest = sfield->GetType();
     uint32_t squals = ptype->GetTarget()->IsQualified() ? ((SymQualifiedType *)ptype->GetTarget())->GetQualifiers() : 0;
-    if (rest->IsQualified())
-        ((SymQualifiedType *)rest)->SetQualifiers(((SymQualifiedType *)rest)->GetQualifiers() | squals);
-    else
-        rest = new SymQualifiedType(rest, squals);
-    res->SetType(rest);
+    uint32_t fquals = rest->IsQualified() ? ((SymQualifiedType *)rest)->GetQualifiers() : 0;
+    res->SetType(Types.Qualified(unqualify(rest), fquals | squals));
     return res;
 }
 
@@ -266,11 +283,9 @@ FunctionCallNode *SemanticAnalyzer::BuildFunctionCallNode(ExprNode *func, Argume
     }
     for (auto &arg : args->List())
     {
+        performLvalueConversion(arg);
         if (!arg->GetType()->Equal(ftype->GetOderedParams()[i]->GetType()))
-        {
-            performLvalueConversion(arg);
             Convert(&arg, ftype->GetOderedParams()[i]->GetType());
-        }
         i++;
     }
     auto res = new FunctionCallNode(func, args);
@@ -278,7 +293,7 @@ FunctionCallNode *SemanticAnalyzer::BuildFunctionCallNode(ExprNode *func, Argume
     return res;
 }
 
-PrefixIncrementNode *SemanticAnalyzer::BuildPrefixIncrementNode(ExprNode *expr, const std::shared_ptr<Token> &op)
+PrefixIncrementNode *SemanticAnalyzer::BuildPrefixIncrementNode(ExprNode *expr, Token op)
 {
     CheckIncDecRules(expr, op);
     return new PrefixIncrementNode(expr);
@@ -291,23 +306,23 @@ void SemanticAnalyzer::performLvalueConversion(ExprNode *expr)
         expr->SetType(expr->GetType()->GetUnqualified());
 }
 
-PrefixDecrementNode *SemanticAnalyzer::BuildPrefixDecrementNode(ExprNode *expr, const std::shared_ptr<Token> &op)
+PrefixDecrementNode *SemanticAnalyzer::BuildPrefixDecrementNode(ExprNode *expr, Token op)
 {
     CheckIncDecRules(expr, op);
     return new PrefixDecrementNode(expr);
 }
 
-UnaryOpNode *SemanticAnalyzer::BuildUnaryOpNode(std::shared_ptr<Token> unaryOp, ExprNode *expr)
+ExprNode *SemanticAnalyzer::BuildUnaryOpNode(Token unaryOp, ExprNode *expr)
 {
-    if (unaryOp->type != TokenType::BITWISE_AND) performLvalueConversion(expr);
+    if (unaryOp.GetType() != TokenType::BITWISE_AND) performLvalueConversion(expr);
     UnaryOpNode *res = nullptr;
     SymType *t = unqualify(expr->GetType());
-    switch (unaryOp->type)
+    switch (unaryOp.GetType())
     {
         case TokenType::BITWISE_AND:
             if (expr->GetValueCategory() != ValueCategory::LVAVLUE) throw InvalidOperandError(unaryOp, expr->GetType());
             res = new UnaryOpNode(unaryOp, expr);
-            res->SetType(new SymPointer(expr->GetType()));
+            res->SetType(Types.Pointer(expr->GetType()));
             return res;
         case TokenType::ASTERIX:
             if (expr->GetType()->GetTypeKind() != TypeKind::POINTER) throw InvalidOperandError(unaryOp, expr->GetType());
@@ -320,27 +335,28 @@ UnaryOpNode *SemanticAnalyzer::BuildUnaryOpNode(std::shared_ptr<Token> unaryOp,
             if (isUnsignedIntegerType(expr->GetType()))
             {
                 // TODO this is wrong conversion, because I probably won't support int64
-                expr = new TypeCastNode(new SymBuiltInType(BuiltInTypeKind::INT32), expr);
+                expr = fold(new TypeCastNode(Types.BuiltIn(BuiltInTypeKind::INT32), expr));
             }
             res = new UnaryOpNode(unaryOp, expr);
             res->SetType(expr->GetType());
-            return res;
+            return fold(res);
         case TokenType::PLUS:
             if (!isArithmeticType(expr->GetType())) throw InvalidOperandError(unaryOp, expr->GetType());
             res = new UnaryOpNode(unaryOp, expr);
             res->SetType(expr->GetType());
-            return res;
+            return fold(res);
         case TokenType::BITWISE_NOT:
             if (!isIntegerType(expr->GetType())) throw InvalidOperandError(unaryOp, expr->GetType());
             res = new UnaryOpNode(unaryOp, expr);
             res->SetType(expr->GetType());
-            return res;
+            return fold(res);
         case TokenType::LOGIC_NO:
             if (!isScalarType(expr->GetType())) throw InvalidOperandError(unaryOp, expr->GetType());
             res = new UnaryOpNode(unaryOp, expr);
-            res->SetType(new SymBuiltInType(BuiltInTypeKind::INT32));
-            return res;
+            res->SetType(Types.BuiltIn(BuiltInTypeKind::INT32));
+            return fold(res);
     }
+    throw UnknownError(); // Unreachable
 }
 
 bool SemanticAnalyzer::isUnsignedIntegerType(SymType *type)
@@ -358,27 +374,27 @@ bool SemanticAnalyzer::isScalarType(SymType *type)
     return type->GetTypeKind() == TypeKind::BUILTIN || type->GetTypeKind() == TypeKind::POINTER;
 }
 
-BinOpNode *SemanticAnalyzer::BuildBinOpNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> binOp)
+ExprNode *SemanticAnalyzer::BuildBinOpNode(ExprNode *left, ExprNode *right, Token binOp)
 {
     BinOpNode *res = nullptr;
     performLvalueConversion(left); performArrayConversion(left);
     performLvalueConversion(right); performArrayConversion(right);
     auto ltype = left->GetType(), rtype = right->GetType();
-    switch (binOp->type)
+    switch (binOp.GetType())
     {
         case TokenType::REMINDER:
             if (!isIntegerType(ltype) || !isIntegerType(rtype)) throw InvalidOperandError(binOp, ltype, rtype);
             ImplicitlyConvert(&left, &right);
-            return new BinOpNode(left, right, binOp);
+            return fold(new BinOpNode(left, right, binOp));
         case TokenType::ASTERIX: case TokenType::FORWARD_SLASH:
             if (!isArithmeticType(ltype) || !isArithmeticType(rtype)) throw InvalidOperandError(binOp, ltype, rtype);
             ImplicitlyConvert(&left, &right);
-            return new BinOpNode(left, right, binOp);
+            return fold(new BinOpNode(left, right, binOp));
         case TokenType::PLUS:
             if (isArithmeticType(ltype) && isArithmeticType(rtype))
             {
                 ImplicitlyConvert(&left, &right);
-                return new BinOpNode(left, right, binOp);
+                return fold(new BinOpNode(left, right, binOp));
             }
             if (isPointerType(rtype))
                 std::swap(left, right);
@@ -389,12 +405,12 @@ BinOpNode *SemanticAnalyzer::BuildBinOpNode(ExprNode *left, ExprNode *right, std
             if (isArithmeticType(ltype) && isArithmeticType(rtype))
             {
                 ImplicitlyConvert(&left, &right);
-                return new BinOpNode(left, right, binOp);
+                return fold(new BinOpNode(left, right, binOp));
             }
             if (isPointerType(ltype) && isPointerType(rtype) && unqualify(rtype)->Equal(unqualify(ltype)))
             {
                 res = new BinOpNode(left, right, binOp);
-                res->SetType(new SymBuiltInType(BuiltInTypeKind::INT32, 0));
+                res->SetType(Types.BuiltIn(BuiltInTypeKind::INT32));
                 return res;
             }
             if (isPointerType(ltype) && isIntegerType(rtype))
@@ -403,46 +419,45 @@ BinOpNode *SemanticAnalyzer::BuildBinOpNode(ExprNode *left, ExprNode *right, std
         case TokenType::BITWISE_LSHIFT: case TokenType::BITWISE_RSHIFT:
         case TokenType::BITWISE_AND: case TokenType::BITWISE_XOR: case TokenType::BITWISE_OR:
             if (!isIntegerType(ltype) || !isIntegerType(rtype)) throw InvalidOperandError(binOp, ltype, rtype);
-            return new BinOpNode(left, right, binOp);
+            return fold(new BinOpNode(left, right, binOp));
         case TokenType::RELOP_LE: case TokenType::RELOP_LT:
         case TokenType::RELOP_GE: case TokenType::RELOP_GT:
             if (isArithmeticType(ltype) && isArithmeticType(rtype))
             {
                 ImplicitlyConvert(&left, &right);
-                return new BinOpNode(left, right, binOp, new SymBuiltInType(BuiltInTypeKind::INT32, 0));
+                return fold(new BinOpNode(left, right, binOp, Types.BuiltIn(BuiltInTypeKind::INT32)));
             }
             if (isPointerType(ltype) && isPointerType(rtype) && ltype->Equal(rtype))
-                return new BinOpNode(left, right, binOp, new SymBuiltInType(BuiltInTypeKind::INT32, 0));
+                return new BinOpNode(left, right, binOp, Types.BuiltIn(BuiltInTypeKind::INT32));
             throw InvalidOperandError(binOp, ltype, rtype);
         case TokenType::RELOP_EQ: case TokenType::RELOP_NE:
             if (isArithmeticType(ltype) && isArithmeticType(rtype))
             {
                 ImplicitlyConvert(&left, &right);
-                return new BinOpNode(left, right, binOp, new SymBuiltInType(BuiltInTypeKind::INT32, 0));
+                return fold(new BinOpNode(left, right, binOp, Types.BuiltIn(BuiltInTypeKind::INT32)));
             }
             if (isPointerType(ltype) && isPointerType(rtype))
             {
                  if (ltype->Equal(rtype) || isVoidPointer(ltype) || isVoidPointer(rtype)) // TODO isNullPointerConstant
-                    return new BinOpNode(left, right, binOp, new SymBuiltInType(BuiltInTypeKind::INT32, 0));
+                    return new BinOpNode(left, right, binOp, Types.BuiltIn(BuiltInTypeKind::INT32));
             }
             throw InvalidOperandError(binOp, ltype, rtype);
         case TokenType::LOGIC_OR: case TokenType::LOGIC_AND:
             if (!isScalarType(ltype) || !isScalarType(rtype)) throw InvalidOperandError(binOp, ltype, rtype);
-            return new BinOpNode(left, right, binOp, new SymBuiltInType(BuiltInTypeKind::INT32, 0)); // TODO typepool
+            return fold(new BinOpNode(left, right, binOp, Types.BuiltIn(BuiltInTypeKind::INT32)));
     }
     return nullptr;
 }
 
-TernaryOperatorNode *
-SemanticAnalyzer::BuildTernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse,
-                                           const std::shared_ptr<Token> &question, const std::shared_ptr<Token> &colon)
+ExprNode *SemanticAnalyzer::BuildTernaryOperatorNode(ExprNode *condition, ExprNode *iftrue, ExprNode *iffalse,
+                                              Token question, Token colon)
 {
     auto ctype = condition->GetType(), ttype = iftrue->GetType(), ftype = iffalse->GetType();
     if (!isScalarType(ctype)) throw RequiredScalarTypeError(question, ctype);
     if (isArithmeticType(ttype) && isArithmeticType(ftype))
     {
         ImplicitlyConvert(&iftrue, &iffalse);
-        return new TernaryOperatorNode(condition, iftrue, iffalse);
+        return fold(new TernaryOperatorNode(condition, iftrue, iffalse));
     }
     if (isPointerType(ttype) && isPointerType(ftype))
     {
@@ -454,12 +469,21 @@ SemanticAnalyzer::BuildTernaryOperatorNode(ExprNode *condition, ExprNode *iftrue
     throw InvalidOperandError(colon, ttype, ftype);
 }
 
-AssignmentNode *SemanticAnalyzer::BuildAssignmentNode(ExprNode *left, ExprNode *right, std::shared_ptr<Token> assignmentOp)
+ExprNode *SemanticAnalyzer::BuildCommaSeparatedExprs(ExprNode *left, ExprNode *right)
+{
+    auto list = new CommaSeparatedExprs();
+    list->Add(left);
+    list->Add(right);
+    list->SetPosition(left->GetPosition());
+    return fold(list);
+}
+
+AssignmentNode *SemanticAnalyzer::BuildAssignmentNode(ExprNode *left, ExprNode *right, Token assignmentOp)
 {
     if (!isModifiableLvalue(left)) throw RequiredModifiableLvalueError(left);
     performLvalueConversion(right); performArrayConversion(right);
     auto ltype = left->GetType(), rtype = right->GetType();
-    if (assignmentOp->type != TokenType::ASSIGNMENT)
+    if (assignmentOp.GetType() != TokenType::ASSIGNMENT)
         right = BuildBinOpNode(left, right, extractArithmeticOperationFromAssignmentBy(assignmentOp));  // TODO redo
     left->SetType(ltype);
     rtype = unqualify(right->GetType());
@@ -493,31 +517,31 @@ bool SemanticAnalyzer::isConstQualified(ExprNode *expr)
     return expr->GetType()->IsQualified() && ((SymQualifiedType *)expr->GetType())->GetQualifiers() & 1U;
 }
 
-std::shared_ptr<Token> SemanticAnalyzer::extractArithmeticOperationFromAssignmentBy(const std::shared_ptr<Token> &assignemtBy)
+Token SemanticAnalyzer::extractArithmeticOperationFromAssignmentBy(Token assignemtBy)
 {
-    auto pos = assignemtBy->position;
-    switch (assignemtBy->type)
+    auto pos = assignemtBy.GetPosition();
+    switch (assignemtBy.GetType())
     {
         case TokenType::ASSIGNMENT_BY_REMINDER:
-            return std::make_shared<Token>(TokenType::REMINDER, pos.row, pos.col, "%");
+            return Token::Create(TokenType::REMINDER, pos.row, pos.col, "%");
         case TokenType::ASSIGNMENT_BY_BITWISE_XOR:
-            return std::make_shared<Token>(TokenType::BITWISE_XOR, pos.row, pos.col, "^");
+            return Token::Create(TokenType::BITWISE_XOR, pos.row, pos.col, "^");
         case TokenType::ASSIGNMENT_BY_BITWISE_AND:
-            return std::make_shared<Token>(TokenType::BITWISE_AND, pos.row, pos.col, "&");
+            return Token::Create(TokenType::BITWISE_AND, pos.row, pos.col, "&");
         case TokenType::ASSIGNMENT_BY_BITWISE_RSHIFT:
-            return std::make_shared<Token>(TokenType::BITWISE_RSHIFT, pos.row, pos.col, ">>");
+            return Token::Create(TokenType::BITWISE_RSHIFT, pos.row, pos.col, ">>");
         case TokenType::ASSIGNMENT_BY_BITWISE_LSHIFT:
-            return std::make_shared<Token>(TokenType::BITWISE_LSHIFT, pos.row, pos.col, "<<");
+            return Token::Create(TokenType::BITWISE_LSHIFT, pos.row, pos.col, "<<");
         case TokenType::ASSIGNMENT_BY_DIFFERENCE:
-            return std::make_shared<Token>(TokenType::MINUS, pos.row, pos.col, "-");
+            return Token::Create(TokenType::MINUS, pos.row, pos.col, "-");
         case TokenType::ASSIGNMENT_BY_SUM:
-            return std::make_shared<Token>(TokenType::PLUS, pos.row, pos.col, "+");
+            return Token::Create(TokenType::PLUS, pos.row, pos.col, "+");
         case TokenType::ASSIGNMENT_BY_QUOTIENT:
-            return std::make_shared<Token>(TokenType::FORWARD_SLASH, pos.row, pos.col, "/");
+            return Token::Create(TokenType::FORWARD_SLASH, pos.row, pos.col, "/");
         case TokenType::ASSIGNMENT_BY_PRODUCT:
-                return std::make_shared<Token>(TokenType::ASTERIX, pos.row, pos.col, "*");
+                return Token::Create(TokenType::ASTERIX, pos.row, pos.col, "*");
         case TokenType::ASSIGNMENT_BY_BITWISE_OR:
-            return std::make_shared<Token>(TokenType::BITWISE_OR, pos.row, pos.col, "|");
+            return Token::Create(TokenType::BITWISE_OR, pos.row, pos.col, "|");
         default:
             throw UnknownError();
     }
@@ -534,9 +558,9 @@ void SemanticAnalyzer::ImplicitlyConvert(ExprNode **left, ExprNode **right)
         {
             auto rbt = (SymBuiltInType *)rtype;
             if (lbt->GetBuiltInTypeKind() > rbt->GetBuiltInTypeKind())
-                *right = new TypeCastNode(lbt, *right);
+                *right = fold(new TypeCastNode(lbt, *right));
             else if (lbt->GetBuiltInTypeKind() < rbt->GetBuiltInTypeKind())
-                *left = new TypeCastNode(rbt, *left);
+                *left = fold(new TypeCastNode(rbt, *left));
         }
     }
 }
@@ -548,7 +572,7 @@ void SemanticAnalyzer::Convert(ExprNode **expr, SymType *type)
     if (isArithmeticType(etype) && isArithmeticType(type) || isIntegerType(etype) && isPointerType(type)
             || isPointerType(etype) && isPointerType(type))
     {
-        *expr = new TypeCastNode(type, *expr);
+        *expr = fold(new TypeCastNode(type, *expr));
         return;
     }
     if (etype->GetTypeKind() == TypeKind::ARRAY && isPointerType(type))
@@ -569,7 +593,7 @@ SemanticAnalyzer::BuildFunctionDefinitionNode(DeclaratorNode *declarator, Compou
 {
     if (declarator->GetType()->GetTypeKind() != TypeKind::FUNCTION) throw BadCalledObjectError();
     auto f = (SymFunction *)unqualify(declarator->GetType());
-    auto sym = scopeTree.Find(declarator->GetId()->GetName());
+    auto sym = scopeTree.Find(declarator->GetId()->GetNameId());
     SymFunction *fdeclaration = nullptr;
     if (sym)
     {
@@ -584,10 +608,10 @@ SemanticAnalyzer::BuildFunctionDefinitionNode(DeclaratorNode *declarator, Compou
         f = fdeclaration; // f = sym? TODO
     }
     f->Define();
-    f->SetName(declarator->GetId()->GetName());
+    f->SetName(declarator->GetId()->GetNameId());
     processingFunctions.push(f);
-    scopeTree.GetActiveScope()->Insert(declarator->GetId()->GetName(), f);
-    scopeTree.SetActiveScope(f->GetParamsTable());
+    scopeTree.Insert(declarator->GetId()->GetNameId(), f);
+    scopeTree.StartScope(f->GetParamsTable());
     auto res = new FunctionDefinitionNode(declarator, nullptr);
     return res;
 }
@@ -603,44 +627,58 @@ bool SemanticAnalyzer::isStructType(SymType *type)
     return type->GetTypeKind() == TypeKind::STRUCT;
 }
 
-TypeCastNode *SemanticAnalyzer::BuildTypeCastNode(SymType *typeName, ExprNode *castExpr)
+ExprNode *SemanticAnalyzer::BuildTypeCastNode(SymType *typeName, ExprNode *castExpr)
 {
     Convert(&castExpr, typeName);
-    return (TypeCastNode *)castExpr;
+    return castExpr;
 }
 
-EnumeratorNode *SemanticAnalyzer::BuildEnumeratorNode(IdNode *enumerator, ExprNode *expr)
+ExprNode *SemanticAnalyzer::BuildSizeofExprNode(ExprNode *expr, Token sizeofToken)
+{
+    auto res = new SizeofExprNode(expr);
+    res->SetPosition(sizeofToken);
+    return fold(res);
+}
+
+ExprNode *SemanticAnalyzer::BuildSizeofTypeNameNode(SymType *typeName, Token sizeofToken)
+{
+    auto res = new SizeofTypeNameNode(typeName);
+    res->SetPosition(sizeofToken);
+    return fold(res);
+}
+
+EnumeratorNode *SemanticAnalyzer::BuildEnumeratorNode(IdNode *enumerator, ExprNode *expr, EnumeratorNode *previous)
 {
-    auto prev = -1;
-    Evaluator evaluator;
     if (!expr)
     {
-        auto token = std::make_shared<Token>(TokenType::NUM_INT, -1, -1, std::to_string(prev + 1));
-        token->intValue = ++prev;
-        expr = new IntConstNode(token);
+        // one more than the enumerator before it, the first one is 0
+        auto prev = previous ? static_cast<IntConstNode *>(previous->GetValue())->GetValue() : -1;
+        expr = new IntConstNode((int32_t)((uint32_t)prev + 1));
     }
     else
     {
         expr = evaluator.Eval(expr);
         if (!expr) throw RequiredConstantExpressionError(enumerator);
-        auto intconst = dynamic_cast<IntConstNode *>(expr);
-        if (!intconst) throw RequiredConstantExpressionError(enumerator);
-        prev = intconst->GetValue();
+        if (expr->GetNodeKind() != NodeKind::INT_CONST) throw RequiredConstantExpressionError(enumerator);
+        // enumeration constants are ints whatever the type of the expression is
+        if (expr->GetType() != Types.BuiltIn(BuiltInTypeKind::INT32))
+            expr = new IntConstNode(static_cast<IntConstNode *>(expr)->GetValue());
     }
-    auto symenumerator = scopeTree.GetActiveScope()->Find(enumerator->GetName());
+    auto symenumerator = scopeTree.FindInActiveScope(enumerator->GetNameId());
     if (symenumerator) throw RedeclarationError(enumerator, symenumerator);
-    scopeTree.GetActiveScope()->Insert(enumerator->GetName(), new SymEnumerator(enumerator->GetName(), expr));
+    scopeTree.Insert(enumerator->GetNameId(), new SymEnumerator(enumerator->GetNameId(), expr));
     return new EnumeratorNode(enumerator, expr);
 }
 
 EnumSpecifierNode *SemanticAnalyzer::BuildEnumSpecifierNode(IdNode *tag, EnumeratorList *list)
 {
     if (!tag) return new EnumSpecifierNode(tag, list);
-    auto declaration = scopeTree.GetActiveScope()->Find("enum " + tag->GetName());
+    auto declaration = scopeTree.FindInActiveScope(tag->GetNameId(), SymbolNamespace::ENUM);
     if (declaration)
     {
-        auto symenum = dynamic_cast<SymEnum *>(declaration);
-        if (!symenum) throw RedeclarationError(tag, declaration);
+        auto type = AsType(declaration);
+        if (!type || type->GetTypeKind() != TypeKind::ENUM) throw RedeclarationError(tag, declaration);
+        auto symenum = static_cast<SymEnum *>(type);
         if (symenum->Defined() && list) throw RedeclarationError(tag, symenum);
         if (list) symenum->Define();
     }
@@ -648,7 +686,7 @@ EnumSpecifierNode *SemanticAnalyzer::BuildEnumSpecifierNode(IdNode *tag, Enumera
     {
         auto symenum = new SymEnum(tag);
         if (list) symenum->Define();
-        scopeTree.GetActiveScope()->Insert("enum " + tag->GetName(), symenum);
+        scopeTree.Insert(tag->GetNameId(), symenum, SymbolNamespace::ENUM);
     }
     return new EnumSpecifierNode(tag, list);
 }
@@ -658,12 +696,17 @@ void SemanticAnalyzer::ProcessFunction(SymFunction *funcType)
     processingFunctions.push(funcType);
 }
 
+SymFunction *SemanticAnalyzer::GetProcessingFunction() const
+{
+    return processingFunctions.top();
+}
+
 void SemanticAnalyzer::FinishLastFunctionProcessing()
 {
     processingFunctions.pop();
 }
 
-ReturnStatementNode *SemanticAnalyzer::BuildReturnStatementNode(std::shared_ptr<Token> statement, ExprNode *expr)
+ReturnStatementNode *SemanticAnalyzer::BuildReturnStatementNode(Token statement, ExprNode *expr)
 {
     if (processingFunctions.empty()) throw BadJumpStatementError(std::move(statement));
     auto type = processingFunctions.top();
@@ -694,21 +737,21 @@ void SemanticAnalyzer::FinishLastLoopProcessing()
     processingLoops.pop();
 }
 
-ContinueStatementNode *SemanticAnalyzer::BuildContinueStatementNode(std::shared_ptr<Token> statement)
+ContinueStatementNode *SemanticAnalyzer::BuildContinueStatementNode(Token statement)
 {
     if (processingLoops.empty()) throw BadJumpStatementError(std::move(statement));
     return new ContinueStatementNode();
 }
 
-BreakStatementNode *SemanticAnalyzer::BuildBreakStatementNode(std::shared_ptr<Token> statement)
+BreakStatementNode *SemanticAnalyzer::BuildBreakStatementNode(Token statement)
 {
     if (processingLoops.empty()) throw BadJumpStatementError(std::move(statement));
     return new BreakStatementNode();
 }
 
-TypedefIdentifierNode *SemanticAnalyzer::BuildTypedefIdentifierNode(const std::shared_ptr<Token> &id)
+TypedefIdentifierNode *SemanticAnalyzer::BuildTypedefIdentifierNode(Token id)
 {
-    auto t = dynamic_cast<SymAlias *>(scopeTree.Find(id->text));
+    auto t = AsAlias(scopeTree.Find(id.GetNameId()));
     return new TypedefIdentifierNode(t);
 }
 
@@ -725,19 +768,18 @@ bool SemanticAnalyzer::equalQualifiers(SymType *one, SymType *other)
 ExprNode *SemanticAnalyzer::EvaluateArraySizer(ExprNode *expr)
 {
     if (!isIntegerType(expr->GetType())) throw RequiredConstantIntegerExpressionError(expr);
-    expr = evaluator.Eval(expr);
-    auto constIntExpr = dynamic_cast<IntConstNode *>(expr);
-    if (!constIntExpr) throw RequiredConstantIntegerExpressionError(expr);
-    return expr;
+    auto value = evaluator.Eval(expr);
+    if (!value || value->GetNodeKind() != NodeKind::INT_CONST) throw RequiredConstantIntegerExpressionError(expr);
+    return value;
 }
 
 void SemanticAnalyzer::analyseInitializerList(SymType *current,
                                               InitializerNode *initializer,
                                               DesignatorNode *designator)
 {
-    auto simple = dynamic_cast<SimpleInitializer *>(initializer);
-    if (simple)
+    if (initializer->GetNodeKind() == NodeKind::SIMPLE_INITIALIZER)
     {
+        auto simple = static_cast<SimpleInitializer *>(initializer);
         auto value = simple->GetValue();
         Convert(&value, current);
         if (designator)
@@ -750,14 +792,14 @@ void SemanticAnalyzer::analyseInitializerList(SymType *current,
     current = unqualify(current);
     auto tp = current->GetTypeKind();
     if (tp != TypeKind::ARRAY && tp != TypeKind::STRUCT) throw "";
-    auto array = dynamic_cast<SymArray *>(current);
-    auto structure = dynamic_cast<SymRecord *>(current);
-    auto list = dynamic_cast<InitializerListNode *>(initializer);
+    auto array = tp == TypeKind::ARRAY ? static_cast<SymArray *>(current) : nullptr;
+    auto structure = tp == TypeKind::STRUCT ? static_cast<SymRecord *>(current) : nullptr;
+    auto list = static_cast<InitializerListNode *>(initializer);
     for (auto value: list->List())
     {
-        auto simple = dynamic_cast<SimpleInitializer *>(value);
-        if (simple)
+        if (value->GetNodeKind() == NodeKind::SIMPLE_INITIALIZER)
         {
+            auto simple = static_cast<SimpleInitializer *>(value);
             auto expr = simple->GetValue();
             if (array)
             {
@@ -773,9 +815,9 @@ void SemanticAnalyzer::analyseInitializerList(SymType *current,
             simple->SetValue(expr);
             continue;
         }
-        auto il = dynamic_cast<InitializerListNode *>(value);
-        if (il)
+        if (value->GetNodeKind() == NodeKind::INITIALIZER_LIST)
         {
+            auto il = static_cast<InitializerListNode *>(value);
             if (array)
             {
                 analyseInitializerList(array->GetValueType(), il);
@@ -788,23 +830,23 @@ void SemanticAnalyzer::analyseInitializerList(SymType *current,
             }
             continue;
         }
-        auto di = dynamic_cast<DesignatedInitializerNode *>(value);
-        if (di)
+        if (value->GetNodeKind() == NodeKind::DESIGNATED_INITIALIZER)
         {
+            auto di = static_cast<DesignatedInitializerNode *>(value);
             auto init = di->GetInitializer();
             for (auto designator: di->GetDesignation()->List())
             {
-                auto ad = dynamic_cast<ArrayDesignator *>(designator);
-                auto sd = dynamic_cast<StructMemberDesignator *>(designator);
-                if (sd)
+                if (designator->GetNodeKind() == NodeKind::STRUCT_MEMBER_DESIGNATOR)
                 {
+                    auto sd = static_cast<StructMemberDesignator *>(designator);
                     if (!structure) throw BadDesignatorError(sd);
-                    auto field = (SymVariable *)structure->GetFieldsTable()->Find(sd->GetMemberId()->GetName());
+                    auto field = (SymVariable *)structure->GetFieldsTable()->Find(sd->GetMemberId()->GetNameId());
                     if (!field) throw NonexistentMemberError(structure, sd->GetMemberId());
                     analyseInitializerList(unqualify(field->GetType()), init, sd);
                 }
                 else
                 {
+                    auto ad = static_cast<ArrayDesignator *>(designator);
                     if (!array) throw BadDesignatorError(ad);
                     analyseInitializerList(array->GetValueType(), init, ad);
                 }
@@ -819,9 +861,9 @@ PrintfNode *SemanticAnalyzer::BuildPrintfNode(StringLiteralNode *format, Argumen
         for (auto &arg: arguments->List())
         {
             performLvalueConversion(arg);
-            auto type = dynamic_cast<SymBuiltInType *>(arg->GetType()->GetUnqualified());
+            auto type = AsBuiltIn(arg->GetType()->GetUnqualified());
             if (type && type->GetBuiltInTypeKind() == BuiltInTypeKind::FLOAT)
-                arg = new TypeCastNode(new SymBuiltInType(BuiltInTypeKind::DOUBLE), arg);
+                arg = new TypeCastNode(Types.BuiltIn(BuiltInTypeKind::DOUBLE), arg);
         }
     return new PrintfNode(format, arguments);
 }
@@ -832,10 +874,10 @@ void SemanticAnalyzer::performArrayConversion(ExprNode *expr)
     auto etype = qt->GetUnqualified();
     if (etype->GetTypeKind() == TypeKind::ARRAY)
         if (!etype->IsQualified())
-            expr->SetType(new SymPointer(reinterpret_cast<SymArray *>(etype)->GetValueType()));
+            expr->SetType(Types.Pointer(reinterpret_cast<SymArray *>(etype)->GetValueType()));
         else
-            expr->SetType(new SymQualifiedType(new SymPointer(reinterpret_cast<SymArray *>(etype)->GetValueType()),
-                                               reinterpret_cast<SymQualifiedType *>(qt)->GetQualifiers()));
+            expr->SetType(Types.Qualified(Types.Pointer(reinterpret_cast<SymArray *>(etype)->GetValueType()),
+                                          reinterpret_cast<SymQualifiedType *>(qt)->GetQualifiers()));
 }
 
 void SemanticAnalyzer::CheckSelectionOrIterationStatementCondition(ExprNode *condition)
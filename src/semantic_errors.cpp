@@ -3,11 +3,11 @@
 #include "../includes/nodes/initializer.h"
 #include "../includes/nodes/decls.h"
 
-InvalidOperandError::InvalidOperandError(std::shared_ptr<Token> op, SymType *ltype, SymType *rtype)
+InvalidOperandError::InvalidOperandError(Token op, SymType *ltype, SymType *rtype)
 {
-    auto pos = op->position;
+    auto pos = op.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          "): Invalid operands for '" + op->text + "'";
+          "): Invalid operands for '" + std::string(op.GetText()) + "'";
 }
 
 const char *InvalidOperandError::what() const throw()
@@ -15,9 +15,9 @@ const char *InvalidOperandError::what() const throw()
     return msg.c_str();
 }
 
-InvalidOperandError::InvalidOperandError(std::shared_ptr<Token> op, SymType *type)
+InvalidOperandError::InvalidOperandError(Token op, SymType *type)
 {
-    msg =  "Invalid operands for '" + op->text + "'";
+    msg =  "Invalid operands for '" + std::string(op.GetText()) + "'";
 }
 
 BadIndexingError::BadIndexingError()
@@ -61,12 +61,12 @@ const char *IncompatibleDeclarationSpecifiersError::what() const throw()
     return msg.c_str();
 }
 
-IncompatibleDeclarationSpecifiersError::IncompatibleDeclarationSpecifiersError(std::shared_ptr<Token> token,
+IncompatibleDeclarationSpecifiersError::IncompatibleDeclarationSpecifiersError(Token token,
                                                                                std::string spec)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          "): both " + token->text + " and " + spec + " presented.";
+          "): both " + std::string(token.GetText()) + " and " + spec + " presented.";
 }
 
 const char *ManyDataTypesError::what() const throw()
@@ -74,9 +74,9 @@ const char *ManyDataTypesError::what() const throw()
     return msg.c_str();
 }
 
-ManyDataTypesError::ManyDataTypesError(std::shared_ptr<Token> token)
+ManyDataTypesError::ManyDataTypesError(Token token)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
           "): two or more data types in declaration specifiers. ";
 }
@@ -86,11 +86,11 @@ const char *DuplicateError::what() const throw()
     return msg.c_str();
 }
 
-DuplicateError::DuplicateError(std::shared_ptr<Token> token)
+DuplicateError::DuplicateError(Token token)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          "): duplicate " + token->text + ".";
+          "): duplicate " + std::string(token.GetText()) + ".";
 }
 
 const char *UnsupportedTypeError::what() const throw()
@@ -98,9 +98,9 @@ const char *UnsupportedTypeError::what() const throw()
     return msg.c_str();
 }
 
-UnsupportedTypeError::UnsupportedTypeError(std::shared_ptr<Token> token)
+UnsupportedTypeError::UnsupportedTypeError(Token token)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
           "): Unsupported combination of declaration specifiers. ";
 }
@@ -110,18 +110,18 @@ const char *TooLongError::what() const throw()
     return msg.c_str();
 }
 
-TooLongError::TooLongError(std::shared_ptr<Token> token, int longtimes)
+TooLongError::TooLongError(Token token, int longtimes)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
           "): " + std::to_string(longtimes) + "is too long for tcc.";
 }
 
-UndeclaredIdentifierError::UndeclaredIdentifierError(std::shared_ptr<Token> token)
+UndeclaredIdentifierError::UndeclaredIdentifierError(Token token)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          ") UndeclaredIdentifierError: " + token->stringValue + ".";
+          ") UndeclaredIdentifierError: " + std::string(token.GetText()) + ".";
 }
 
 const char *UndeclaredIdentifierError::what()  const throw()
@@ -149,11 +149,11 @@ BadMemberAccessError::BadMemberAccessError(SymType *record)
           "): invalid use of undefined type: '" + rec->GetName() + "'";
 }
 
-InvalidUseOfIncompleteType::InvalidUseOfIncompleteType(std::shared_ptr<Token> token, SymType *type)
+InvalidUseOfIncompleteType::InvalidUseOfIncompleteType(Token token, SymType *type)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          ") InvalidUseOfIncompleteType in '" + token->stringValue + "'.";
+          ") InvalidUseOfIncompleteType in '" + std::string(token.GetText()) + "'.";
 }
 
 const char *InvalidUseOfIncompleteType::what() const throw()
@@ -166,11 +166,11 @@ const char *RequiredScalarTypeError::what() const throw()
     return msg.c_str();
 }
 
-RequiredScalarTypeError::RequiredScalarTypeError(std::shared_ptr<Token> token, SymType *got)
+RequiredScalarTypeError::RequiredScalarTypeError(Token token, SymType *got)
 {
-    auto pos = token->position;
+    auto pos = token.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
-          ") Requaired scalar type in '" + token->stringValue + "'.";
+          ") Requaired scalar type in '" + std::string(token.GetText()) + "'.";
 }
 
 RequiredScalarTypeError::RequiredScalarTypeError(ExprNode *expr, SymType *got)
@@ -256,15 +256,15 @@ BadCalledObjectError::BadCalledObjectError()
     msg = "Called object is not a function";
 }
 
-BadJumpStatementError::BadJumpStatementError(std::shared_ptr<Token> statement)
+BadJumpStatementError::BadJumpStatementError(Token statement)
 {
-    auto pos = statement->position;
+    auto pos = statement.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
           "): ";
-    if (statement->keyword == Keyword::RETURN)
+    if (statement.GetKeyword() == Keyword::RETURN)
         msg += "return statement is out of function.";
     else
-        msg += statement->text + " statement is out of loop.";
+        msg += std::string(statement.GetText()) + " statement is out of loop.";
 }
 
 const char *BadJumpStatementError::what() const throw()
@@ -277,9 +277,9 @@ const char *VoidFunctionBadReturnError::what() const throw()
     return msg.c_str();
 }
 
-VoidFunctionBadReturnError::VoidFunctionBadReturnError(std::shared_ptr<Token> statement)
+VoidFunctionBadReturnError::VoidFunctionBadReturnError(Token statement)
 {
-    auto pos = statement->position;
+    auto pos = statement.GetPosition();
     msg = "(" + std::to_string(pos.row) + ", " + std::to_string(pos.col) +
           "): reurn with value if function returning void.";
 }
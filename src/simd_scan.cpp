@@ -0,0 +1,267 @@
+#include "simd_scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TCC_X86_SIMD
+#include <immintrin.h>
+#endif
+
+enum class RunKind
+{
+    WHITESPACE, IDENTIFIER, DIGITS, LINE_FEED, COMMENT_MARK
+};
+
+typedef const char *(*ScanFunction)(const char *p, const char *end, LineFeeds &lines);
+
+template<RunKind kind>
+constexpr bool countsLines()
+{
+    return kind == RunKind::WHITESPACE || kind == RunKind::COMMENT_MARK;
+}
+
+template<RunKind kind>
+static inline bool stops(uint8_t c)
+{
+    switch (kind)
+    {
+        case RunKind::WHITESPACE:
+            return c > ' ';
+        case RunKind::IDENTIFIER:
+            return !((c | 0x20) >= 'a' && (c | 0x20) <= 'z') && !(c >= '0' && c <= '9') && c != '_';
+        case RunKind::DIGITS:
+            return !(c >= '0' && c <= '9');
+        case RunKind::LINE_FEED:
+            return c == '\n';
+        case RunKind::COMMENT_MARK:
+            return c == '*' || c == '/';
+    }
+}
+
+template<RunKind kind>
+static const char *scanScalar(const char *p, const char *end, LineFeeds &lines)
+{
+    for (; p != end && !stops<kind>((uint8_t)*p); p++)
+        if (countsLines<kind>() && *p == '\n')
+        {
+            lines.count++;
+            lines.lineStart = p + 1;
+        }
+    return p;
+}
+
+#ifdef TCC_X86_SIMD
+
+// feeds holds a bit for every line feed in the block starting at p
+static inline void countFeeds(const char *p, uint32_t feeds, LineFeeds &lines)
+{
+    if (!feeds)
+        return;
+    lines.count += __builtin_popcount(feeds);
+    lines.lineStart = p + 32 - __builtin_clz(feeds);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i inRange(__m128i x, char lo, char hi)
+{
+    return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(lo)), x),
+                         _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(hi)), x));
+}
+
+template<RunKind kind>
+__attribute__((target("sse2")))
+static inline uint32_t stopMask(__m128i x)
+{
+    switch (kind)
+    {
+        case RunKind::WHITESPACE:
+            return ~_mm_movemask_epi8(inRange(x, 0, ' ')) & 0xFFFF;
+        case RunKind::IDENTIFIER:
+            return ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(
+                    inRange(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z'), inRange(x, '0', '9')),
+                    _mm_cmpeq_epi8(x, _mm_set1_epi8('_')))) & 0xFFFF;
+        case RunKind::DIGITS:
+            return ~_mm_movemask_epi8(inRange(x, '0', '9')) & 0xFFFF;
+        case RunKind::LINE_FEED:
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')));
+        case RunKind::COMMENT_MARK:
+            return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('*')),
+                                                  _mm_cmpeq_epi8(x, _mm_set1_epi8('/'))));
+    }
+}
+
+template<RunKind kind>
+__attribute__((target("sse2")))
+static const char *scanSse2(const char *p, const char *end, LineFeeds &lines)
+{
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)p);
+        uint32_t stop = stopMask<kind>(x);
+        uint32_t feeds = countsLines<kind>() ? _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n'))) : 0;
+        if (stop)
+        {
+            int n = __builtin_ctz(stop);
+            countFeeds(p, feeds & ((1u << n) - 1), lines);
+            return p + n;
+        }
+        countFeeds(p, feeds, lines);
+    }
+    return scanScalar<kind>(p, end, lines);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i inRange(__m256i x, char lo, char hi)
+{
+    return _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, _mm256_set1_epi8(lo)), x),
+                            _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(hi)), x));
+}
+
+template<RunKind kind>
+__attribute__((target("avx2")))
+static inline uint32_t stopMask(__m256i x)
+{
+    switch (kind)
+    {
+        case RunKind::WHITESPACE:
+            return ~(uint32_t)_mm256_movemask_epi8(inRange(x, 0, ' '));
+        case RunKind::IDENTIFIER:
+            return ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(
+                    inRange(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z'), inRange(x, '0', '9')),
+                    _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'))));
+        case RunKind::DIGITS:
+            return ~(uint32_t)_mm256_movemask_epi8(inRange(x, '0', '9'));
+        case RunKind::LINE_FEED:
+            return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')));
+        case RunKind::COMMENT_MARK:
+            return (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('*')),
+                                                                  _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/'))));
+    }
+}
+
+template<RunKind kind>
+__attribute__((target("avx2,popcnt")))
+static const char *scanAvx2(const char *p, const char *end, LineFeeds &lines)
+{
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)p);
+        uint32_t stop = stopMask<kind>(x);
+        uint32_t feeds = countsLines<kind>()
+                         ? (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n'))) : 0;
+        if (stop)
+        {
+            int n = __builtin_ctz(stop);
+            countFeeds(p, feeds & ((1u << n) - 1), lines);
+            return p + n;
+        }
+        countFeeds(p, feeds, lines);
+    }
+    return scanSse2<kind>(p, end, lines);
+}
+
+#endif
+
+template<RunKind kind>
+static ScanFunction pick(SimdLevel level)
+{
+#ifdef TCC_X86_SIMD
+    if (level == SimdLevel::AVX2)
+        return scanAvx2<kind>;
+    if (level == SimdLevel::SSE2)
+        return scanSse2<kind>;
+#endif
+    return scanScalar<kind>;
+}
+
+static SimdLevel activeLevel = SimdLevel::SCALAR;
+static ScanFunction whitespaceScan = scanScalar<RunKind::WHITESPACE>;
+static ScanFunction identifierScan = scanScalar<RunKind::IDENTIFIER>;
+static ScanFunction digitsScan = scanScalar<RunKind::DIGITS>;
+static ScanFunction lineFeedScan = scanScalar<RunKind::LINE_FEED>;
+static ScanFunction commentMarkScan = scanScalar<RunKind::COMMENT_MARK>;
+
+SimdLevel DetectSimdLevel()
+{
+#ifdef TCC_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::SSE2;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel ActiveSimdLevel()
+{
+    return activeLevel;
+}
+
+void SelectSimdLevel(SimdLevel level)
+{
+    auto supported = DetectSimdLevel();
+    if (level > supported)
+        level = supported;
+    activeLevel = level;
+    whitespaceScan = pick<RunKind::WHITESPACE>(level);
+    identifierScan = pick<RunKind::IDENTIFIER>(level);
+    digitsScan = pick<RunKind::DIGITS>(level);
+    lineFeedScan = pick<RunKind::LINE_FEED>(level);
+    commentMarkScan = pick<RunKind::COMMENT_MARK>(level);
+}
+
+static bool simdSelected = (SelectSimdLevel(DetectSimdLevel()), true);
+
+const char *SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+// Most runs in real code are a few characters long and end before a vector load would pay off,
+// so every kernel looks at the first ShortRun characters one by one.
+constexpr long ShortRun = 8;
+
+template<RunKind kind>
+static inline const char *scan(ScanFunction kernel, const char *p, const char *end, LineFeeds &lines)
+{
+    auto limit = end - p > ShortRun ? p + ShortRun : end;
+    p = scanScalar<kind>(p, limit, lines);
+    if (p != limit || p == end)
+        return p;
+    return kernel(p, end, lines);
+}
+
+const char *SkipWhitespace(const char *p, const char *end, LineFeeds &lines)
+{
+    return scan<RunKind::WHITESPACE>(whitespaceScan, p, end, lines);
+}
+
+const char *SkipIdentifier(const char *p, const char *end)
+{
+    LineFeeds lines;
+    return scan<RunKind::IDENTIFIER>(identifierScan, p, end, lines);
+}
+
+const char *SkipDigits(const char *p, const char *end)
+{
+    LineFeeds lines;
+    return scan<RunKind::DIGITS>(digitsScan, p, end, lines);
+}
+
+const char *FindLineFeed(const char *p, const char *end)
+{
+    LineFeeds lines;
+    return scan<RunKind::LINE_FEED>(lineFeedScan, p, end, lines);
+}
+
+const char *FindCommentMark(const char *p, const char *end, LineFeeds &lines)
+{
+    return scan<RunKind::COMMENT_MARK>(commentMarkScan, p, end, lines);
+}
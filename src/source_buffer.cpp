@@ -0,0 +1,54 @@
+#include "source_buffer.h"
+
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+SourceBuffer::~SourceBuffer()
+{
+    Close();
+}
+
+bool SourceBuffer::Open(const std::string &fileName)
+{
+    Close();
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                data = (const char *)p;
+                size = (size_t)st.st_size;
+                mapped = true;
+                close(fd);
+                return true;
+            }
+        }
+        close(fd);
+    }
+    // mmap is not available for this file (empty file, pipe, etc.), fall back to a single read
+    std::ifstream in(fileName, std::ifstream::in | std::ifstream::binary);
+    if (!in)
+        return false;
+    storage.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = storage.data();
+    size = storage.size();
+    return true;
+}
+
+void SourceBuffer::Close()
+{
+    if (mapped)
+        munmap((void *)data, size);
+    storage.clear();
+    data = nullptr;
+    size = 0;
+    mapped = false;
+}
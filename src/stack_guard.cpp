@@ -0,0 +1,79 @@
+#include "stack_guard.h"
+
+#include <exception>
+#include <pthread.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+thread_local const char *StackGuard::low = nullptr;
+thread_local size_t StackGuard::size = 0;
+
+// the stack grows down to the start of the block pthread reports
+void StackGuard::find()
+{
+    pthread_attr_t attr;
+    void *base = nullptr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0)
+    {
+        pthread_attr_getstack(&attr, &base, &size);
+        pthread_attr_destroy(&attr);
+    }
+    low = (const char *)base;
+}
+
+struct StackTask
+{
+    const std::function<void()> *f;
+    std::exception_ptr error;
+};
+
+static void *runTask(void *arg)
+{
+    auto task = (StackTask *)arg;
+    try
+    {
+        (*task->f)();
+    }
+    catch (...)
+    {
+        task->error = std::current_exception();
+    }
+    return nullptr;
+}
+
+void RunWithStack(size_t bytes, const std::function<void()> &f)
+{
+    RunOnThreads(bytes, 1, [&f](unsigned) { f(); });
+}
+
+void RunOnThreads(size_t bytes, unsigned threads, const std::function<void(unsigned)> &f)
+{
+    std::vector<std::function<void()>> bodies;
+    std::vector<StackTask> tasks(threads);
+    std::vector<pthread_t> started;
+    bodies.reserve(threads);
+    for (unsigned i = 0; i < threads; i++)
+    {
+        bodies.emplace_back([&f, i]() { f(i); });
+        tasks[i].f = &bodies[i];
+    }
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, bytes);
+    for (auto &task: tasks)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, &attr, runTask, &task))
+            break;
+        started.push_back(thread);
+    }
+    pthread_attr_destroy(&attr);
+    for (auto thread: started)
+        pthread_join(thread, nullptr);
+    if (started.size() < threads)
+        throw std::runtime_error("could not start a thread with a stack of " + std::to_string(bytes) + " bytes");
+    for (auto &task: tasks)
+        if (task.error)
+            std::rethrow_exception(task.error);
+}
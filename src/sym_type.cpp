@@ -1,6 +1,8 @@
 #include <utility>
+#include <algorithm>
 
 #include "symbols/sym_type.h"
+#include "symbols/type_context.h"
 #include "symbol_table.h"
 #include "../includes/symbols/sym_variable.h"
 
@@ -19,6 +21,16 @@ bool SymType::IsQualified() const
     return isQualified;
 }
 
+bool SymType::IsCanonical() const
+{
+    return canonical;
+}
+
+int32_t SymType::StackSize()
+{
+    return (Size() + 3) & ~3;
+}
+
 BuiltInTypeKind SymBuiltInType::GetBuiltInTypeKind() const
 {
     return builtInTypeKind;
@@ -44,12 +56,7 @@ void SymBuiltInType::Print(std::ostream &os, std::string indent, bool isTail)
 bool SymBuiltInType::Equal(SymType *other)
 {
     if (other->IsQualified()) other = ((SymQualifiedType *)other)->GetType();
-    return kind == other->GetTypeKind() && builtInTypeKind == ((SymBuiltInType *) other)->GetBuiltInTypeKind();
-}
-
-SymBuiltInType::SymBuiltInType(BuiltInTypeKind builtInTypeKind, uint32_t typeQualifiers): SymBuiltInType(builtInTypeKind)
-{
-
+    return other == this;
 }
 
 bool SymBuiltInType::IsComplete()
@@ -66,15 +73,28 @@ int32_t SymBuiltInType::Size()
 {
     switch (builtInTypeKind)
     {
+        case BuiltInTypeKind::INT8: case BuiltInTypeKind::UINT8:
+            return 1;
+        case BuiltInTypeKind::INT16: case BuiltInTypeKind::UINT16:
+            return 2;
         case BuiltInTypeKind::INT32: case BuiltInTypeKind::FLOAT:
         case BuiltInTypeKind::UINT32:
             return 4;
         case BuiltInTypeKind::DOUBLE: case BuiltInTypeKind::INT64:
         case BuiltInTypeKind::UINT64:
             return 8;
+        default:
+            return 0;
     }
 }
 
+int32_t SymBuiltInType::Align()
+{
+    // 8 byte types are aligned to 4 on i386
+    auto size = Size();
+    return size > 4 ? 4 : size ? size : 1;
+}
+
 SymPointer::SymPointer(SymType *target) : SymType(), target(target)
 {
     kind = TypeKind::POINTER;
@@ -104,6 +124,8 @@ void SymPointer::SetTarget(SymType *target)
 bool SymPointer::Equal(SymType *other)
 {
     other = other->GetUnqualified();
+    if (other == this)
+        return true;
     if (kind == other->GetTypeKind())
     {
         auto pother = reinterpret_cast<SymPointer *>(other);
@@ -111,7 +133,7 @@ bool SymPointer::Equal(SymType *other)
         {
             auto starget = reinterpret_cast<SymRecord *>(target->GetUnqualified());
             auto sothertarget = reinterpret_cast<SymRecord *>(pother->GetTarget()->GetUnqualified());
-            if (starget->GetName() == sothertarget->GetName())
+            if (starget->GetNameId() == sothertarget->GetNameId())
                 return true;
         }
         else
@@ -135,10 +157,16 @@ int32_t SymPointer::Size()
     return 4;
 }
 
+int32_t SymPointer::Align()
+{
+    return 4;
+}
+
 SymArray::SymArray(SymType *valueType, ExprNode *size): SymType(), valueType(valueType), size(size)
 {
     kind = TypeKind::ARRAY;
     symbolClass = SymbolClass::TYPE;
+    if (size) count = reinterpret_cast<IntConstNode *>(size)->GetValue();
 }
 
 void SymArray::Print(std::ostream &os, std::string indent, bool isTail)
@@ -168,12 +196,12 @@ bool SymArray::Equal(SymType *other)
 
 SymPointer *SymArray::ToPointer()
 {
-    return new SymPointer(valueType);
+    return Types.Pointer(valueType);
 }
 
 bool SymArray::IsComplete()
 {
-    return valueType->IsComplete();
+    return size && valueType->IsComplete();
 }
 
 SymType *SymArray::GetUnqualified()
@@ -181,18 +209,22 @@ SymType *SymArray::GetUnqualified()
     return this;
 }
 
+// the elements are packed, the size of the value type is a multiple of its alignment already
 int32_t SymArray::Size()
 {
-    auto realSize = reinterpret_cast<IntConstNode *>(size)->GetValue();
-    auto vsize = valueType->Size();
-    vsize = vsize < 4 ? 4 : vsize;
-    if (realSize < 0) throw "";
-    return vsize * realSize;
+    if (!size) return 0;
+    if (count < 0) throw "";
+    return valueType->Size() * count;
+}
+
+int32_t SymArray::Align()
+{
+    return valueType->Align();
 }
 
 int32_t SymArray::NumberOfElements()
 {
-    return reinterpret_cast<IntConstNode *>(size)->GetValue();
+    return count;
 }
 
 SymFunction::SymFunction(SymType *returnType): SymType(), returnType(returnType)
@@ -209,9 +241,9 @@ void SymFunction::Print(std::ostream &os, std::string indent, bool isTail)
     (returnType)->Print(os, indent, orderedParams.empty());
     os << indent << ("└── ") << "Params" << std::endl;
     for (int32_t i = 0; i < (int32_t)orderedParams.size() - 1; ++i)
-        params->Find(orderedParams[i]->GetName())->Print(os, indent + "    ", false);
+        params->Find(orderedParams[i]->GetNameId())->Print(os, indent + "    ", false);
     if (!orderedParams.empty())
-        params->Find(orderedParams.back()->GetName())->Print(os, indent + "    ", true);
+        params->Find(orderedParams.back()->GetNameId())->Print(os, indent + "    ", true);
 }
 
 SymType *SymFunction::GetReturnType() const
@@ -248,8 +280,8 @@ bool SymFunction::Equal(SymType *other)
         for (int i = 0;i < orderedParams.size(); ++i)
         {
             // TODO bad comparison.
-            auto selfparam = (SymVariable *)params->Find(orderedParams[i]->GetName()),
-                    otherparam = (SymVariable *)f->params->Find(f->orderedParams[i]->GetName());
+            auto selfparam = (SymVariable *)params->Find(orderedParams[i]->GetNameId()),
+                    otherparam = (SymVariable *)f->params->Find(f->orderedParams[i]->GetNameId());
             if (!selfparam->GetType()->Equal(otherparam->GetType())) return false;
         }
         return true;
@@ -287,12 +319,15 @@ void SymFunction::SetParamsTable(SymbolTable *params)
 void SymFunction::SetOrderedParams(std::vector<SymVariable *> &orderedParams)
 {
     this->orderedParams = orderedParams;
+    // the arguments start above the return address and the saved frame pointer, the caller reserves
+    // the slot for a returned structure before it pushes them
+    argumentsStorageSize = 0;
     for (auto &orderedParam : this->orderedParams)
     {
-        argumentsStorageSize += orderedParam->GetType()->Size() < 4 ? 4 : orderedParam->GetType()->Size();
-        orderedParam->SetOffset(argumentsStorageSize + 4);
-        returnObjectOffset = argumentsStorageSize + 8;
+        orderedParam->SetOffset(argumentsStorageSize + 8);
+        argumentsStorageSize += orderedParam->GetType()->StackSize();
     }
+    returnObjectOffset = argumentsStorageSize + 8;
 }
 
 void SymFunction::SetLabel(Asm::AsmFunction *label)
@@ -315,9 +350,15 @@ int32_t SymFunction::Size()
     return 0;
 }
 
+int32_t SymFunction::Align()
+{
+    return 1;
+}
+
+// every variable starts at a multiple of 4 below the frame pointer
 int32_t SymFunction::AllocateVariable(int32_t varSize)
 {
-    varSize = varSize < 4 ? 4 : varSize;
+    varSize = varSize < 4 ? 4 : (varSize + 3) & ~3;
     return -(localVariablesStorageSize += varSize);
 }
 
@@ -331,6 +372,11 @@ int32_t SymFunction::GetArgumentsStorageSize() const
     return argumentsStorageSize;
 }
 
+int32_t SymFunction::GetReturnObjectOffset() const
+{
+    return returnObjectOffset;
+}
+
 Asm::AsmLabel *SymFunction::GetReturnLabel() const
 {
     return returnLabel;
@@ -341,9 +387,9 @@ void SymFunction::SetReturnLabel(Asm::AsmLabel *label)
     returnLabel = label;
 }
 
-SymAlias::SymAlias(std::string name, SymType *type): type(type)
+SymAlias::SymAlias(NameId name, SymType *type): type(type)
 {
-    this->name = std::move(name);
+    this->name = name;
     this->symbolClass = SymbolClass::TYPE;
     this->kind = TypeKind::TYPEDEF;
 }
@@ -356,7 +402,7 @@ SymType *SymAlias::GetType()
 void SymAlias::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << name << std::endl;
+    os << GetName() << std::endl;
     indent.append(isTail ? "    " : "│   ");
     type->Print(os, indent, true);
 }
@@ -381,6 +427,11 @@ int32_t SymAlias::Size()
     return type->Size();
 }
 
+int32_t SymAlias::Align()
+{
+    return type->Align();
+}
+
 void SymRecord::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
@@ -404,7 +455,7 @@ bool SymRecord::Equal(SymType *other)
         {
             auto s1 = orderedFields[i];
             SymVariable *s2 = r->GetOrderedFields()[i];
-            if (s1->GetName() != s2->GetName()) return false;
+            if (s1->GetNameId() != s2->GetNameId()) return false;
             if (!s1->GetType()->Equal(s2->GetType())) return false;
         }
         return true;
@@ -452,14 +503,26 @@ SymRecord::SymRecord(SymbolTable *fields, std::vector<SymVariable *> orderedFiel
 
 SymRecord::SymRecord(IdNode *tag): tag(tag)
 {
-    name = "struct " + tag->GetName();
+    SetName("struct " + tag->GetName());
     symbolClass = SymbolClass::TYPE;
     kind = TypeKind::STRUCT;
 }
 
+thread_local uint32_t SymRecord::visibleCompletions = SymbolTable::AllVisible;
+
 bool SymRecord::IsComplete()
 {
-    return fields;
+    return fields && completionOrder < visibleCompletions;
+}
+
+void SymRecord::SetCompletionOrder(uint32_t order)
+{
+    completionOrder = order;
+}
+
+void SymRecord::SetVisibleCompletions(uint32_t count)
+{
+    visibleCompletions = count;
 }
 
 SymType *SymRecord::GetUnqualified()
@@ -469,20 +532,50 @@ SymType *SymRecord::GetUnqualified()
 
 int32_t SymRecord::Size()
 {
-    int32_t size = 0;
-    for (auto f: orderedFields)
-        size += f->GetType()->Size();
     return size;
 }
 
+int32_t SymRecord::Align()
+{
+    return align;
+}
+
+// Every field goes at the next multiple of its alignment in the order of declaration, the structure is as
+// aligned as its most aligned field and its size is padded up to a multiple of that
 void SymRecord::calculateFieldsOffset()
 {
-    auto offset = 0;
-    for (auto it = orderedFields.rbegin(); it != orderedFields.rend(); it++)
+    int32_t offset = 0;
+    align = 1;
+    for (auto field: orderedFields)
+    {
+        auto fieldAlign = field->GetType()->Align();
+        offset = (offset + fieldAlign - 1) / fieldAlign * fieldAlign;
+        field->SetOffset(offset);
+        offset += field->GetType()->Size();
+        align = std::max(align, fieldAlign);
+    }
+    size = (offset + align - 1) / align * align;
+}
+
+void SymRecord::PrintLayout(std::ostream &os)
+{
+    os << (tag ? "struct " + tag->GetName() : std::string("struct <anonymous>")) << ": size " << size
+       << ", align " << align << std::endl;
+    int32_t end = 0;
+    auto padding = [&os, &end](int32_t upTo)
     {
-        (*it)->SetOffset(offset);
-        offset += (*it)->GetType()->Size();
+        if (upTo > end)
+            os << "    " << end << "\t<padding>\tsize " << upTo - end << std::endl;
+    };
+    for (auto field: orderedFields)
+    {
+        auto type = field->GetType();
+        padding(field->GetOffset());
+        os << "    " << field->GetOffset() << "\t" << field->GetName() << "\tsize " << type->Size() << ", align "
+           << type->Align() << std::endl;
+        end = field->GetOffset() + type->Size();
     }
+    padding(size);
 }
 
 void SymRecord::SetFieldsTable(SymbolTable *table)
@@ -550,9 +643,14 @@ int32_t SymQualifiedType::Size()
     return type->Size();
 }
 
-SymEnumerator::SymEnumerator(std::string name, ExprNode *value): value(value)
+int32_t SymQualifiedType::Align()
+{
+    return type->Align();
+}
+
+SymEnumerator::SymEnumerator(NameId name, ExprNode *value): value(value)
 {
-    this->name = std::move(name);
+    this->name = name;
     kind = TypeKind::ENUMERATOR;
     symbolClass = SymbolClass::TYPE;
 }
@@ -595,6 +693,11 @@ int32_t SymEnumerator::Size()
     return 0;
 }
 
+int32_t SymEnumerator::Align()
+{
+    return 1;
+}
+
 bool SymEnum::Defined() const
 {
     return defined;
@@ -605,7 +708,11 @@ void SymEnum::Define()
     defined = true;
 }
 
-SymEnum::SymEnum(IdNode *tag): tag(tag) {}
+SymEnum::SymEnum(IdNode *tag): tag(tag)
+{
+    kind = TypeKind::ENUM;
+    symbolClass = SymbolClass::TYPE;
+}
 
 void SymEnum::Print(std::ostream &os, std::string indent, bool isTail)
 {
@@ -629,5 +736,10 @@ SymType *SymEnum::GetUnqualified()
 
 int32_t SymEnum::Size()
 {
-    return 32;
+    return 4;
+}
+
+int32_t SymEnum::Align()
+{
+    return 4;
 }
@@ -1,9 +1,9 @@
 #include "../includes/symbols/sym_variable.h"
 #include "../includes/symbols/sym_type.h"
 
-SymVariable::SymVariable(std::string name, SymType *type, IdNode *id): type(type), id(id)
+SymVariable::SymVariable(NameId name, SymType *type, IdNode *id): type(type), id(id)
 {
-    this->name = std::move(name);
+    this->name = name;
     symbolClass = SymbolClass::VARIABLE;
 }
 
@@ -20,7 +20,7 @@ SymType *SymVariable::GetType() const
 void SymVariable::Print(std::ostream &os, std::string indent, bool isTail)
 {
     os << indent << (isTail ? "└── " : "├── ");
-    os << name << std::endl;
+    os << GetName() << std::endl;
     indent.append(isTail ? "    " : "│   ");
     type->Print(os, indent, true);
 }
@@ -2,14 +2,24 @@
 
 #include "../includes/symbols/symbol.h"
 
-std::string Symbol::GetName() const
+const std::string &Symbol::GetName() const
+{
+    return Identifiers.Spelling(name);
+}
+
+NameId Symbol::GetNameId() const
 {
     return name;
 }
 
-void Symbol::SetName(std::string name)
+void Symbol::SetName(NameId name)
+{
+    this->name = name;
+}
+
+void Symbol::SetName(const std::string &name)
 {
-    this->name = std::move(name);
+    this->name = Identifiers.Intern(name);
 }
 
 SymbolClass Symbol::GetSymbolClass() const
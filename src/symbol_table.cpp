@@ -1,28 +1,16 @@
 #include "../includes/symbol_table.h"
-#include "../includes/scope_tree.h"
 
-Symbol *SymbolTable::Find(std::string name) const
+Symbol *SymbolTable::Find(NameId name, SymbolNamespace ns, uint32_t visible) const
 {
-    auto it = table.find(name);
-    return  it != table.end() ? (*it).second : nullptr;
+    auto it = table.find(key(name, ns));
+    return  it != table.end() && it->second.order < visible ? it->second.symbol : nullptr;
 }
 
-void SymbolTable::Insert(std::string name, Symbol *symbol)
+void SymbolTable::Insert(NameId name, Symbol *symbol, SymbolNamespace ns)
 {
-    table[name] = symbol;
-}
-
-SymbolTable *SymbolTable::GetParent() const
-{
-    return parent;
-}
-
-void SymbolTable::AddChild(SymbolTable *child)
-{
-    children.push_back(child);
-}
-
-void SymbolTable::SetParent(SymbolTable *parent)
-{
-    this->parent = parent;
+    auto result = table.emplace(key(name, ns), Entry{symbol, declared});
+    if (result.second)
+        declared++;
+    else
+        result.first->second.symbol = symbol;
 }
@@ -4,4 +4,136 @@
 
 #include "token.h"
 
+#include <stdexcept>
 
+thread_local TokenArena *TokenArena::active = nullptr;
+thread_local int TokenArena::threadShard = -1;
+
+void TokenArena::Reset(const char *source)
+{
+    this->source = source;
+    types.clear();
+    positions.clear();
+    offsets.clear();
+    lengths.clear();
+    values.clear();
+    ownedTexts.clear();
+    shards.clear();
+    borrowed.reset();
+    madeShard = -1;
+    view();
+}
+
+void TokenArena::Reserve(size_t count)
+{
+    own();
+    types.reserve(count);
+    positions.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    values.reserve(count);
+    view();
+}
+
+uint32_t TokenArena::Add(TokenType type, Position position, uint32_t offset, uint32_t length)
+{
+    own();
+    types.push_back(type);
+    positions.push_back(position);
+    offsets.push_back(offset);
+    lengths.push_back(length);
+    values.emplace_back();
+    view();
+    return Size() - 1;
+}
+
+uint32_t TokenArena::Add(TokenType type, Position position, std::string text)
+{
+    auto length = (uint32_t)text.length();
+    ownedTexts.push_back(std::move(text));
+    return Add(type, position, (uint32_t)(ownedTexts.size() - 1) | OwnedText, length);
+}
+
+uint32_t TokenArena::Make(TokenType type, Position position, std::string text)
+{
+    auto shard = threadShard < 0 ? madeShard : threadShard;
+    if (shard < 0)
+        return Add(type, position, std::move(text));
+    auto i = shards[shard]->Add(type, position, std::move(text));
+    if (i > ShardIndex)
+        throw std::length_error("too many tokens made up by one thread");
+    return InShard | (uint32_t)shard << ShardShift | i;
+}
+
+unsigned TokenArena::AddShards(unsigned count)
+{
+    auto first = (unsigned)shards.size();
+    if (first + count > MaxShards)
+        throw std::length_error("too many token shards");
+    for (unsigned i = 0; i < count; i++)
+        shards.emplace_back(new TokenArena());
+    return first;
+}
+
+void TokenArena::Append(const TokenArena &other, uint32_t first, uint32_t count, int rowShift, int64_t offsetShift)
+{
+    own();
+    auto base = Size();
+    types.insert(types.end(), other.typeView + first, other.typeView + first + count);
+    positions.insert(positions.end(), other.positions.begin() + first, other.positions.begin() + first + count);
+    offsets.insert(offsets.end(), other.offsetView + first, other.offsetView + first + count);
+    lengths.insert(lengths.end(), other.lengths.begin() + first, other.lengths.begin() + first + count);
+    values.insert(values.end(), other.values.begin() + first, other.values.begin() + first + count);
+    view();
+    for (uint32_t i = base; i < Size(); i++)
+    {
+        positions[i].row += rowShift;
+        if (offsets[i] & OwnedText)
+        {
+            ownedTexts.emplace_back(other.Text(first + i - base));
+            offsets[i] = (uint32_t)(ownedTexts.size() - 1) | OwnedText;
+        }
+        else
+            offsets[i] += offsetShift;
+    }
+}
+
+void TokenArena::Truncate(uint32_t count)
+{
+    own();
+    // owned texts are added in token order, so the first dropped one is where they are cut
+    for (uint32_t i = count; i < Size(); i++)
+        if (offsets[i] & OwnedText)
+        {
+            ownedTexts.resize(offsets[i] & ~OwnedText);
+            break;
+        }
+    types.resize(count);
+    positions.resize(count);
+    offsets.resize(count);
+    lengths.resize(count);
+    values.resize(count);
+    view();
+}
+
+void TokenArena::borrow(std::unique_ptr<SourceBuffer> entry, const TokenType *types, const uint32_t *offsets)
+{
+    borrowed = std::move(entry);
+    typeView = types;
+    offsetView = offsets;
+    madeShard = (int)AddShards(1);
+}
+
+void TokenArena::copyBorrowed()
+{
+    types.assign(typeView, typeView + Size());
+    offsets.assign(offsetView, offsetView + Size());
+    borrowed.reset();
+    view();
+}
+
+void TokenArena::view()
+{
+    typeView = types.data();
+    offsetView = offsets.data();
+}
@@ -0,0 +1,463 @@
+#include "token_cache.h"
+#include "source_buffer.h"
+#include "dfa.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+struct EntryHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    uint64_t sourceHash[2];
+    uint64_t lexerVersion;
+    uint32_t tokenCount;
+    uint32_t identifierCount;
+    // the number of ID, keyword, integer (and character) and float tokens, whose values are in the side tables
+    uint32_t nameCount;
+    uint32_t keywordCount;
+    uint32_t integerCount;
+    uint32_t floatCount;
+    // tokens of LongLength bytes or more, and tokens whose position does not follow from their offset
+    uint32_t longCount;
+    uint32_t placedCount;
+    // catches entries written by a build with another long double
+    uint32_t floatSize;
+    uint32_t reserved;
+};
+
+// the offsets that follow are served from the mapping, which starts on a page
+static_assert(sizeof(EntryHeader) % alignof(uint32_t) == 0, "the offsets of an entry are not aligned");
+
+// where an identifier first occurs in the source
+struct EntryIdentifier
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+// the position of a token where the lexer did not count it from the offset, as at the end of the source
+struct EntryPosition
+{
+    uint32_t token;
+    Position position;
+};
+
+static const char EntryMagic[4] = {'T', 'C', 'C', 'K'};
+// lengths are a byte per token, this one says the length is in the side table
+static const uint8_t LongLength = UINT8_MAX;
+
+// element i of a side table, which is not aligned
+template <typename T>
+static T sideEntry(const char *table, uint32_t i)
+{
+    T entry;
+    memcpy(&entry, table + (size_t)i * sizeof(T), sizeof(T));
+    return entry;
+}
+
+// Rows and columns the way the lexer counts them, bytes from the start of the line, for offsets that do not
+// go back
+class PositionWalk
+{
+public:
+    explicit PositionWalk(std::string_view source): source(source) {}
+    Position At(uint32_t offset)
+    {
+        const char *lineFeed;
+        while (scanned < offset &&
+               (lineFeed = (const char *)memchr(source.data() + scanned, '\n', offset - scanned)))
+        {
+            row++;
+            scanned = lineStart = (uint32_t)(lineFeed - source.data()) + 1;
+        }
+        scanned = std::max(scanned, offset);
+        return Position(row, (int)(offset - lineStart) + 1);
+    }
+private:
+    std::string_view source;
+    uint32_t scanned = 0, lineStart = 0;
+    int row = 1;
+};
+
+struct ContentHash
+{
+    uint64_t low, high;
+};
+
+static uint64_t rotateLeft(uint64_t x, int bits)
+{
+    return x << bits | x >> (64 - bits);
+}
+
+static uint64_t finalMix(uint64_t h)
+{
+    h = (h ^ h >> 33) * 0xFF51AFD7ED558CCDull;
+    h = (h ^ h >> 33) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ h >> 33;
+}
+
+// MurmurHash3, the 128 bit variant for 64 bit machines. An entry stands for the source whose length and hash it
+// has, two sources that differ are that unlikely to agree on both that the bytes are not kept to compare
+static ContentHash hashContents(std::string_view s)
+{
+    const uint64_t c1 = 0x87C37B91114253D5ull, c2 = 0x4CF5AD432745937Full;
+    uint64_t h1 = 0, h2 = 0, k1, k2;
+    size_t i = 0;
+    for (; i + 16 <= s.size(); i += 16)
+    {
+        memcpy(&k1, s.data() + i, 8);
+        memcpy(&k2, s.data() + i + 8, 8);
+        h1 ^= rotateLeft(k1 * c1, 31) * c2;
+        h1 = (rotateLeft(h1, 27) + h2) * 5 + 0x52DCE729;
+        h2 ^= rotateLeft(k2 * c2, 33) * c1;
+        h2 = (rotateLeft(h2, 31) + h1) * 5 + 0x38495AB5;
+    }
+    auto tail = s.size() - i;
+    if (tail > 8)
+    {
+        k2 = 0;
+        memcpy(&k2, s.data() + i + 8, tail - 8);
+        h2 ^= rotateLeft(k2 * c2, 33) * c1;
+    }
+    if (tail)
+    {
+        k1 = 0;
+        memcpy(&k1, s.data() + i, std::min<size_t>(tail, 8));
+        h1 ^= rotateLeft(k1 * c1, 31) * c2;
+    }
+    h1 ^= s.size();
+    h2 ^= s.size();
+    h1 += h2;
+    h2 += h1;
+    h1 = finalMix(h1);
+    h2 = finalMix(h2);
+    h1 += h2;
+    h2 += h1;
+    return {h1, h2};
+}
+
+// Changes whenever the automaton, the keywords or the token kinds do, a build that lexes otherwise
+// neither finds nor accepts the entries of this one
+static uint64_t lexerVersion()
+{
+    static const uint64_t version = []
+    {
+        std::string tables((const char *)CharClass, sizeof(CharClass));
+        tables.append((const char *)Transitions, sizeof(Transitions));
+        std::vector<std::pair<int32_t, int32_t>> accepting;
+        for (auto &state: AcceptStates)
+            accepting.emplace_back(state.first, (int32_t)state.second);
+        std::sort(accepting.begin(), accepting.end());
+        tables.append((const char *)accepting.data(), accepting.size() * sizeof(accepting[0]));
+        for (auto &entry: KeywordList)
+        {
+            tables.append(entry.text);
+            tables.push_back((char)entry.keyword);
+        }
+        uint32_t counts[] = {(uint32_t)TokenType::END_OF_FILE + 1, (uint32_t)Keyword::PRINTF + 1};
+        tables.append((const char *)counts, sizeof(counts));
+        return hashContents(tables).low;
+    }();
+    return version;
+}
+
+TokenCache::TokenCache(std::string directory, uint64_t maxBytes): directory(std::move(directory)), maxBytes(maxBytes)
+{
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+}
+
+std::string TokenCache::entryPath(uint64_t hash) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.tok", (unsigned long long)hash);
+    return (fs::path(directory) / name).string();
+}
+
+bool TokenCache::Load(std::string_view source, TokenArena &tokens)
+{
+    auto hash = hashContents(source);
+    auto path = entryPath(hash.low ^ lexerVersion());
+    std::unique_ptr<SourceBuffer> entry(new SourceBuffer());
+    if (!entry->Open(path) || entry->Size() < sizeof(EntryHeader))
+    {
+        stats.misses++;
+        return false;
+    }
+    EntryHeader header;
+    memcpy(&header, entry->Begin(), sizeof(header));
+    uint32_t count = header.tokenCount;
+    uint64_t tokenSize = sizeof(uint32_t) + sizeof(TokenType) + sizeof(uint8_t);
+    bool valid = !memcmp(header.magic, EntryMagic, 4) && header.version == Version &&
+                 header.sourceSize == source.size() && header.sourceHash[0] == hash.low &&
+                 header.sourceHash[1] == hash.high && header.lexerVersion == lexerVersion() &&
+                 header.floatSize == sizeof(long double) && count &&
+                 entry->Size() == sizeof(header) + count * tokenSize +
+                                  (uint64_t)header.identifierCount * sizeof(EntryIdentifier) +
+                                  (uint64_t)header.nameCount * sizeof(uint32_t) + header.keywordCount +
+                                  (uint64_t)header.integerCount * sizeof(int64_t) +
+                                  (uint64_t)header.floatCount * sizeof(long double) +
+                                  (uint64_t)header.longCount * sizeof(uint32_t) +
+                                  (uint64_t)header.placedCount * sizeof(EntryPosition);
+    if (!valid)
+        return reject(path, tokens, source);
+    const char *p = entry->Begin() + sizeof(header);
+    auto take = [&p](uint64_t size)
+    {
+        auto array = p;
+        p += size;
+        return array;
+    };
+    auto offsets = (const uint32_t *)take(count * sizeof(uint32_t));
+    auto types = (const TokenType *)take(count * sizeof(TokenType));
+    auto lengths = (const uint8_t *)take(count);
+    const char *identifiers = take(header.identifierCount * sizeof(EntryIdentifier));
+    const char *names = take(header.nameCount * sizeof(uint32_t));
+    const char *integers = take(header.integerCount * sizeof(int64_t));
+    const char *floats = take(header.floatCount * sizeof(long double));
+    const char *longLengths = take(header.longCount * sizeof(uint32_t));
+    const char *placed = take(header.placedCount * sizeof(EntryPosition));
+    auto keywords = (const uint8_t *)take(header.keywordCount);
+
+    for (uint32_t i = 0; valid && i < header.identifierCount; i++)
+    {
+        auto identifier = sideEntry<EntryIdentifier>(identifiers, i);
+        valid = (uint64_t)identifier.offset + identifier.length <= source.size();
+    }
+    std::vector<Position> positions(valid ? count : 0);
+    std::vector<uint32_t> tokenLengths(valid ? count : 0);
+    std::vector<TokenValue> values(valid ? count : 0);
+    PositionWalk walk(source);
+    uint32_t name = 0, keyword = 0, integer = 0, floating = 0, longLength = 0, place = 0;
+    for (uint32_t i = 0; valid && i < count; i++)
+    {
+        auto &value = values[i];
+        auto &length = tokenLengths[i];
+        length = lengths[i];
+        if (length == LongLength)
+            length = longLength < header.longCount ? sideEntry<uint32_t>(longLengths, longLength++) : UINT32_MAX;
+        // made up tokens have their own text, an entry has none of them
+        valid = types[i] <= TokenType::END_OF_FILE && (!i || offsets[i] >= offsets[i - 1]) &&
+                (uint64_t)offsets[i] + length <= source.size();
+        if (!valid)
+            break;
+        positions[i] = walk.At(offsets[i]);
+        if (place < header.placedCount && sideEntry<EntryPosition>(placed, place).token == i)
+            positions[i] = sideEntry<EntryPosition>(placed, place++).position;
+        switch (types[i])
+        {
+            case TokenType::ID:
+                // the index of the identifier in the entry until they are interned
+                value.nameId = name < header.nameCount ? sideEntry<uint32_t>(names, name++) : UINT32_MAX;
+                valid = value.nameId < header.identifierCount;
+                break;
+            case TokenType::KEYWORD:
+                valid = keyword < header.keywordCount && keywords[keyword] <= (uint8_t)Keyword::PRINTF;
+                if (valid)
+                    value.keyword = (Keyword)keywords[keyword++];
+                break;
+            case TokenType::NUM_INT:case TokenType::CHARACTER:
+                valid = integer < header.integerCount;
+                if (valid)
+                    value.intValue = sideEntry<int64_t>(integers, integer++);
+                break;
+            case TokenType::NUM_FLOAT:
+                valid = floating < header.floatCount;
+                if (valid)
+                    value.floatValue = sideEntry<long double>(floats, floating++);
+                break;
+            default:
+                break;
+        }
+    }
+    valid = valid && name == header.nameCount && keyword == header.keywordCount &&
+            integer == header.integerCount && floating == header.floatCount && longLength == header.longCount &&
+            place == header.placedCount && types[count - 1] == TokenType::END_OF_FILE;
+    if (!valid)
+        return reject(path, tokens, source);
+    // interned in order of first occurrence, which gives them the ids lexing would
+    std::vector<NameId> ids;
+    ids.reserve(header.identifierCount);
+    for (uint32_t i = 0; i < header.identifierCount; i++)
+    {
+        auto identifier = sideEntry<EntryIdentifier>(identifiers, i);
+        ids.push_back(Identifiers.Intern(source.substr(identifier.offset, identifier.length)));
+    }
+    for (uint32_t i = 0; i < count; i++)
+        if (types[i] == TokenType::ID)
+            values[i].nameId = ids[values[i].nameId];
+    tokens.Reset(source.data());
+    tokens.positions = std::move(positions);
+    tokens.lengths = std::move(tokenLengths);
+    tokens.values = std::move(values);
+    tokens.borrow(std::move(entry), types, offsets);
+    stats.hits++;
+    // the modification time orders entries for eviction
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool TokenCache::reject(const std::string &path, TokenArena &tokens, std::string_view source)
+{
+    tokens.Reset(source.data());
+    stats.misses++;
+    stats.rejected++;
+    std::error_code ec;
+    fs::remove(path, ec);
+    return false;
+}
+
+void TokenCache::Store(std::string_view source, const TokenArena &tokens)
+{
+    uint32_t count = tokens.Size();
+    if (!count || tokens.Type(count - 1) != TokenType::END_OF_FILE)
+        return;
+    EntryHeader header{};
+    std::vector<EntryIdentifier> identifiers;
+    std::vector<uint32_t> local(Identifiers.Size(), UINT32_MAX);
+    std::vector<uint32_t> offsets(tokens.offsetView, tokens.offsetView + count);
+    std::vector<uint8_t> lengths(count);
+    std::vector<uint32_t> names, longLengths;
+    std::vector<uint8_t> keywords;
+    std::vector<int64_t> integers;
+    std::vector<long double> floats;
+    std::vector<EntryPosition> placed;
+    PositionWalk walk(source);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // only made up tokens have text of their own, and there is none of them right after lexing but
+        // END_OF_FILE, whose empty text is stored as the end of the source
+        if (offsets[i] & TokenArena::OwnedText)
+        {
+            if (!tokens.Text(i).empty())
+                return;
+            offsets[i] = (uint32_t)source.size();
+        }
+        if (i && offsets[i] < offsets[i - 1])
+            return;
+        auto length = tokens.lengths[i];
+        lengths[i] = (uint8_t)std::min<uint32_t>(length, LongLength);
+        if (length >= LongLength)
+            longLengths.push_back(length);
+        auto position = tokens.positions[i], counted = walk.At(offsets[i]);
+        if (position.row != counted.row || position.col != counted.col)
+            placed.push_back({i, position});
+        auto &value = tokens.values[i];
+        switch (tokens.typeView[i])
+        {
+            case TokenType::ID:
+            {
+                auto &id = local[value.nameId];
+                if (id == UINT32_MAX)
+                {
+                    id = (uint32_t)identifiers.size();
+                    identifiers.push_back({offsets[i], length});
+                }
+                names.push_back(id);
+                break;
+            }
+            case TokenType::KEYWORD:
+                keywords.push_back((uint8_t)value.keyword);
+                break;
+            case TokenType::NUM_INT:case TokenType::CHARACTER:
+                integers.push_back(value.intValue);
+                break;
+            case TokenType::NUM_FLOAT:
+                floats.push_back(value.floatValue);
+                break;
+            default:
+                break;
+        }
+    }
+    auto hash = hashContents(source);
+    memcpy(header.magic, EntryMagic, 4);
+    header.version = Version;
+    header.sourceSize = source.size();
+    header.sourceHash[0] = hash.low;
+    header.sourceHash[1] = hash.high;
+    header.lexerVersion = lexerVersion();
+    header.tokenCount = count;
+    header.identifierCount = (uint32_t)identifiers.size();
+    header.nameCount = (uint32_t)names.size();
+    header.keywordCount = (uint32_t)keywords.size();
+    header.integerCount = (uint32_t)integers.size();
+    header.floatCount = (uint32_t)floats.size();
+    header.longCount = (uint32_t)longLengths.size();
+    header.placedCount = (uint32_t)placed.size();
+    header.floatSize = sizeof(long double);
+
+    // written under a temporary name and renamed, so that concurrent builds never see half an entry
+    auto path = entryPath(hash.low ^ header.lexerVersion);
+    auto temporary = path + "." + std::to_string(getpid()) + ".tmp";
+    FILE *out = fopen(temporary.c_str(), "wb");
+    if (!out)
+        return;
+    auto write = [out](const void *data, size_t size) { return size == 0 || fwrite(data, size, 1, out) == 1; };
+    bool written = write(&header, sizeof(header)) &&
+                   write(offsets.data(), count * sizeof(uint32_t)) &&
+                   write(tokens.typeView, count * sizeof(TokenType)) &&
+                   write(lengths.data(), count) &&
+                   write(identifiers.data(), identifiers.size() * sizeof(EntryIdentifier)) &&
+                   write(names.data(), names.size() * sizeof(uint32_t)) &&
+                   write(integers.data(), integers.size() * sizeof(int64_t)) &&
+                   write(floats.data(), floats.size() * sizeof(long double)) &&
+                   write(longLengths.data(), longLengths.size() * sizeof(uint32_t)) &&
+                   write(placed.data(), placed.size() * sizeof(EntryPosition)) &&
+                   write(keywords.data(), keywords.size());
+    written = fclose(out) == 0 && written;
+    std::error_code ec;
+    if (written)
+        fs::rename(temporary, path, ec);
+    if (!written || ec)
+    {
+        fs::remove(temporary, ec);
+        return;
+    }
+    stats.stores++;
+    evict();
+}
+
+void TokenCache::evict()
+{
+    struct Entry
+    {
+        fs::path path;
+        fs::file_time_type time;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (auto &file: fs::directory_iterator(directory, ec))
+    {
+        if (file.path().extension() != ".tok")
+            continue;
+        std::error_code fileError;
+        Entry entry{file.path(), file.last_write_time(fileError), file.file_size(fileError)};
+        if (fileError)
+            continue;
+        total += entry.size;
+        entries.push_back(entry);
+    }
+    if (total <= maxBytes)
+        return;
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.time < b.time; });
+    for (auto &entry: entries)
+    {
+        if (total <= maxBytes)
+            break;
+        if (fs::remove(entry.path, ec))
+        {
+            total -= entry.size;
+            stats.evictions++;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include "token_writer.h"
+
+#include <cstring>
+#include <string>
+
+TokenWriter::TokenWriter(FILE *out, TokenDumpFormat format): out(out), format(format)
+{
+    buffer = end = new char[BufferSize];
+}
+
+TokenWriter::~TokenWriter()
+{
+    Flush();
+    delete[] buffer;
+}
+
+void TokenWriter::WriteHeader()
+{
+    reserve(MaxFixedPart);
+    if (format == TokenDumpFormat::TEXT)
+        put("Position\t\tType\t\t\tValue\t\t\tText\n\n");
+    else
+    {
+        put("TCCT");
+        putRaw<uint32_t>(BinaryVersion);
+    }
+}
+
+void TokenWriter::Write(Token token)
+{
+    if (format == TokenDumpFormat::TEXT)
+        writeText(token);
+    else
+        writeBinary(token);
+}
+
+void TokenWriter::Flush()
+{
+    if (end != buffer)
+        fwrite(buffer, 1, end - buffer, out);
+    end = buffer;
+    fflush(out);
+}
+
+void TokenWriter::writeText(Token token)
+{
+    auto pos = token.GetPosition();
+    auto text = token.GetText();
+    reserve(MaxFixedPart);
+    put('(');
+    putSigned(pos.row);
+    put(", ");
+    putSigned(pos.col);
+    put(")\t\t\t");
+    put(TokenTypeName(token.GetType()));
+    put("\t\t\t");
+    switch (token.GetType())
+    {
+        case TokenType::NUM_INT:case TokenType::CHARACTER:
+            putDecimal((uint64_t)token.GetIntValue());
+            break;
+        case TokenType::NUM_FLOAT:
+        {
+            char local[64];
+            auto length = snprintf(local, sizeof(local), "%Lf", token.GetFloatValue());
+            if (length < (int)sizeof(local))
+                put(std::string_view(local, (size_t)length));
+            else
+            {
+                std::string digits((size_t)length + 1, 0);
+                snprintf(&digits[0], digits.size(), "%Lf", token.GetFloatValue());
+                put(std::string_view(digits.data(), (size_t)length));
+            }
+            break;
+        }
+        case TokenType::KEYWORD:
+            putSigned((int)token.GetKeyword());
+            break;
+        default:
+            put(text);
+    }
+    put("\t\t\t\t  ");
+    put(text);
+    reserve(1);
+    put('\n');
+}
+
+void TokenWriter::writeBinary(Token token)
+{
+    auto pos = token.GetPosition();
+    auto text = token.GetText();
+    reserve(MaxFixedPart);
+    putRaw<uint8_t>((uint8_t)token.GetType());
+    putRaw<uint32_t>((uint32_t)pos.row);
+    putRaw<uint32_t>((uint32_t)pos.col);
+    putRaw<uint32_t>((uint32_t)text.length());
+    put(text);
+    reserve(sizeof(int64_t));
+    switch (token.GetType())
+    {
+        case TokenType::NUM_INT:case TokenType::CHARACTER:
+            putRaw<int64_t>(token.GetIntValue());
+            break;
+        case TokenType::NUM_FLOAT:
+            putRaw<double>((double)token.GetFloatValue());
+            break;
+        case TokenType::KEYWORD:
+            putRaw<uint8_t>((uint8_t)token.GetKeyword());
+            break;
+        default:
+            break;
+    }
+}
+
+void TokenWriter::reserve(size_t size)
+{
+    if ((size_t)(end - buffer) + size > BufferSize)
+    {
+        fwrite(buffer, 1, end - buffer, out);
+        end = buffer;
+    }
+}
+
+void TokenWriter::put(std::string_view s)
+{
+    reserve(s.length());
+    if (s.length() > BufferSize)
+    {
+        // a huge literal, the buffer has just been emptied
+        fwrite(s.data(), 1, s.length(), out);
+        return;
+    }
+    memcpy(end, s.data(), s.length());
+    end += s.length();
+}
+
+void TokenWriter::putDecimal(uint64_t value)
+{
+    char digits[20];
+    int n = 0;
+    do
+    {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n)
+        put(digits[--n]);
+}
+
+void TokenWriter::putSigned(int64_t value)
+{
+    if (value < 0)
+    {
+        put('-');
+        putDecimal(0 - (uint64_t)value);
+    }
+    else
+        putDecimal((uint64_t)value);
+}
+
+// the format is little endian, which is what every target of the compiler is
+template<typename T>
+void TokenWriter::putRaw(T value)
+{
+    memcpy(end, &value, sizeof(T));
+    end += sizeof(T);
+}
@@ -3,36 +3,326 @@
 //
 
     #include <tokenizer.h>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
 
-Tokenizer::Tokenizer(std::string fileName)
+Tokenizer::Tokenizer(std::string fileName, InputMode mode)
 {
-    OpenFile(fileName);
+    OpenFile(fileName, mode);
 }
 
 
-void Tokenizer::OpenFile(std::string fileName)
+void Tokenizer::OpenFile(std::string fileName, InputMode mode)
 {
-    currentFile.close();
-    currentFile.open(fileName, std::ifstream::in);
+    openSource(fileName, mode);
     Next();
 }
 
-std::vector<Token *> Tokenizer::Tokenize(std::string fileName)
+void Tokenizer::openSource(std::string fileName, InputMode mode)
+{
+    reset();
+    inputMode = mode;
+    if (inputMode == InputMode::BUFFER)
+    {
+        source.Open(fileName);
+        sourceBegin = cursor = source.Begin();
+        sourceEnd = source.End();
+        tokens.Reset(source.Begin());
+    }
+    else
+    {
+        currentFile.open(fileName, std::ifstream::in);
+        tokens.Reset();
+    }
+    tokens.Activate();
+}
+
+void Tokenizer::reset()
 {
-    buffer.reserve(256);
+    batched = false;
+    deferredError = nullptr;
+    unterminatedComment = false;
+    trackLines = false;
+    lineStates.clear();
     currentState = 0;
-    std::vector<Token *> result;
-//    OpenFile(std::move(fileName));
-//    while(Next()->type != TokenType::END_OF_FILE)
-//        result.push_back(currentToken);
-    return result;
+    currentPos = Position(1, 1);
+    currentFile.close();
+    source.Close();
+}
+
+// sources average a bit over three bytes per token, slightly overestimating saves reallocations
+constexpr uint64_t BytesPerToken = 3;
+// chunks smaller than this are not worth a thread
+constexpr size_t MinParallelChunk = 256 << 10;
 
+const TokenArena &Tokenizer::Tokenize(std::string fileName, InputMode mode, unsigned threads)
+{
+    openSource(fileName, mode);
+    std::string_view contents(source.Begin(), source.Size());
+    if (inputMode == InputMode::BUFFER && tokenCache && tokenCache->Load(contents, tokens))
+    {
+        batchSize = tokens.Size();
+        startBatch();
+        return tokens;
+    }
+    std::error_code ec;
+    auto size = std::filesystem::file_size(fileName, ec);
+    if (!ec)
+        tokens.Reserve(size / BytesPerToken + 1);
+    if (inputMode == InputMode::BUFFER && threads > 1 && source.Size() / threads < MinParallelChunk)
+        threads = (unsigned)(source.Size() / MinParallelChunk);
+    if (inputMode == InputMode::BUFFER && threads > 1)
+        tokenizeParallel(threads);
+    else
+        lexToEnd();
+    if (inputMode == InputMode::BUFFER && tokenCache && !deferredError)
+        tokenCache->Store(contents, tokens);
+    startBatch();
+    return tokens;
 }
 
-std::shared_ptr<Token> Tokenizer::Next()
+void Tokenizer::startBatch()
+{
+    // the very first token failed, lexing incrementally would have thrown right away
+    if (!batchSize)
+        std::rethrow_exception(deferredError);
+    currentToken = Token();
+    nextToken = Token(0);
+    batched = true;
+}
+
+const TokenArena &Tokenizer::TokenizeText(std::string_view text)
+{
+    reset();
+    inputMode = InputMode::BUFFER;
+    sourceText.assign(text.begin(), text.end());
+    sourceBegin = cursor = sourceText.data();
+    sourceEnd = sourceBegin + sourceText.size();
+    tokens.Reset(sourceBegin);
+    tokens.Reserve(sourceText.size() / BytesPerToken + 1);
+    tokens.Activate();
+    trackLines = true;
+    lineStates.push_back({0, 0, 0, 0});
+    lexToEnd();
+    startBatch();
+    return tokens;
+}
+
+TokenEdit Tokenizer::Relex(size_t offset, size_t removed, std::string_view inserted)
+{
+    // the line states are only recorded by TokenizeText, Tokenize and a fresh tokenizer have none
+    if (lineStates.empty())
+        throw std::logic_error("Relex needs the tokens of TokenizeText");
+    // the old text stays in editBuffer until the old tokens are compared with the new ones
+    std::swap(sourceText, editBuffer);
+    sourceText.assign(editBuffer.begin(), editBuffer.begin() + offset);
+    sourceText.insert(sourceText.end(), inserted.begin(), inserted.end());
+    sourceText.insert(sourceText.end(), editBuffer.begin() + offset + removed, editBuffer.end());
+    sourceBegin = sourceText.data();
+    sourceEnd = sourceBegin + sourceText.size();
+    tokens.SetSource(sourceBegin);
+    tokens.Activate();
+
+    // the last line starting before the edit lexes as before, from there on tokens and lines are moved aside
+    auto line = std::upper_bound(lineStates.begin(), lineStates.end(), offset,
+                                 [](size_t offset, const LineState &line) { return offset < line.offset; }) - 1;
+    auto restart = *line;
+    auto restartLine = (size_t)(line - lineStates.begin());
+    auto oldSize = batchSize;
+    bool oldComplete = !deferredError;
+    relexTokens.Reset(editBuffer.data());
+    relexTokens.Append(tokens, restart.firstToken, oldSize - restart.firstToken, 0);
+    relexLines.assign(line + 1, lineStates.end());
+    tokens.Truncate(restart.firstToken);
+    lineStates.resize(restartLine + 1);
+    deferredError = nullptr;
+    unterminatedComment = false;
+    cursor = sourceBegin + restart.offset;
+    currentPos = Position((int)restartLine + 1, 1);
+    batchSize = tokens.Size();
+
+    // i indexes the old token stream, j the new one
+    auto same = [&](uint32_t i, uint32_t j, int rowShift)
+    {
+        i -= restart.firstToken;
+        auto a = relexTokens.GetPosition(i), b = tokens.GetPosition(j);
+        return relexTokens.Type(i) == tokens.Type(j) && a.row + rowShift == b.row && a.col == b.col &&
+               relexTokens.Text(i) == tokens.Text(j);
+    };
+    TokenEdit edit{restart.firstToken, oldSize, oldSize};
+    auto shift = (int64_t)inserted.size() - (int64_t)removed;
+    auto editEnd = offset + inserted.size();
+    size_t checked = lineStates.size();
+    bool resynced = false;
+    try
+    {
+        if (restart.nesting)
+            skipMultilineComment(restart.nesting);
+        while (!batchSize || tokens.Type(batchSize - 1) != TokenType::END_OF_FILE)
+        {
+            for (; oldComplete && checked < lineStates.size(); checked++)
+            {
+                auto state = lineStates[checked];
+                if (state.offset < editEnd)
+                    continue;
+                auto match = std::lower_bound(relexLines.begin(), relexLines.end(), state.offset - shift,
+                                              [](const LineState &line, int64_t offset) { return line.offset < offset; });
+                if (match == relexLines.end() || match->offset != state.offset - shift ||
+                    match->state != state.state || match->nesting != state.nesting)
+                    continue;
+                // everything from here on lexes the same as before
+                auto rowShift = (int)checked - (int)(restartLine + 1 + (match - relexLines.begin()));
+                auto tokenShift = (int64_t)state.firstToken - match->firstToken;
+                tokens.Truncate(state.firstToken);
+                tokens.Append(relexTokens, match->firstToken - restart.firstToken, oldSize - match->firstToken,
+                              rowShift, shift);
+                lineStates.resize(checked + 1);
+                for (auto l = match + 1; l != relexLines.end(); l++)
+                    lineStates.push_back({(uint32_t)(l->offset + shift), (uint32_t)(l->firstToken + tokenShift),
+                                          l->state, l->nesting});
+                batchSize = tokens.Size();
+                edit.oldEnd = match->firstToken;
+                edit.newEnd = state.firstToken;
+                while (edit.oldEnd > edit.first && edit.newEnd > edit.first &&
+                       same(edit.oldEnd - 1, edit.newEnd - 1, rowShift))
+                    edit.oldEnd--, edit.newEnd--;
+                resynced = true;
+                break;
+            }
+            if (resynced)
+                break;
+            lex();
+            batchSize = tokens.Size();
+        }
+    }
+    catch (CompilationError &e)
+    {
+        deferredError = std::current_exception();
+    }
+    if (!resynced)
+        edit.newEnd = batchSize;
+    while (edit.first < edit.oldEnd && edit.first < edit.newEnd && same(edit.first, edit.first, 0))
+        edit.first++;
+    currentToken = Token();
+    nextToken = Token(0);
+    batched = true;
+    return edit;
+}
+
+void Tokenizer::lexToEnd()
+{
+    // a token whose value failed to decode is already in the arena, so count complete tokens only
+    batchSize = tokens.Size();
+    try
+    {
+        while (!batchSize || tokens.Type(batchSize - 1) != TokenType::END_OF_FILE)
+        {
+            lex();
+            batchSize = tokens.Size();
+        }
+    }
+    catch (CompilationError &e)
+    {
+        deferredError = std::current_exception();
+    }
+}
+
+// Lexes [begin, end) of a file mapped at fileBegin on its own, as if it started at row 1.
+// Identifiers are left for the caller to intern, the interner is not shared between threads.
+void Tokenizer::lexChunk(const char *fileBegin, const char *begin, const char *end)
+{
+    inputMode = InputMode::BUFFER;
+    internIdentifiers = false;
+    sourceBegin = fileBegin;
+    cursor = begin;
+    sourceEnd = end;
+    tokens.Reset(fileBegin);
+    tokens.Reserve((end - begin) / BytesPerToken + 1);
+    tokens.Activate();
+    lexToEnd();
+}
+
+// Every chunk but the first starts right after a line feed and is lexed assuming that line feed
+// was not inside a comment. A chunk that ends inside a comment proves the next assumption wrong, so does
+// a lexical error, whose position would be off anyway. From such a chunk on the file is lexed here.
+void Tokenizer::tokenizeParallel(unsigned threads)
+{
+    const char *begin = source.Begin(), *end = source.End();
+    std::vector<const char *> bounds{begin};
+    for (unsigned i = 1; i < threads; i++)
+    {
+        const char *split = FindLineFeed(begin + source.Size() * i / threads, end);
+        if (split == end)
+            break;
+        if (split + 1 > bounds.back())
+            bounds.push_back(split + 1);
+    }
+    bounds.push_back(end);
+    size_t n = bounds.size() - 1;
+    std::vector<Tokenizer> chunks(n);
+    std::vector<int> lines(n);
+    auto work = [&](size_t i)
+    {
+        chunks[i].lexChunk(begin, bounds[i], bounds[i + 1]);
+        lines[i] = (int)std::count(bounds[i], bounds[i + 1], '\n');
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < n; i++)
+        workers.emplace_back(work, i);
+    work(0);
+    for (auto &worker: workers)
+        worker.join();
+
+    tokens.Activate();
+    size_t total = 0;
+    for (auto &chunk: chunks)
+        total += chunk.batchSize;
+    tokens.Reserve(total);
+    int rows = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        auto &chunk = chunks[i];
+        bool last = i + 1 == n;
+        if (chunk.deferredError || (chunk.unterminatedComment && !last))
+        {
+            cursor = bounds[i];
+            currentPos = Position(rows + 1, 1);
+            lexToEnd();
+            return;
+        }
+        auto first = tokens.Size();
+        // inner chunks end with an END_OF_FILE of their own
+        tokens.Append(chunk.tokens, 0, last ? chunk.batchSize : chunk.batchSize - 1, rows);
+        for (auto j = first; j < tokens.Size(); j++)
+            if (tokens.Type(j) == TokenType::ID)
+                tokens.Value(j).nameId = Identifiers.Intern(tokens.Text(j));
+        rows += lines[i];
+    }
+    batchSize = tokens.Size();
+}
+
+Token Tokenizer::batchToken(uint32_t i)
+{
+    if (i < batchSize)
+        return Token(i);
+    if (deferredError)
+        std::rethrow_exception(deferredError);
+    return Token(batchSize - 1);
+}
+
+Token Tokenizer::Next()
 {
-    currentlyProcessingTokenPos = currentPos;
     currentToken = nextToken;
+    nextToken = batched ? batchToken(nextToken.Index() + 1) : lex();
+    return currentToken;
+}
+
+Token Tokenizer::lex()
+{
+    if (inputMode == InputMode::BUFFER)
+        return scanBuffer();
+    currentlyProcessingTokenPos = currentPos;
     while (currentFile.get(currentCharacter))
     {
         if (currentCharacter == '\n')
@@ -44,28 +334,20 @@ std::shared_ptr<Token> Tokenizer::Next()
         if (!currentState) currentlyProcessingTokenPos = currentPos;
         currentPos.col++;
         buffer.push_back(currentCharacter);
-        if (processNewState(FiniteAutomata[currentState][currentCharacter]))
-        {
-            nextToken = getToken();
-            return currentToken;
-        }
+        if (processNewState(FiniteAutomata(currentState, currentCharacter)))
+            return getToken();
     }
     if (currentState != 0)
-    {
-        nextToken = getToken();
-        return currentToken;
-    }
-    nextToken = std::make_shared<Token>(TokenType::END_OF_FILE, currentPos.row, currentPos.col, "");
-    return currentToken;
+        return getToken();
+    return Token(tokens.Add(TokenType::END_OF_FILE, currentPos, std::string()));
 }
 
-std::shared_ptr<Token> Tokenizer::Current()
+Token Tokenizer::Current()
 {
-    auto debugging = currentToken.get();
     return currentToken;
 }
 
-std::shared_ptr<Token> Tokenizer::getToken()
+Token Tokenizer::getToken()
 {
 
     auto res = AcceptStates.find(currentState);
@@ -81,49 +363,167 @@ std::shared_ptr<Token> Tokenizer::getToken()
             currentPos.row--;
         }
         currentState = 0;
-        auto t = std::make_shared<Token>(res->second, currentlyProcessingTokenPos.row, currentlyProcessingTokenPos.col, buffer);
-        try
-        {
-
-            if (t->type == TokenType::ID && Keywords.find(t->text) != Keywords.end())
-            {
-                t->type = TokenType::KEYWORD;
-                t->keyword = StringToKeyword[buffer];
-            }
-            else if (t->type == TokenType::NUM_INT)
-            {
-                if (buffer.length() >= 2 && (buffer[1] == 'x' || buffer[1] == 'X'))
-                    t->intValue = std::stoull(buffer, nullptr, 16);
-                else if (buffer[0] == '0')
-                    t->intValue = std::stoull(buffer, nullptr, 8);
-                else
-                    t->intValue = std::stoull(buffer, nullptr, 10);
-            }
-            else if (t->type == TokenType::CHARACTER)
-                t->intValue = (uint64_t)toChar();
-            else if (t->type == TokenType::NUM_FLOAT)
-            {
-                t->floatValue = std::stold(buffer);
-            }
+        auto i = tokens.Add(res->second, currentlyProcessingTokenPos, buffer);
+        setTokenValue(i, res->second, buffer);
+        buffer.resize(0);
+        currentlyProcessingTokenPos = currentPos;
+        return Token(i);
+    }
+}
+void Tokenizer::setTokenValue(uint32_t i, TokenType type, std::string_view text)
+{
+    auto &value = tokens.Value(i);
+    auto status = LiteralStatus::OK;
+    if (type == TokenType::ID && LookupKeyword(text, value.keyword))
+        tokens.SetType(i, TokenType::KEYWORD);
+    else if (type == TokenType::ID && internIdentifiers)
+        value.nameId = Identifiers.Intern(text);
+    else if (type == TokenType::NUM_INT)
+    {
+        uint64_t number;
+        status = DecodeIntLiteral(text, number);
+        value.intValue = number;
+    }
+    else if (type == TokenType::CHARACTER)
+        value.intValue = (uint64_t)toChar(text);
+    else if (type == TokenType::NUM_FLOAT)
+        status = DecodeFloatLiteral(text, value.floatValue);
+    if (status == LiteralStatus::OUT_OF_RANGE)
+        throw NumberOutOfRange(currentlyProcessingTokenPos.row, currentlyProcessingTokenPos.col, std::string(text));
+    if (status == LiteralStatus::MALFORMED)
+        throw WrongNumberLiteral(currentlyProcessingTokenPos.row, currentlyProcessingTokenPos.col, std::string(text));
+}
 
-            else
-            {
-                t->stringValue = toString();
-            }
+// Buffer mode counterpart of the Next loop: whitespace and comments are skipped in place and a token body
+// is consumed by RunFiniteAutomata in one go, no characters are copied. Tokens never span lines,
+// so only whitespace and comments have to track rows.
+Token Tokenizer::scanBuffer()
+{
+    while (true)
+    {
+        const char *start = cursor;
+        LineFeeds lines;
+        cursor = SkipWhitespace(cursor, sourceEnd, lines);
+        advancePos(start, lines);
+        if (trackLines && lines.count)
+            recordLines(start, 0);
+        if (cursor == sourceEnd)
+            return Token(tokens.Add(TokenType::END_OF_FILE, currentPos, std::string()));
+        currentlyProcessingTokenPos = currentPos;
+        start = cursor;
+        currentState = FiniteAutomata(0, *cursor++);
+        // identifiers and numbers loop in their first state, their bodies do not need the automaton
+        if (currentState == 1)
+            cursor = SkipIdentifier(cursor, sourceEnd);
+        else if (currentState == 4)
+            cursor = SkipDigits(cursor, sourceEnd);
+        if (currentState != -1)
+            currentState = RunFiniteAutomata(currentState, cursor, sourceEnd);
+        currentPos.col += cursor - start;
+        int next = -1;
+        if (currentState != -1 && cursor != sourceEnd)
+            next = FiniteAutomata(currentState, *cursor);
+        if (next == (int)SpecialFAStates::MultilineComment)
+        {
+            cursor++;
+            currentPos.col++;
+            skipMultilineComment();
+            continue;
         }
-        catch (std::out_of_range &e)
+        if (next == (int)SpecialFAStates::Comment)
         {
-            throw NumberOutOfRange(currentlyProcessingTokenPos.row, currentlyProcessingTokenPos.col, buffer);
+            cursor++;
+            currentPos.col++;
+            skipComment();
+            continue;
         }
-        catch (std::invalid_argument &e)
+        auto res = AcceptStates.find(currentState);
+        if (res == AcceptStates.end())
         {
-            throw WrongNumberLiteral(currentlyProcessingTokenPos.row, currentlyProcessingTokenPos.col, buffer);
+            // an unknown symbol is reported along with the character following it
+            if (cursor != sourceEnd)
+            {
+                if (*cursor++ == '\n')
+                {
+                    currentPos.row++;
+                    currentPos.col = 0;
+                }
+                currentPos.col++;
+            }
+            buffer.assign(start, cursor);
+            error(currentState);
         }
-        buffer.resize(0);
-        currentlyProcessingTokenPos = currentPos;
-        return t;
+        currentState = 0;
+        auto length = (uint32_t)(cursor - start);
+        auto i = tokens.Add(res->second, currentlyProcessingTokenPos, (uint32_t)(start - sourceBegin), length);
+        setTokenValue(i, res->second, std::string_view(start, length));
+        // the stream loop steps back over the character ending a token even if that was the end of file
+        if (cursor == sourceEnd)
+            currentPos.col--;
+        return Token(i);
     }
 }
+
+// moves currentPos over [from, cursor), lines are the line feeds met in between
+void Tokenizer::advancePos(const char *from, const LineFeeds &lines)
+{
+    if (lines.count)
+    {
+        currentPos.row += lines.count;
+        currentPos.col = (int)(cursor - lines.lineStart) + 1;
+    }
+    else
+        currentPos.col += cursor - from;
+}
+
+// records the lines starting in [from, cursor)
+void Tokenizer::recordLines(const char *from, int nesting)
+{
+    int state = nesting ? (int)SpecialFAStates::MultilineComment : 0;
+    for (const char *p = FindLineFeed(from, cursor); p != cursor; p = FindLineFeed(p + 1, cursor))
+        lineStates.push_back({(uint32_t)(p + 1 - sourceBegin), tokens.Size(), state, nesting});
+}
+
+void Tokenizer::skipMultilineComment(int nesting)
+{
+    char prev = 0;
+    while (nesting && cursor != sourceEnd)
+    {
+        const char *start = cursor;
+        LineFeeds lines;
+        cursor = FindCommentMark(cursor, sourceEnd, lines);
+        advancePos(start, lines);
+        if (trackLines && lines.count)
+            recordLines(start, nesting);
+        if (cursor != start)
+            prev = cursor[-1];
+        if (cursor == sourceEnd)
+            break;
+        char c = *cursor++;
+        currentPos.col++;
+        if (prev == '/' && c == '*')
+            nesting++;
+        if (prev == '*' && c == '/')
+            nesting--;
+        prev = c;
+    }
+    unterminatedComment = nesting != 0;
+    currentState = 0;
+}
+
+void Tokenizer::skipComment()
+{
+    cursor = FindLineFeed(cursor, sourceEnd);
+    if (cursor != sourceEnd)
+    {
+        cursor++;
+        if (trackLines)
+            recordLines(cursor - 1, 0);
+    }
+    currentPos.row++, currentPos.col = 1;
+    currentState = 0;
+}
+
 bool Tokenizer::processNewState(int newState)
 {
 
@@ -168,6 +568,7 @@ void Tokenizer::parseMultilineComment()
         if (buffer[0] == '*' && buffer[1] == '/')
             nesting--;
     }
+    this->buffer.resize(0);
     currentState = 0;
 }
 
@@ -184,78 +585,57 @@ void Tokenizer::error(int state)
 {
     switch (state)
     {
-        case 5:case 10:case 70:case 11:case 68:
+        case 5:case 7:case 8:case 10:case 70:case 11:case 68:
             throw WrongNumberLiteral(currentPos.row, currentPos.col, buffer);
         case 59:case 58:case 60:
             throw WrongStringLiteral(currentPos.row, currentPos.col, buffer);
         case -1:
             throw UnknownSymbol(currentPos.row, currentPos.col, buffer);
-        case 63:case 65:case 62:
+        case 63:case 64:case 65:case 62:
             throw WrongCharacterLiteral(currentPos.row, currentPos.col, buffer);
     }
 }
 
-char Tokenizer::toChar()
+char Tokenizer::toChar(std::string_view text)
 {
-    if (buffer.length() == 3)
-        return buffer[1];
+    if (text.length() == 3)
+        return text[1];
+    char c = 0;
+    DecodeEscape(text[3], c);
+    return c;
+}
 
-    toEscape(buffer[3]);
+Token Tokenizer::Peek()
+{
+    return nextToken;
 }
 
-char *Tokenizer::toString()
+void Tokenizer::Follow(Tokenizer &other)
 {
-    char *res = new char[buffer.length() + 1];
-    int i = 0;
-    bool isEscape = false;
-    for (char j : buffer)
-    {
-        if (j == '"' && !isEscape)
-            continue;
-        if (j == '\\' && !isEscape)
-        {
-            isEscape = true;
-            continue;
-        }
-        res[i++] = isEscape ? toEscape(j) : j;
-        if (isEscape) isEscape = false;
-    }
-    res[i++] = '\0';
-    return res;
+    other.tokens.Activate();
+    batchSize = other.batchSize;
+    deferredError = other.deferredError;
+    currentToken = Token();
+    nextToken = Token(0);
+    batched = true;
 }
 
-char Tokenizer::toEscape(char c)
+void Tokenizer::Seek(Token token)
 {
-    switch (c)
-    {
-        case 'n':
-            return '\n';
-        case 'a':
-            return '\a';
-        case 't':
-            return '\t';
-        case 'v':
-            return '\v';
-        case '?':
-            return '\?';
-        case '\\':
-            return '\\';
-        case '\'':
-            return '\'';
-        case 'b':
-            return '\b';
-        case 'f':
-            return '\f';
-        case '0':
-            return '\0';
-        case '\"':
-            return '\"';
-    }
+    currentToken = token;
+    nextToken = batchToken(token.Index() + 1);
 }
 
-std::shared_ptr<Token> Tokenizer::Peek()
+Token Tokenizer::LookAhead(uint32_t distance)
 {
-    return nextToken;
+    if (!distance)
+        return currentToken;
+    if (distance == 1)
+        return nextToken;
+    if (!batched)
+        throw std::logic_error("LookAhead(" + std::to_string(distance) + ") needs the tokens of Tokenize, "
+                               "a streaming tokenizer only keeps the next one");
+    return batchToken(nextToken.Index() + distance - 1);
 }
 
 
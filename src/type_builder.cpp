@@ -2,6 +2,7 @@
 #include "../includes/type_builder.h"
 #include "../includes/nodes/struct.h"
 #include "../includes/symbol_table.h"
+#include "../includes/symbols/type_context.h"
 
 SymType *TypeBuilder::Build(DeclarationSpecifiersNode *declarationSpecifiers, bool &isTypedef)
 {
@@ -19,7 +20,7 @@ SymType *TypeBuilder::Build(DeclarationSpecifiersNode *declarationSpecifiers, bo
             auto simple = (SimpleSpecifier *)it;
 
             if (!isTypeQualifier(simple) && (kind == TypeClass::STRUCT)) throw ManyDataTypesError(simple->Value());
-            if (simple->Value()->keyword == Keyword::VOID)
+            if (simple->Value().GetKeyword() == Keyword::VOID)
             {
                 if (kind != TypeClass::NONE) throw ManyDataTypesError(simple->Value());
                 kind = TypeClass::VOID;
@@ -31,7 +32,7 @@ SymType *TypeBuilder::Build(DeclarationSpecifiersNode *declarationSpecifiers, bo
             if (!isTypeQualifier(simple) && (kind != TypeClass::SCALAR && kind != TypeClass::NONE))
                 throw ManyDataTypesError(simple->Value());
 
-            switch (simple->Value()->keyword)
+            switch (simple->Value().GetKeyword())
             {
                 case Keyword::LONG:
                     ++longTimes;
@@ -120,44 +121,44 @@ SymType *TypeBuilder::Build(DeclarationSpecifiersNode *declarationSpecifiers, bo
                     switch (isSinged)
                     {
                         case Singed::SINGED:
-                            if (longTimes) return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT64), typeQuals);
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT32), typeQuals);
+                            if (longTimes) return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT64), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT32), typeQuals);
                         case Singed::UNSIGNED:
-                            if (longTimes) return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::UINT64), typeQuals);
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::UINT32), typeQuals);
+                            if (longTimes) return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::UINT64), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::UINT32), typeQuals);
                     }
                 case ScalaraKind::DOUBLE:
-                    return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::DOUBLE), typeQuals);
+                    return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::DOUBLE), typeQuals);
                 case ScalaraKind::FLOAT:
-                    return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::FLOAT), typeQuals);
+                    return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::FLOAT), typeQuals);
                 case ScalaraKind::CHAR:
                     switch (isSinged)
                     {
                         case Singed::SINGED:
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT8), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT8), typeQuals);
                         case Singed::UNSIGNED:
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::UINT8), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::UINT8), typeQuals);
                     }
                 case ScalaraKind::UNKNOWN:
                     switch (isSinged)
                     {
                         case Singed::SINGED:
-                            if (longTimes) return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT64), typeQuals);
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT32), typeQuals);
+                            if (longTimes) return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT64), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT32), typeQuals);
                         case Singed::UNSIGNED:
-                            if (longTimes) return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::UINT64), typeQuals);
-                            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::UINT32), typeQuals);
+                            if (longTimes) return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::UINT64), typeQuals);
+                            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::UINT32), typeQuals);
                     }
             }
         case TypeClass::VOID:
-            return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::VOID), typeQuals);
+            return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::VOID), typeQuals);
         case TypeClass::STRUCT:
         case TypeClass::TYPEDEF:
-            if (typeQuals) return new SymQualifiedType(type, typeQuals);
+            if (typeQuals) return Types.Qualified(type, typeQuals);
             return type;
         case TypeClass::ENUM:
-            if (typeQuals) return new SymQualifiedType(new SymBuiltInType(BuiltInTypeKind::INT32), typeQuals);
-            return new SymBuiltInType(BuiltInTypeKind::INT32);
+            if (typeQuals) return Types.Qualified(Types.BuiltIn(BuiltInTypeKind::INT32), typeQuals);
+            return Types.BuiltIn(BuiltInTypeKind::INT32);
     }
     throw ""; // Unreachable
 }
@@ -170,8 +171,8 @@ SymRecord *TypeBuilder::Build(StructDeclarationListNode *structDeclarationList,
     {
         for (auto declarator: declarationList->List())
         {
-            std::string name = declarator->GetId() ? declarator->GetId()->GetName() :
-                               "#" + std::to_string(orderedFields.size());
+            NameId name = declarator->GetId() ? declarator->GetId()->GetNameId() :
+                          Identifiers.Intern("#" + std::to_string(orderedFields.size()));
             if (fields->Find(name)) throw "";
             auto dt = declarator->GetType()->GetUnqualified();
             if (!dt->IsComplete()) throw FieldOfIncompleteTypeError(declarator);
@@ -185,7 +186,7 @@ SymRecord *TypeBuilder::Build(StructDeclarationListNode *structDeclarationList,
 
 bool TypeBuilder::isTypeQualifier(SimpleSpecifier *simpleSpecifier)
 {
-    auto k = simpleSpecifier->Value()->keyword;
+    auto k = simpleSpecifier->Value().GetKeyword();
     return k == Keyword::CONST || k == Keyword::VOLATILE || k == Keyword::REGISTER;
 }
 
@@ -200,7 +201,7 @@ uint32_t TypeBuilder::BuildTypeQualifiers(DeclarationSpecifiersNode *declaration
     uint32_t res = 0;
     for (auto it: declarationSpecifiers->List())
     {
-        switch (dynamic_cast<SimpleSpecifier *>(it)->Value()->keyword)
+        switch (static_cast<SimpleSpecifier *>(it)->Value().GetKeyword())
         {
             case Keyword::CONST:
                 res |= (uint32_t)TypeQualifier::CONST;
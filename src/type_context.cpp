@@ -0,0 +1,35 @@
+#include "symbols/type_context.h"
+
+TypeContext Types;
+
+TypeContext::TypeContext()
+{
+    for (size_t i = 0; i < BuiltInCount; i++)
+        builtIns[i] = make<SymBuiltInType>((BuiltInTypeKind)i);
+}
+
+SymPointer *TypeContext::Pointer(SymType *target)
+{
+    if (!target->IsCanonical())
+        return new SymPointer(target);
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (shared)
+        lock.lock();
+    auto &pointer = pointers[target];
+    if (!pointer)
+        pointer = make<SymPointer>(target);
+    return pointer;
+}
+
+SymQualifiedType *TypeContext::Qualified(SymType *type, uint32_t qualifiers)
+{
+    if (!type->IsCanonical())
+        return new SymQualifiedType(type, qualifiers);
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (shared)
+        lock.lock();
+    auto &result = qualified[QualifiedKey{type, qualifiers}];
+    if (!result)
+        result = make<SymQualifiedType>(type, qualifiers);
+    return result;
+}
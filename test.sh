@@ -29,6 +29,30 @@ do
 done
 rm tests/tokenizer/temp.txt
 echo "Tokenizer: passed $ti/$tj"
+bi=0
+bj=0
+for file in $(ls tests/tokenizer/ --ignore=*.res | sort -n)
+do
+	bj=$(($bj + 1))
+	prefix=$( echo "$file" | sed -e "s/\.cpp//g" )
+	./$tccpath -t --binary-tokens tests/tokenizer/$file 2> tests/tokenizer/temp.err | python3 tests/binary_tokens.py > tests/tokenizer/temp.txt
+	status="${PIPESTATUS[0]} ${PIPESTATUS[1]}"
+	# a lexical error cuts the dump short and goes to stderr, where the text dump has it last
+	cat tests/tokenizer/temp.err >> tests/tokenizer/temp.txt
+	if { [ "$status" = "1 1" ] && [ -s tests/tokenizer/temp.err ]; } || { [ "$status" = "0 0" ] && [ ! -s tests/tokenizer/temp.err ]; }; then
+		cmp -s "tests/tokenizer/$prefix.res" "tests/tokenizer/temp.txt"
+	else
+		false
+	fi
+	if [ $? -ne 0 ]; then
+		echo "$file binary test failed"
+	else
+		echo "$file binary test succed"
+		bi=$(($bi + 1))
+	fi
+done
+rm tests/tokenizer/temp.txt tests/tokenizer/temp.err
+echo "Binary tokens: passed $bi/$bj"
 pi=0
 pj=0
 for file in $(ls tests/parser/ --ignore=*.res | sort -n)
@@ -46,6 +70,71 @@ do
 done
 rm tests/parser/temp.txt
 echo "Parser: passed $pi/$pj"
+li=0
+lj=0
+for file in $(ls tests/lazy/ --ignore=*.res | sort -n)
+do
+	lj=$(($lj + 1))
+	prefix=$( echo "$file" | sed -e "s/\.cpp//g" )
+	eval "./$tccpath --lazy-bodies tests/lazy/$file > tests/lazy/temp.txt"
+	cmp -s "tests/lazy/$prefix.res" "tests/lazy/temp.txt"
+	if [ $? -eq 1 ]; then
+		echo "lazy\\$file test failed"
+	else
+		echo "lazy\\$file test succed"
+		li=$(($li + 1))
+	fi
+done
+rm tests/lazy/temp.txt
+echo "Lazy bodies: passed $li/$lj"
+thi=0
+thj=0
+for file in $(ls tests/parser/ --ignore=*.res | sort -n)
+do
+	thj=$(($thj + 1))
+	prefix=$( echo "$file" | sed -e "s/\.cpp//g" )
+	eval "./$tccpath -p --parse-threads 2 tests/parser/$file > tests/parser/temp.txt"
+	cmp -s "tests/parser/$prefix.res" "tests/parser/temp.txt"
+	if [ $? -eq 1 ]; then
+		echo "$file test failed with threads"
+	else
+		echo "$file test succed with threads"
+		thi=$(($thi + 1))
+	fi
+done
+rm tests/parser/temp.txt
+for file in $(ls tests/lazy/ --ignore=*.res | sort -n)
+do
+	thj=$(($thj + 1))
+	prefix=$( echo "$file" | sed -e "s/\.cpp//g" )
+	eval "./$tccpath --parse-threads 2 tests/lazy/$file > tests/lazy/temp.txt"
+	cmp -s "tests/lazy/$prefix.res" "tests/lazy/temp.txt"
+	if [ $? -eq 1 ]; then
+		echo "lazy\\$file test failed with threads"
+	else
+		echo "lazy\\$file test succed with threads"
+		thi=$(($thi + 1))
+	fi
+done
+rm tests/lazy/temp.txt
+echo "Parser threads: passed $thi/$thj"
+yi=0
+yj=0
+for file in $(ls tests/layout/ --ignore=*.res | sort -n)
+do
+	yj=$(($yj + 1))
+	prefix=$( echo "$file" | sed -e "s/\.cpp//g" )
+	eval "./$tccpath -p --dump-layout tests/layout/$file 2> tests/layout/temp.txt > /dev/null"
+	cmp -s "tests/layout/$prefix.res" "tests/layout/temp.txt"
+	if [ $? -eq 1 ]; then
+		echo "layout\\$file test failed"
+	else
+		echo "layout\\$file test succed"
+		yi=$(($yi + 1))
+	fi
+done
+rm tests/layout/temp.txt
+echo "Layout: passed $yi/$yj"
 ci=0
 cj=0
 for folder in "expr" "stmt";
@@ -72,7 +161,7 @@ do
 done
 
 echo "Generator: passed $ci/$cj"
-echo "Total:  passed $(($pi+$ti+$ci))/$(($tj+$pj+$cj))"
+echo "Total:  passed $(($pi+$ti+$bi+$li+$thi+$yi+$ci))/$(($tj+$bj+$pj+$lj+$thj+$yj+$cj))"
 
 
 
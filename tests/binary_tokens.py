@@ -0,0 +1,56 @@
+# Reads a --binary-tokens dump from stdin and prints it the way -t does, so that the binary format
+# can be checked against the tokenizer tests. The record layout is described in includes/token_writer.h.
+# A dump of a file that failed to lex has no END_OF_FILE record, the tokens before the error are printed
+# and the exit status is 1. A dump that is not well formed exits with 2.
+import os
+import re
+import struct
+import sys
+
+here = os.path.dirname(os.path.abspath(__file__))
+header = open(os.path.join(here, '..', 'includes', 'token.h'), 'r').read()
+names = re.search(r'TokenTypeNames\[\] =\s*\{(.*?)\};', header, re.S).group(1)
+names = re.findall(r'"([^"]*)"', names)
+NUM_INT, NUM_FLOAT = names.index('NUM_INT'), names.index('NUM_FLOAT')
+KEYWORD, CHARACTER = names.index('KEYWORD'), names.index('CHARACTER')
+END_OF_FILE = len(names) - 1
+
+def fail(message):
+	sys.stderr.write(message + '\n')
+	sys.exit(2)
+
+def take(fmt):
+	global p
+	if p + struct.calcsize(fmt) > len(data):
+		fail('the dump ends inside a record at byte %d' % p)
+	values = struct.unpack_from(fmt, data, p)
+	p += struct.calcsize(fmt)
+	return values
+
+data = sys.stdin.buffer.read()
+if len(data) < 8 or data[:4] != b'TCCT' or struct.unpack_from('<I', data, 4)[0] != 1:
+	fail('not a binary token dump of version 1')
+out = [b'Position\t\tType\t\t\tValue\t\t\tText\n\n']
+p = 8
+complete = False
+while p < len(data):
+	kind, row, col, length = take('<BIII')
+	if kind > END_OF_FILE:
+		fail('unknown token type %d at byte %d' % (kind, p - 13))
+	text = take('%ds' % length)[0]
+	if kind == NUM_INT or kind == CHARACTER:
+		value = b'%d' % (take('<q')[0] & 0xFFFFFFFFFFFFFFFF)
+	elif kind == NUM_FLOAT:
+		value = b'%f' % take('<d')[0]
+	elif kind == KEYWORD:
+		value = b'%d' % take('B')[0]
+	else:
+		value = text
+	if kind == END_OF_FILE:
+		complete = True
+		break
+	out.append(b'(%d, %d)\t\t\t%s\t\t\t%s\t\t\t\t  %s\n' % (row, col, names[kind].encode(), value, text))
+if p != len(data):
+	fail('records after END_OF_FILE')
+sys.stdout.buffer.write(b''.join(out))
+sys.exit(0 if complete else 1)
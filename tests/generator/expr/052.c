@@ -0,0 +1,10 @@
+
+int main(void)
+{
+    printf("%d %d\n", (unsigned int)-1 + (unsigned int)2, (unsigned int)0 - (unsigned int)1);
+    printf("%d\n", (unsigned int)65536 * (unsigned int)65536 + (unsigned int)7);
+    printf("%d %d\n", (unsigned int)-1 / (unsigned int)2, (unsigned int)-1 % (unsigned int)7);
+    printf("%d %d\n", (unsigned int)0 - (unsigned int)1 > (unsigned int)0, -1 < (unsigned int)0);
+    printf("%d %d\n", 2147483647 + 1, -2147483647 - 1 - 1);
+    printf("%d %d\n", (unsigned char)250 + (unsigned char)10, (char)100 + (char)100);
+}
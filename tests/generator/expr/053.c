@@ -0,0 +1,9 @@
+
+int main(void)
+{
+    printf("%d %d %d\n", 1 << 30, 1 << 4 >> 2, -16 >> 2);
+    printf("%d %d\n", (unsigned int)-1 >> 28, (unsigned int)1 << 31 >> 31);
+    printf("%d %d\n", 1 << 31 >> 31, (3 << 2) | 1);
+    printf("%d %d\n", 255 >> 4 & 3, ~0 << 8);
+    printf("%d %d\n", (char)1 << 10, (char)-128 >> 4);
+}
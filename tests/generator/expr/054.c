@@ -0,0 +1,9 @@
+
+int main(void)
+{
+    printf("%d %d %d %d\n", 7 / 2, -7 / 2, 7 / -2, -7 / -2);
+    printf("%d %d %d %d\n", 7 % 3, -7 % 3, 7 % -3, -7 % -3);
+    printf("%d %d\n", (unsigned int)-1 / (unsigned int)10, (unsigned int)-1 % (unsigned int)10);
+    printf("%d %d\n", (unsigned int)-7 / (unsigned int)2, -7 / (unsigned int)2);
+    printf("%f %f\n", 7.0 / 2, 1 / 4.0);
+}
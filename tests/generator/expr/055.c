@@ -0,0 +1,10 @@
+
+int main(void)
+{
+    printf("%d %d %d\n", (char)300, (char)-129, (unsigned char)-1);
+    printf("%d %d %d\n", (int)3.9, (int)-3.9, (int)(2.5 * 2));
+    printf("%f %f\n", (float)7 / 2, (float)(1 << 20));
+    printf("%d %d\n", (unsigned int)(char)200, (unsigned char)(char)-56);
+    printf("%d %d\n", -(char)-128, ~(unsigned char)0);
+    printf("%f\n", (float)(unsigned int)-1);
+}
@@ -0,0 +1,18 @@
+
+struct S
+{
+    char c;
+    int i;
+    char d;
+};
+
+int main(void)
+{
+    int a[10];
+    char *p;
+    printf("%d %d %d\n", sizeof(char), sizeof(int), sizeof(double));
+    printf("%d %d %d\n", sizeof(struct S), sizeof a, sizeof a / sizeof a[0]);
+    printf("%d %d %d\n", sizeof(int *), sizeof p, sizeof *p);
+    printf("%d %d\n", sizeof(char) + 1, sizeof(struct S) * 2 - 1);
+    printf("%d\n", sizeof(int) - sizeof(double) > 0);
+}
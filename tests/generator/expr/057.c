@@ -0,0 +1,12 @@
+
+int main(void)
+{
+    int a = (1, 2, 3);
+    int b = 1 ? 10 : 20;
+    int c = 0 ? 10 : 2 + 3;
+    printf("%d %d %d\n", a, b, c);
+    printf("%d %d\n", 5 > 3 ? 5 - 3 : 3 - 5, (0, 1) ? (2, 7) : 8);
+    printf("%f %f\n", 1 ? 1 : 2.5, 0 ? 1 : 2.5);
+    printf("%d %d\n", 1 && 0 || 2, !5 + !0);
+    printf("%d\n", (1 ? (char)300 : 0) + (0 ? 1 : -1));
+}
@@ -0,0 +1,43 @@
+struct S
+{
+    int a;
+    char c;
+    int b;
+};
+
+struct S id(struct S s)
+{
+    return s;
+}
+
+struct S mk(int a, int b)
+{
+    struct S r;
+    r.a = a;
+    r.c = 7;
+    r.b = b;
+    return r;
+}
+
+int sum(int x, struct S s, int y)
+{
+    return x + s.a + s.c + s.b + y;
+}
+
+int main(void)
+{
+    struct S s, t, u;
+    s.a = 5;
+    s.c = 11;
+    s.b = -2;
+    t = id(s);
+    printf("%d %d %d\n", t.a, t.c, t.b);
+    u = mk(3, 4);
+    printf("%d %d %d\n", u.a, u.c, u.b);
+    t = id(mk(100, 200));
+    printf("%d %d %d\n", t.a, t.c, t.b);
+    printf("%d\n", sum(1000, u, 20000));
+    mk(1, 2);
+    printf("%d\n", sum(1, id(s), 2));
+    return 0;
+}
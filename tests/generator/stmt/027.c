@@ -0,0 +1,44 @@
+
+struct Inner
+{
+    char tag;
+    int value;
+};
+
+struct Outer
+{
+    char a;
+    struct Inner inner;
+    char buf[100];
+    double d;
+    char last;
+};
+
+struct Pair
+{
+    int x;
+    char c;
+};
+
+int main(void)
+{
+    struct Outer outer;
+    struct Pair pairs[4];
+    char *base = (char *)&outer;
+    char *first = (char *)&pairs[0];
+    int i;
+    printf("%d %d %d\n", sizeof(struct Inner), sizeof(struct Outer), sizeof(struct Pair));
+    printf("%d %d\n", sizeof pairs, sizeof outer.buf);
+    printf("%d %d %d\n", (char *)&outer.inner - base, (char *)&outer.inner.value - base, outer.buf - base);
+    printf("%d %d\n", (char *)&outer.d - base, (char *)&outer.last - base);
+    printf("%d %d\n", (char *)&pairs[3] - first, (char *)&pairs[2].c - first);
+    for (i = 0; i < 4; i++)
+    {
+        pairs[i].x = i * 10;
+        pairs[i].c = i + 1;
+    }
+    outer.buf[99] = 7;
+    outer.inner.value = 42;
+    outer.last = 3;
+    printf("%d %d %d\n", pairs[1].x + pairs[3].c, outer.buf[99], outer.inner.value + outer.last);
+}
@@ -0,0 +1,56 @@
+struct Inner
+{
+    char tag;
+    int value;
+};
+
+struct Outer
+{
+    char a;
+    struct Inner inner;
+    char buf[100];
+    double d;
+    char last;
+};
+
+struct Pair
+{
+    int x;
+    char c;
+};
+
+struct Table
+{
+    struct Pair pairs[3];
+    char name[5];
+};
+
+struct Bytes
+{
+    char a;
+    char b[3];
+};
+
+struct Forward;
+
+struct Holder
+{
+    struct Forward *next;
+    char c;
+};
+
+struct Forward
+{
+    double d;
+    int i;
+};
+
+int main(void)
+{
+    struct
+    {
+        char c;
+        double d;
+    } anonymous;
+    return 0;
+}
@@ -0,0 +1,34 @@
+(1, 1) struct Inner: size 8, align 4
+    0	tag	size 1, align 1
+    1	<padding>	size 3
+    4	value	size 4, align 4
+(7, 1) struct Outer: size 124, align 4
+    0	a	size 1, align 1
+    1	<padding>	size 3
+    4	inner	size 8, align 4
+    12	buf	size 100, align 1
+    112	d	size 8, align 4
+    120	last	size 1, align 1
+    121	<padding>	size 3
+(16, 1) struct Pair: size 8, align 4
+    0	x	size 4, align 4
+    4	c	size 1, align 1
+    5	<padding>	size 3
+(22, 1) struct Table: size 32, align 4
+    0	pairs	size 24, align 4
+    24	name	size 5, align 1
+    29	<padding>	size 3
+(28, 1) struct Bytes: size 4, align 1
+    0	a	size 1, align 1
+    1	b	size 3, align 1
+(36, 1) struct Holder: size 8, align 4
+    0	next	size 4, align 4
+    4	c	size 1, align 1
+    5	<padding>	size 3
+(42, 1) struct Forward: size 12, align 4
+    0	d	size 8, align 4
+    8	i	size 4, align 4
+(50, 5) struct <anonymous>: size 12, align 4
+    0	c	size 1, align 1
+    1	<padding>	size 3
+    4	d	size 8, align 4
@@ -0,0 +1,8 @@
+struct S;
+int f(void)
+{
+    struct S s;
+    s.a = 1;
+    return s.a;
+}
+struct S {int a;};
@@ -0,0 +1 @@
+(1, 8): invalid use of undefined type: 'struct S'
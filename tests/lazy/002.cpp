@@ -0,0 +1,6 @@
+struct S;
+int f(struct S *p)
+{
+    return p->a;
+}
+struct S {int a;};
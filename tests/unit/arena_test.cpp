@@ -0,0 +1,74 @@
+// Arena::Reset and Release destroy the objects in the arena, newest first, but not one whose constructor threw.
+
+#include "arena.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static std::vector<int> destroyed;
+static int failures = 0;
+
+class Counted: public ArenaObject
+{
+public:
+    explicit Counted(int id, bool fail = false): id(id), name(std::string(64, 'x'))
+    {
+        if (fail)
+            throw std::runtime_error("constructor failed");
+    }
+    ~Counted() override { destroyed.push_back(id); }
+private:
+    int id;
+    // on the heap, it leaks unless the destructor runs
+    std::string name;
+};
+
+static void expect(const std::vector<int> &ids, const char *what)
+{
+    if (destroyed == ids)
+        return;
+    failures++;
+    fprintf(stderr, "arena_test: %s, destroyed", what);
+    for (auto id: destroyed)
+        fprintf(stderr, " %d", id);
+    fprintf(stderr, "\n");
+}
+
+int main()
+{
+    Arena arena;
+    arena.Activate();
+    new Counted(1);
+    new Counted(2);
+    try
+    {
+        new Counted(3, true);
+    }
+    catch (std::runtime_error &)
+    {
+    }
+    new Counted(4);
+    expect({}, "objects destroyed before Reset");
+    arena.Reset();
+    expect({4, 2, 1}, "Reset");
+
+    destroyed.clear();
+    new Counted(5);
+    arena.Reset();
+    expect({5}, "objects of the previous Reset destroyed again");
+
+    destroyed.clear();
+    new Counted(6);
+    arena.Release();
+    expect({6}, "Release");
+    if (arena.Blocks())
+    {
+        failures++;
+        fprintf(stderr, "arena_test: Release kept %zu blocks\n", arena.Blocks());
+    }
+    if (failures)
+        fprintf(stderr, "arena_test: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// Files compiled one after another in one process, with CompilationArena.Reset in between: every file must
+// give the same tree and the same assembly as it does on its own, although its objects reuse the memory
+// of the file before, and nothing global may keep objects of a file that is gone.
+
+#include "parser.h"
+#include "symbols/type_context.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char *const First =
+    "struct A\n"
+    "{\n"
+    "    int x;\n"
+    "    int y;\n"
+    "};\n"
+    "struct A *head;\n"
+    "int sum(struct A *a, const struct A *b)\n"
+    "{\n"
+    "    return a->x + b->y;\n"
+    "}\n";
+
+static const char *const Second =
+    "struct B\n"
+    "{\n"
+    "    char c;\n"
+    "    int n;\n"
+    "    double d;\n"
+    "};\n"
+    "int both(struct B *b, int k)\n"
+    "{\n"
+    "    const struct B *c = b;\n"
+    "    return b->n && k || c->n > 2;\n"
+    "}\n";
+
+// every assembly is kept, like a driver writing them out at the end would, so that none of them
+// takes the place of one before
+static std::vector<std::unique_ptr<Asm::Assembly>> assemblies;
+
+static std::string compile(const char *source)
+{
+    std::ostringstream out;
+    {
+        Tokenizer tokenizer;
+        tokenizer.TokenizeText(source);
+        Parser parser(&tokenizer);
+        assemblies.emplace_back(new Asm::Assembly());
+        parser.FoldConstants(true);
+        parser.Parse();
+        out << parser;
+        parser.Generate(assemblies.back().get());
+        out << *assemblies.back();
+    }
+    CompilationArena.Reset();
+    return out.str();
+}
+
+int main()
+{
+    auto second = compile(Second);
+    // the files only build pointers and qualified types over records, which belong to the file
+    auto types = Types.Size();
+    auto first = compile(First);
+    auto again = compile(Second);
+    int failures = 0;
+    if (again != second)
+    {
+        failures++;
+        fprintf(stderr, "batch_test: the second file changed after the first one\n--- alone\n%s--- after\n%s",
+                second.c_str(), again.c_str());
+    }
+    if (compile(First) != first)
+    {
+        failures++;
+        fprintf(stderr, "batch_test: the first file changed when compiled again\n");
+    }
+    if (Types.Size() != types)
+    {
+        failures++;
+        fprintf(stderr, "batch_test: %zu canonical types made for the records of the files\n", Types.Size() - types);
+    }
+    return failures ? 1 : 0;
+}
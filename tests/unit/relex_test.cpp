@@ -0,0 +1,226 @@
+// Tokenizer::Relex against lexing the edited text from scratch: both must give the same tokens and the same
+// lexical error, and the TokenEdit must tell exactly which tokens changed.
+
+#include "tokenizer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Lexed
+{
+    TokenType type;
+    int row, col;
+    std::string text;
+};
+
+struct Stream
+{
+    std::vector<Lexed> tokens;
+    std::string error;
+};
+
+struct Edit
+{
+    size_t offset, removed;
+    std::string inserted;
+};
+
+// what the parser would see, tokens up to END_OF_FILE or the lexical error that stops them.
+// Tokens are read from the active arena, so the tokenizer must be the last one that lexed.
+static Stream walk(Tokenizer &tokenizer)
+{
+    Stream res;
+    try
+    {
+        for (Token t = tokenizer.Next(); t.GetType() != TokenType::END_OF_FILE; t = tokenizer.Next())
+            res.tokens.push_back({t.GetType(), t.GetPosition().row, t.GetPosition().col, std::string(t.GetText())});
+    }
+    catch (CompilationError &e)
+    {
+        res.error = e.what();
+    }
+    return res;
+}
+
+static bool sameToken(const Lexed &a, const Lexed &b, int rowShift)
+{
+    return a.type == b.type && a.row + rowShift == b.row && a.col == b.col && a.text == b.text;
+}
+
+static int failures = 0;
+
+static void fail(const std::string &text, const Edit &edit, const char *what)
+{
+    failures++;
+    fprintf(stderr, "relex_test: %s\n  text: \"%s\"\n  edit: offset %zu, removed %zu, inserted \"%s\"\n", what,
+            text.c_str(), edit.offset, edit.removed, edit.inserted.c_str());
+}
+
+static Stream lexFully(const std::string &text)
+{
+    Tokenizer tokenizer;
+    try
+    {
+        tokenizer.TokenizeText(text);
+    }
+    catch (CompilationError &e)
+    {
+        // the very first token failed
+        return {{}, e.what()};
+    }
+    return walk(tokenizer);
+}
+
+// relexes text, which tokenizer holds now, with edit and returns the edited text
+static std::string check(Tokenizer &tokenizer, const std::string &text, const Edit &edit)
+{
+    auto edited = text.substr(0, edit.offset) + edit.inserted + text.substr(edit.offset + edit.removed);
+    auto before = lexFully(text);
+    auto expected = lexFully(edited);
+    auto range = tokenizer.Relex(edit.offset, edit.removed, edit.inserted);
+    auto relexed = walk(tokenizer);
+
+    if (relexed.error != expected.error)
+        fail(text, edit, ("error \"" + relexed.error + "\" instead of \"" + expected.error + "\"").c_str());
+    if (relexed.tokens.size() != expected.tokens.size())
+        fail(text, edit, "a different number of tokens");
+    for (size_t i = 0; i < relexed.tokens.size() && i < expected.tokens.size(); i++)
+        if (!sameToken(relexed.tokens[i], expected.tokens[i], 0))
+        {
+            fail(text, edit, ("token " + std::to_string(i) + " differs").c_str());
+            break;
+        }
+    // the range is only told exactly when both streams reach END_OF_FILE
+    if (!before.error.empty() || !expected.error.empty())
+        return edited;
+    auto &oldTokens = before.tokens, &newTokens = expected.tokens;
+    if (range.first > range.oldEnd || range.first > range.newEnd || range.oldEnd > oldTokens.size() + 1 ||
+        range.newEnd > newTokens.size() + 1 || range.oldEnd - range.first + newTokens.size() !=
+                                                range.newEnd - range.first + oldTokens.size())
+    {
+        fail(text, edit, "the edit range does not add up");
+        return edited;
+    }
+    for (uint32_t i = 0; i < range.first && i < oldTokens.size(); i++)
+        if (!sameToken(oldTokens[i], newTokens[i], 0))
+        {
+            fail(text, edit, "a token before the edit range changed");
+            return edited;
+        }
+    // the tokens after the range are the old ones moved, all by the same number of rows
+    int rowShift = 0;
+    bool first = true;
+    for (uint32_t i = range.oldEnd, j = range.newEnd; i < oldTokens.size() && j < newTokens.size(); i++, j++)
+    {
+        if (first)
+            rowShift = newTokens[j].row - oldTokens[i].row, first = false;
+        if (!sameToken(oldTokens[i], newTokens[j], rowShift))
+        {
+            fail(text, edit, "a token after the edit range is not the old one");
+            return edited;
+        }
+    }
+    // and the range is as small as it can be
+    if (range.first < range.oldEnd && range.first < range.newEnd && range.first < oldTokens.size() &&
+        range.first < newTokens.size() && sameToken(oldTokens[range.first], newTokens[range.first], 0))
+        fail(text, edit, "the edit range starts at a token that did not change");
+    return edited;
+}
+
+// Relex has no line states to start from unless TokenizeText made them
+static void checkRefused(Tokenizer &tokenizer, const char *what)
+{
+    try
+    {
+        tokenizer.Relex(0, 0, "x");
+    }
+    catch (std::logic_error &)
+    {
+        return;
+    }
+    failures++;
+    fprintf(stderr, "relex_test: Relex %s did not throw\n", what);
+}
+
+int main()
+{
+    {
+        Tokenizer fresh;
+        checkRefused(fresh, "on a fresh tokenizer");
+        const char *file = "relex_test_source.c";
+        std::ofstream(file) << "int a = 1;\n";
+        Tokenizer batch;
+        batch.Tokenize(file);
+        checkRefused(batch, "after Tokenize");
+        std::remove(file);
+    }
+
+    const std::string code = "int a = 1;\nint b = 2;\nint c = 3;\n";
+    const std::string comment = "int x;\n/* one\n   two\n   three */ int y;\nint z;\n";
+    const std::string nested = "int x;\n/* a /* b\n c */ d\n e */ int y;\nint z;\n";
+    const std::string strings = "char *s = \"hello world\";\nint y = 'q';\nint z;\n";
+    const std::pair<std::string, Edit> cases[] =
+    {
+        {code, {15, 1, "bb"}},
+        {code, {15, 1, ""}},
+        {code, {10, 0, "\n\n"}},
+        {code, {0, 0, "float f;\n"}},
+        {code, {code.size(), 0, "int d;"}},
+        {code, {11, 11, ""}},
+        {code, {7, 0, "/*"}},
+        {code, {7, 0, "/* "}},
+        {code, {8, 3, "1.5;\nint q = 0x1F"}},
+        // inside a comment, nothing changes
+        {comment, {17, 3, "TWO"}},
+        {comment, {17, 0, "\n\n"}},
+        // the comment ends earlier, later or never
+        {comment, {17, 0, "*/"}},
+        {comment, {30, 2, ""}},
+        {comment, {7, 2, ""}},
+        {comment, {comment.size() - 1, 0, "/*"}},
+        // nested comments count their levels
+        {nested, {12, 2, ""}},
+        {nested, {15, 2, ""}},
+        {nested, {15, 0, "/*"}},
+        {nested, {20, 0, "*/"}},
+        // inside string and character literals
+        {strings, {17, 5, "there"}},
+        {strings, {16, 1, "\\n"}},
+        {strings, {16, 0, "\""}},
+        {strings, {11, 1, ""}},
+        {strings, {34, 1, "ab"}},
+        {strings, {10, 0, "/*"}},
+    };
+    for (auto &c: cases)
+    {
+        Tokenizer tokenizer;
+        tokenizer.TokenizeText(c.first);
+        check(tokenizer, c.first, c.second);
+    }
+
+    // edits one after another on the same tokenizer, made of the pieces that change lexing the most
+    const char *pieces[] = {"/*", "*/", "\"", "'", "\n", " ", "x", "1.5", "0x", "+", "=", ";", "int", "\\", "/"};
+    std::mt19937 rng(20171008);
+    std::string text = comment + strings + nested + code;
+    Tokenizer tokenizer;
+    tokenizer.TokenizeText(text);
+    for (int i = 0; i < 3000 && failures < 10; i++)
+    {
+        Edit edit;
+        edit.offset = rng() % (text.size() + 1);
+        edit.removed = std::min<size_t>(rng() % 4, text.size() - edit.offset);
+        for (auto n = rng() % 3; n--;)
+            edit.inserted += pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+        // keep the text from growing or shrinking away
+        if (text.size() > 400)
+            edit.removed = std::min<size_t>(8, text.size() - edit.offset);
+        text = check(tokenizer, text, edit);
+    }
+    if (failures)
+        fprintf(stderr, "relex_test: %d failures\n", failures);
+    return failures ? 1 : 0;
+}